@@ -23,12 +23,18 @@
  * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
  * IN THE ROOT DIRECTORY OF THIS PACKAGE
  */
+#include <ctype.h>
+
 #include "calypsoBoard.h"
 #include "events.h"
+#include "headerScanner.h"
+#include "latency.h"
 static bool requestPending;
 static bool eventPending;
 static size_t lengthResponse;
 void Calypso_Sendbytes(CALYPSO *self, const char *sendCmd);
+void Calypso_SendbytesLength(CALYPSO *self, const char *sendCmd,
+                             uint16_t length);
 bool Calypso_SendRequest(CALYPSO *self, const char *sendCmd);
 void Calypso_HandleEvents(CALYPSO *self);
 static void Calypso_HandleRxLine(CALYPSO *self, char *rxPacket,
@@ -39,22 +45,33 @@ bool Calypso_appendArgumentString(char *pOutString, const char *pInArgument,
                                   char delimeter);
 void Calypso_RxBytes(CALYPSO *self);
 bool Calypso_waitForEvent(CALYPSO *self);
+bool Calypso_pollEvent(CALYPSO *self);
+static bool Calypso_MQTTreadMessage(CALYPSO *self, bool encoded);
+static bool Calypso_sendRequest(CALYPSO *self, const char *sendCmd, bool measure);
 bool Calypso_MQTTCreate(CALYPSO *self);
 bool Calypso_MQTTConnToBroker(CALYPSO *self);
 bool Calypso_MQTTSet(CALYPSO *self);
 bool ATFile_open(CALYPSO *self, const char *fileName, uint32_t options,
-                 uint16_t fileSize, uint32_t *fileID, uint32_t *secureToken);
+                 uint32_t fileSize, uint32_t *fileID, uint32_t *secureToken);
 bool ATFile_close(CALYPSO *self, uint32_t fileID, char *certFileName,
                   char *signature);
-bool ATFile_write(CALYPSO *self, uint32_t fileID, uint16_t offset,
+bool ATFile_write(CALYPSO *self, uint32_t fileID, uint32_t offset,
                   Calypso_DataFormat_t format, bool encodeToBase64,
                   uint16_t bytestoWrite, char *data, uint16_t *writtenBytes);
-bool ATFile_read(CALYPSO *self, uint32_t fileID, uint16_t offset,
+bool ATFile_read(CALYPSO *self, uint32_t fileID, uint32_t offset,
                  Calypso_DataFormat_t format, uint16_t bytesToRead,
                  Calypso_DataFormat_t *pOutFormat, uint16_t *byteRead,
                  char *data);
 bool ATFile_del(CALYPSO *self, const char *fileName, uint32_t secureToken);
 bool ATFile_getInfo(CALYPSO *self, const char *fileName, uint32_t secureToken);
+static uint16_t Calypso_fileWriteCommand(char *command, uint32_t fileID,
+                                         uint32_t offset, const uint8_t *data,
+                                         uint32_t length, bool encodeToBase64,
+                                         uint16_t *commandLength);
+static bool Calypso_fileReaderReadChunk(CALYPSO *self,
+                                        Calypso_FileReader_t *reader,
+                                        uint16_t length, char *chunk,
+                                        uint16_t *decodedLength);
 static Calypso_CNFStatus_t cmdConfirmation;
 static char RxBuffer[CALYPSO_LINE_MAX_SIZE]; /* data buffer for RX */
 char requestBuffer[CALYPSO_LINE_MAX_SIZE];
@@ -63,6 +80,48 @@ static uint16_t rxByteCounter = 0;
 char eventbuffer[CALYPSO_LINE_MAX_SIZE];
 char eventArguments[CALYPSO_LINE_MAX_SIZE];
 char *pEventBuffer;
+
+/* Streaming reception of MQTT payloads that do not fit into RxBuffer */
+#define MQTT_RECV_EVENT "+eventmqtt:recv,"
+#define MQTT_RECV_HEADER_DELIMITERS 7 /* recv,topic,qos,retain,duplicate,format,length, */
+static HeaderScanner_t recvHeader;
+static uint32_t streamRemaining = 0;
+static uint32_t streamOffset = 0;
+static Calypso_DataFormat_t streamFormat;
+static Calypso_Base64Decoder_t streamDecoder;
+static uint8_t streamBuffer[CALYPSO_STREAM_CHUNK_SIZE];
+static uint16_t streamBufferLength = 0;
+static bool streamEndsWait = false; /* a complete stream ends Calypso_MQTTgetMessage only */
+static void Calypso_checkStreamHeader(CALYPSO *self);
+static void Calypso_streamByte(CALYPSO *self, uint8_t byte);
+
+/* Directory of the Calypso file system, filled by Calypso_fileList and kept
+ * up to date by the write and delete calls of this library */
+#define FILE_LIST_RESPONSE "+filegetfilelist:"
+#define FILE_CACHE_SIZE_UNKNOWN UINT32_MAX
+typedef struct
+{
+    uint32_t nameHash;
+    uint32_t maxSize;
+    uint32_t size; /* written by this library, FILE_CACHE_SIZE_UNKNOWN otherwise */
+    uint16_t allocatedBlocks;
+    uint16_t properties;
+    char name[CALYPSO_FILE_CACHE_NAME_LENGTH]; /* longer names are cut */
+} Calypso_FileCacheEntry_t;
+static Calypso_FileCacheEntry_t fileCache[CALYPSO_FILE_CACHE_ENTRIES];
+static uint8_t fileCacheCount = 0;
+static bool fileCacheValid = false;
+static bool fileListPending = false;
+static uint32_t Calypso_fileCacheHash(const char *fileName);
+static const char *Calypso_fileCacheName(const char *fileName);
+static Calypso_FileCacheEntry_t *Calypso_fileCacheFind(const char *fileName);
+static void Calypso_fileCacheUpdate(const char *fileName, uint32_t maxSize);
+static void Calypso_fileCacheSetSize(const char *fileName, uint32_t size);
+static void Calypso_fileCacheRemove(const char *fileName);
+static void Calypso_fileCacheParseLine(char *line);
+static bool Calypso_readOpenedFile(CALYPSO *self, Calypso_FileReader_t *reader,
+                                   char *data, uint16_t dataLength,
+                                   uint16_t *outputLength);
 /**
  * @brief  Allocate memory and initialize the calypso object
  * @param  serialDebug Pointer to the serial debug
@@ -79,6 +138,9 @@ CALYPSO *Calypso_Create(TypeSerial *serialDebug,
     allocateInit->serialCalypso = serialCalypso;
     allocateInit->bufferCalypso.length = 0;
     allocateInit->status = calypso_unknown;
+    allocateInit->sessionPresent = false;
+    allocateInit->streamSink = NULL;
+    allocateInit->streamContext = NULL;
     memset(allocateInit->bufferCalypso.data, '\0',
            sizeof(allocateInit->bufferCalypso.data));
     allocateInit->settings.wifiSettings = settings->wifiSettings;
@@ -477,6 +539,27 @@ bool Calypso_MQTTconnect(CALYPSO *self)
     }
     return false;
 }
+/**
+ * @brief  Reconnect the existing MQTT client to the broker.
+ *         The client created by Calypso_MQTTconnect is reused, so only
+ *         AT+mqttConnect is sent.
+ * @param  self Pointer to the calypso object.
+ * @retval true if successful false in case of failure
+ */
+bool Calypso_MQTTReconnect(CALYPSO *self)
+{
+    self->status = calypso_MQTT_disconnected;
+    if (Calypso_MQTTConnToBroker(self))
+    {
+        return true;
+    }
+    /* The connack event may arrive after the OK of the connect request */
+    if (Calypso_waitForEvent(self))
+    {
+        return (self->status == calypso_MQTT_connected);
+    }
+    return false;
+}
 /**
  *Sends the AT+MQTTsubscribe=[index],[numOfTopics],[topic1],[QoSn],[reserved]... command
  *
@@ -516,10 +599,47 @@ bool Calypso_subscribe(CALYPSO *self, uint8_t index, uint8_t numOfTopics, ATMQTT
  */
 bool Calypso_MQTTgetMessage(CALYPSO *self, bool encoded)
 {
-    if (!Calypso_waitForServerResponse(self))
+    bool received;
+
+    /*Streams completed while waiting for another event went to the sink
+    without ending that wait*/
+    streamEndsWait = true;
+    received = Calypso_waitForServerResponse(self);
+    streamEndsWait = false;
+    if (!received)
+    {
+        return false;
+    }
+    return Calypso_MQTTreadMessage(self, encoded);
+}
+/**
+ * @brief  Take an MQTT message that has arrived without waiting for one.
+ *         A line that has started is still received completely.
+ * @param  self Pointer to the calypso object.
+ * @param  encoded Payload is base64 encoded
+ * @retval true if a message was received, false otherwise
+ */
+bool Calypso_MQTTpollMessage(CALYPSO *self, bool encoded)
+{
+    bool received;
+
+    streamEndsWait = true;
+    received = Calypso_pollEvent(self);
+    streamEndsWait = false;
+    if (!received)
     {
         return false;
     }
+    return Calypso_MQTTreadMessage(self, encoded);
+}
+/**
+ * @brief  Decode the payload of the MQTT recv event in rxData
+ * @param  self Pointer to the calypso object.
+ * @param  encoded Payload is base64 encoded
+ * @retval true if successful false in case of failure
+ */
+static bool Calypso_MQTTreadMessage(CALYPSO *self, bool encoded)
+{
     if (self->subTopicName.length == 0)
     {
         return false;
@@ -529,17 +649,34 @@ bool Calypso_MQTTgetMessage(CALYPSO *self, bool encoded)
         if (encoded)
         {
             uint32_t elen = 0;
-            char out[CALYPSO_LINE_MAX_SIZE];
-            Calypso_decodeBase64((uint8_t *)self->rxData.data, self->rxData.length, (uint8_t *)out,
-                                 &elen);
-            strcpy(self->rxData.data, out);
+            /*Decoded in place, the payload may be binary and is NUL terminated*/
+            if (!Calypso_decodeBase64((uint8_t *)self->rxData.data, self->rxData.length,
+                                      (uint8_t *)self->rxData.data, &elen))
+            {
+                self->rxData.length = 0;
+                return false;
+            }
             self->rxData.length = (int)elen;
         }
     }
     return true;
 }
 /**
- * @brief  Publish data to the MQTT broker
+ * @brief  Register a consumer for MQTT payloads larger than the line buffer.
+ *         Smaller messages are still delivered through rxData.
+ * @param  self Pointer to the calypso object.
+ * @param  sink Callback receiving the decoded payload, NULL to disable streaming
+ * @param  context User pointer passed to the callback
+ * @retval none
+ */
+void Calypso_MQTTsetStreamSink(CALYPSO *self, Calypso_MQTTStreamSink_t sink,
+                               void *context)
+{
+    self->streamSink = sink;
+    self->streamContext = context;
+}
+/**
+ * @brief  Publish data to the MQTT broker with QoS 1
  * @param  self Pointer to the calypso object.
  * @param  topic Pointer to MQTT topic
  * @param  retain 0=do not retain, 1=retain message
@@ -550,6 +687,25 @@ bool Calypso_MQTTgetMessage(CALYPSO *self, bool encoded)
  */
 bool Calypso_MQTTPublishData(CALYPSO *self, char *topic, uint8_t retain,
                              char *data, int length, bool encode)
+{
+    return Calypso_MQTTPublish(self, topic, ATMQTT_QOS_QOS1, retain, data,
+                               length, encode);
+}
+/**
+ * @brief  Publish data to the MQTT broker. With QoS 0 the call returns as soon
+ *         as the module accepted the message, otherwise it waits for the
+ *         broker acknowledgment.
+ * @param  self Pointer to the calypso object.
+ * @param  topic Pointer to MQTT topic
+ * @param  qos Quality of service
+ * @param  retain 0=do not retain, 1=retain message
+ * @param  data Pointer to the data to be published
+ * @param  length data length
+ * @param  encode 0=do not encode, 1=base64 encode
+ * @retval true if successful false in case of failure
+ */
+bool Calypso_MQTTPublish(CALYPSO *self, char *topic, ATMQTT_QoS_t qos,
+                         uint8_t retain, char *data, int length, bool encode)
 {
     bool ret = false;
     int index = MQTT_SOCKET_INDEX;
@@ -562,22 +718,30 @@ bool Calypso_MQTTPublishData(CALYPSO *self, char *topic, uint8_t retain,
         {
             uint32_t elen = 0;
             char out[CALYPSO_LINE_MAX_SIZE];
+            LATENCY_MARK(LATENCY_POINT_ENCODE_START);
             Calypso_encodeBase64((uint8_t *)data, length, (uint8_t *)out,
                                  &elen);
+            LATENCY_MARK(LATENCY_POINT_ENCODE_END);
             ret =
                 ATMQTT_addArgumentsPublish(pRequestCommand, index, topic,
-                                           ATMQTT_QOS_QOS1, retain, elen, out);
+                                           qos, retain, elen, out);
         }
         else
         {
             ret = ATMQTT_addArgumentsPublish(pRequestCommand, index, topic,
-                                             ATMQTT_QOS_QOS1, retain, length,
+                                             qos, retain, length,
                                              data);
         }
         if (ret)
         {
-            if (Calypso_SendRequest(self, pRequestCommand))
+            if (Calypso_sendRequest(self, pRequestCommand, true))
             {
+                LATENCY_MARK(LATENCY_POINT_MODULE_OK);
+                if (qos == ATMQTT_QOS_QOS0)
+                {
+                    /* No acknowledgment from the broker */
+                    return true;
+                }
                 return (Calypso_waitForEvent(self));
             }
         }
@@ -592,7 +756,7 @@ bool Calypso_MQTTPublishData(CALYPSO *self, char *topic, uint8_t retain,
     return false;
 }
 /**
- * @brief  Set MQTT username with parameter in the settings
+ * @brief  Set MQTT session type, username and password with parameters in the settings
  * @param  self Pointer to the calypso object.
  * @retval true if successful false in case of failure
  */
@@ -601,7 +765,21 @@ bool Calypso_MQTTSet(CALYPSO *self)
     bool ret = false;
     int index = MQTT_SOCKET_INDEX;
     pRequestCommand = &requestBuffer[0];
+    memset(pRequestCommand, 0, CALYPSO_LINE_MAX_SIZE);
+    strcpy(pRequestCommand, "AT+mqttSet=");
+    ret = ATMQTT_addArgumentsSet(
+        pRequestCommand, index, ATMQTT_SET_OPTION_clean,
+        &self->settings.mqttSettings.cleanSession);
+    strcat(pRequestCommand, "\r\n");
+    if (ret)
+    {
+        if (!Calypso_SendRequest(self, pRequestCommand))
+        {
+            return false;
+        }
+    }
 
+    pRequestCommand = &requestBuffer[0];
     if (strlen(self->settings.mqttSettings.userOptions.userName) == 0)
     {
         return true;
@@ -720,27 +898,100 @@ bool Calypso_MQTTDisconnect(CALYPSO *self)
     return false;
 }
 /**
- * @brief  Get the list of files in the file system
+ * @brief  Get the list of files in the file system and fill the directory cache
  * @param  self Pointer to the calypso object.
  * @retval true if successful false in case of failure
  */
 bool Calypso_fileList(CALYPSO *self)
 {
+    bool ret;
     pRequestCommand = &requestBuffer[0];
     memset(pRequestCommand, 0, CALYPSO_LINE_MAX_SIZE);
     strcpy(pRequestCommand, "AT+fileGetFileList");
     strcat(pRequestCommand, "\r\n");
-    return (Calypso_SendRequest(self, pRequestCommand));
+    fileCacheCount = 0;
+    fileCacheValid = true;
+    fileListPending = true;
+    ret = Calypso_SendRequest(self, pRequestCommand);
+    fileListPending = false;
+    /* Overflowing entries invalidate the cache, lookups then go to the module */
+    fileCacheValid = ret && fileCacheValid;
+#if SERIAL_DEBUG
+    SSerial_printf(self->serialDebug, "File cache %s, %u files\r\n",
+                   fileCacheValid ? "valid" : "invalid", fileCacheCount);
+#endif
+    return ret;
 }
 /**
- * @brief  Get the list of files in the file system
+ * @brief  Check if a file exists, answered from the directory cache if loaded
  * @param  self Pointer to the calypso object.
- * @retval true if successful false in case of failure
+ * @param  fileName Pointer to filename
+ * @retval true if the file exists false otherwise
  */
 bool Calypso_fileExists(CALYPSO *self, const char *fileName)
 {
+    if (fileCacheValid)
+    {
+        return (Calypso_fileCacheFind(fileName) != NULL);
+    }
     return (ATFile_getInfo(self, fileName, 0));
 }
+/**
+ * @brief  Get the maximum size of a file from the directory cache
+ * @param  self Pointer to the calypso object.
+ * @param  fileName Pointer to filename
+ * @param  maxSize Pointer to the maximum file size
+ * @retval true if the file is known false otherwise
+ */
+bool Calypso_fileGetSize(CALYPSO *self, const char *fileName,
+                         uint32_t *maxSize)
+{
+    Calypso_FileCacheEntry_t *entry;
+    if (!fileCacheValid)
+    {
+        return false;
+    }
+    entry = Calypso_fileCacheFind(fileName);
+    if (entry == NULL)
+    {
+        return false;
+    }
+    *maxSize = entry->maxSize;
+    return true;
+}
+/**
+ * @brief  Get a value that changes whenever a file is rewritten. It is a
+ *         hash over the file information reported by the module, which
+ *         includes the size and the write counter of the file.
+ * @param  self Pointer to the calypso object.
+ * @param  fileName Pointer to filename
+ * @param  fingerprint Pointer to the fingerprint
+ * @param  size Pointer to the file size from the same request. May be NULL
+ * @retval true if successful false in case of failure
+ */
+bool Calypso_fileGetFingerprint(CALYPSO *self, const char *fileName,
+                                uint32_t *fingerprint, uint32_t *size)
+{
+    uint32_t hash = 2166136261UL;
+    /* +filegetinfo:[flags],[fileSize],[allocatedSize],... */
+    if (!ATFile_getInfo(self, fileName, 0) ||
+        (0 != strncasecmp(self->bufferCalypso.data, "+filegetinfo:", 13)))
+    {
+        return false;
+    }
+    for (const char *c = &(self->bufferCalypso.data[13]); *c != '\0'; c++)
+    {
+        hash ^= (uint8_t)*c;
+        hash *= 16777619UL;
+    }
+    *fingerprint = hash;
+    if (size != NULL)
+    {
+        const char *fileSize = strchr(&(self->bufferCalypso.data[13]), ARGUMENT_DELIM);
+        *size = (fileSize != NULL) ? strtoul(fileSize + 1, NULL, 10) : 0;
+    }
+    return true;
+}
 /**
  * @brief  Delete the file
  * @param  self Pointer to the calypso object.
@@ -751,7 +1002,146 @@ bool Calypso_deleteFile(CALYPSO *self, const char *fileName)
     return (ATFile_del(self, fileName, 0));
 }
 /**
- * @brief  Open and read data frpm a file
+ * @brief  Hash a file name, case insensitive and without leading slash
+ * @param  fileName Pointer to filename
+ * @retval FNV-1a hash of the name
+ */
+static uint32_t Calypso_fileCacheHash(const char *fileName)
+{
+    uint32_t hash = 2166136261UL;
+    fileName = Calypso_fileCacheName(fileName);
+    while (*fileName != '\0')
+    {
+        hash ^= (uint8_t)tolower((uint8_t)*fileName++);
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+/**
+ * @brief  Name of a file as kept by the directory cache
+ * @param  fileName Pointer to filename
+ * @retval Pointer to the name without leading slash
+ */
+static const char *Calypso_fileCacheName(const char *fileName)
+{
+    return (*fileName == '/') ? (fileName + 1) : fileName;
+}
+/**
+ * @brief  Find a file in the directory cache. Names that share the hash are
+ *         told apart by their first CALYPSO_FILE_CACHE_NAME_LENGTH - 1
+ *         characters.
+ * @param  fileName Pointer to filename
+ * @retval Pointer to the entry or NULL
+ */
+static Calypso_FileCacheEntry_t *Calypso_fileCacheFind(const char *fileName)
+{
+    uint32_t hash = Calypso_fileCacheHash(fileName);
+    const char *name = Calypso_fileCacheName(fileName);
+    for (uint8_t i = 0; i < fileCacheCount; i++)
+    {
+        if ((fileCache[i].nameHash == hash) &&
+            (0 == strncasecmp(fileCache[i].name, name, CALYPSO_FILE_CACHE_NAME_LENGTH - 1)))
+        {
+            return &fileCache[i];
+        }
+    }
+    return NULL;
+}
+/**
+ * @brief  Add a file to the directory cache or update its size
+ * @param  fileName Pointer to filename
+ * @param  maxSize Maximum file size
+ * @retval none
+ */
+static void Calypso_fileCacheUpdate(const char *fileName, uint32_t maxSize)
+{
+    Calypso_FileCacheEntry_t *entry = Calypso_fileCacheFind(fileName);
+    if (entry == NULL)
+    {
+        if (fileCacheCount >= CALYPSO_FILE_CACHE_ENTRIES)
+        {
+            fileCacheValid = false;
+            return;
+        }
+        entry = &fileCache[fileCacheCount++];
+        entry->nameHash = Calypso_fileCacheHash(fileName);
+        strncpy(entry->name, Calypso_fileCacheName(fileName), sizeof(entry->name) - 1);
+        entry->name[sizeof(entry->name) - 1] = '\0';
+        entry->size = FILE_CACHE_SIZE_UNKNOWN;
+        entry->allocatedBlocks = 0;
+        entry->properties = 0;
+    }
+    entry->maxSize = maxSize;
+}
+/**
+ * @brief  Record the size of a file, FILE_CACHE_SIZE_UNKNOWN while it is
+ *         being written
+ * @param  fileName Pointer to filename
+ * @param  size Size of the file
+ * @retval none
+ */
+static void Calypso_fileCacheSetSize(const char *fileName, uint32_t size)
+{
+    Calypso_FileCacheEntry_t *entry = Calypso_fileCacheFind(fileName);
+    if (entry != NULL)
+    {
+        entry->size = size;
+    }
+}
+/**
+ * @brief  Remove a file from the directory cache
+ * @param  fileName Pointer to filename
+ * @retval none
+ */
+static void Calypso_fileCacheRemove(const char *fileName)
+{
+    Calypso_FileCacheEntry_t *entry = Calypso_fileCacheFind(fileName);
+    if (entry != NULL)
+    {
+        *entry = fileCache[--fileCacheCount];
+    }
+}
+/**
+ * @brief  Parse a line of the AT+fileGetFileList response into the cache
+ *         +filegetfilelist:[name],[maxSize],[properties],[allocatedBlocks]
+ * @param  line Pointer to the response line
+ * @retval none
+ */
+static void Calypso_fileCacheParseLine(char *line)
+{
+    char argument[FILENAME_MAX_LENGTH + 64];
+    char fileName[FILENAME_MAX_LENGTH + 64];
+    Calypso_FileCacheEntry_t *entry;
+
+    if ((0 != strncasecmp(line, FILE_LIST_RESPONSE, strlen(FILE_LIST_RESPONSE))) ||
+        (strlen(line) >= sizeof(argument)))
+    {
+        return;
+    }
+    line += strlen(FILE_LIST_RESPONSE);
+    if (!Calypso_getNextArgumentString(&line, fileName, ARGUMENT_DELIM) ||
+        !Calypso_getNextArgumentString(&line, argument, ARGUMENT_DELIM))
+    {
+        return;
+    }
+    Calypso_fileCacheUpdate(fileName, strtoul(argument, NULL, 10));
+    entry = Calypso_fileCacheFind(fileName);
+    if (entry == NULL)
+    {
+        return;
+    }
+    if (Calypso_getNextArgumentString(&line, argument, ARGUMENT_DELIM))
+    {
+        entry->properties = (uint16_t)strtoul(argument, NULL, 0);
+    }
+    if (Calypso_getNextArgumentString(&line, argument, STRING_TERMINATE))
+    {
+        entry->allocatedBlocks = (uint16_t)strtoul(argument, NULL, 10);
+    }
+}
+/**
+ * @brief  Open and read data from a file. Files larger than one
+ *         AT+fileRead are read in several chunks.
  * @param  self Pointer to the calypso object.
  * @param  path Pointer to the file path including the filename
  * @param  data Pointer to data buffer
@@ -761,28 +1151,267 @@ bool Calypso_deleteFile(CALYPSO *self, const char *fileName)
  */
 bool Calypso_readFile(CALYPSO *self, const char *path, char *data,
                       uint16_t dataLength, uint16_t *outputLength)
+{
+    Calypso_FileReader_t reader;
+
+    *outputLength = 0;
+    if (!Calypso_fileReaderOpen(self, &reader, path))
+    {
+        return false;
+    }
+    return Calypso_readOpenedFile(self, &reader, data, dataLength, outputLength);
+}
+/**
+ * @brief  Open and read data from a file whose size is already known, e.g.
+ *         from Calypso_fileGetFingerprint. Saves the file information
+ *         request of Calypso_readFile.
+ * @param  self Pointer to the calypso object.
+ * @param  path Pointer to the file path including the filename
+ * @param  size Size of the file, 0 if unknown
+ * @param  data Pointer to data buffer
+ * @param  dataLength Length of data to read
+ * @param  outputLength Length of read bytes
+ * @retval true if successful false in case of failure
+ */
+bool Calypso_readFileOfSize(CALYPSO *self, const char *path, uint32_t size,
+                            char *data, uint16_t dataLength,
+                            uint16_t *outputLength)
+{
+    Calypso_FileReader_t reader;
+
+    *outputLength = 0;
+    if (!Calypso_fileReaderOpenSize(self, &reader, path, size))
+    {
+        return false;
+    }
+    return Calypso_readOpenedFile(self, &reader, data, dataLength, outputLength);
+}
+/**
+ * @brief  Read an opened file into a buffer and close it
+ * @param  self Pointer to the calypso object.
+ * @param  reader Pointer to the reader of the file
+ * @param  data Pointer to data buffer
+ * @param  dataLength Length of data to read
+ * @param  outputLength Length of read bytes
+ * @retval true if successful false in case of failure
+ */
+static bool Calypso_readOpenedFile(CALYPSO *self, Calypso_FileReader_t *reader,
+                                   char *data, uint16_t dataLength,
+                                   uint16_t *outputLength)
 {
     bool ret = false;
-    uint32_t fileID;
-    uint32_t sToken;
-    uint16_t bytesRead;
-    char out[CALYPSO_LINE_MAX_SIZE];
-    Calypso_DataFormat_t outputFormat;
-    if (ATFile_open(self, path, ATFILE_OPEN_READ, 0, &fileID, &sToken))
+    uint16_t bytesRead = 0;
+
+    do
+    {
+        ret = Calypso_fileReaderRead(self, reader, (uint8_t *)data + *outputLength,
+                                     dataLength - *outputLength, &bytesRead);
+        *outputLength += bytesRead;
+    } while (ret && (bytesRead > 0) && (*outputLength < dataLength));
+    Calypso_fileReaderClose(self, reader);
+
+    /* Text files are expected to be terminated */
+    if (*outputLength < dataLength)
+    {
+        data[*outputLength] = '\0';
+    }
+    return ret;
+}
+/**
+ * @brief  Open a file for reading in chunks. The size of files written since
+ *         the directory was loaded comes from the cache, others are asked for.
+ * @param  self Pointer to the calypso object.
+ * @param  reader Pointer to the reader to initialize
+ * @param  path Pointer to the file path including the filename
+ * @retval true if successful false in case of failure
+ */
+bool Calypso_fileReaderOpen(CALYPSO *self, Calypso_FileReader_t *reader,
+                            const char *path)
+{
+    uint32_t fingerprint;
+    uint32_t size = 0;
+
+    if (fileCacheValid)
     {
-        if (ATFile_read(self, fileID, 0, Calypso_DataFormat_Base64, dataLength, &outputFormat, &bytesRead, out))
+        Calypso_FileCacheEntry_t *entry = Calypso_fileCacheFind(path);
+        if (entry == NULL)
         {
-            uint32_t elen = 0;
+            return false;
+        }
+        if (entry->size != FILE_CACHE_SIZE_UNKNOWN)
+        {
+            return Calypso_fileReaderOpenSize(self, reader, path, entry->size);
+        }
+    }
+    if (!Calypso_fileGetFingerprint(self, path, &fingerprint, &size))
+    {
+        size = 0;
+    }
+    return Calypso_fileReaderOpenSize(self, reader, path, size);
+}
+/**
+ * @brief  Open a file of known size for reading in chunks
+ * @param  self Pointer to the calypso object.
+ * @param  reader Pointer to the reader to initialize
+ * @param  path Pointer to the file path including the filename
+ * @param  size Size of the file, 0 if unknown
+ * @retval true if successful false in case of failure
+ */
+bool Calypso_fileReaderOpenSize(CALYPSO *self, Calypso_FileReader_t *reader,
+                                const char *path, uint32_t size)
+{
+    uint32_t sToken;
 
-            Calypso_decodeBase64((uint8_t *)out, bytesRead, (uint8_t *)data, &elen);
+    reader->offset = 0;
+    reader->size = size;
+    return (ATFile_open(self, path, ATFILE_OPEN_READ, 0, &reader->fileID, &sToken));
+}
+/**
+ * @brief  Set the position of the next read
+ * @param  reader Pointer to the reader
+ * @param  offset Offset from the start of the file
+ * @retval true if successful false if the offset is beyond the end of the file
+ */
+bool Calypso_fileReaderSeek(Calypso_FileReader_t *reader, uint32_t offset)
+{
+    if ((reader->size != 0) && (offset > reader->size))
+    {
+        return false;
+    }
+    reader->offset = offset;
+    return true;
+}
+/**
+ * @brief  Read the next bytes of a file
+ * @param  self Pointer to the calypso object.
+ * @param  reader Pointer to the reader
+ * @param  data Pointer to data buffer
+ * @param  length Size of the data buffer, at most CALYPSO_FILE_READ_CHUNK_SIZE
+ *         bytes are read per call
+ * @param  bytesRead Number of bytes read, 0 at the end of the file
+ * @retval true if successful false in case of failure
+ */
+bool Calypso_fileReaderRead(CALYPSO *self, Calypso_FileReader_t *reader,
+                            uint8_t *data, uint16_t length,
+                            uint16_t *bytesRead)
+{
+    char chunk[CALYPSO_LINE_MAX_SIZE];
+    if (!Calypso_fileReaderReadChunk(self, reader, length, chunk, bytesRead))
+    {
+        return false;
+    }
+    memcpy(data, chunk, *bytesRead);
+    return true;
+}
+/**
+ * @brief  Close a file opened by Calypso_fileReaderOpen
+ * @param  self Pointer to the calypso object.
+ * @param  reader Pointer to the reader
+ * @retval true if successful false in case of failure
+ */
+bool Calypso_fileReaderClose(CALYPSO *self, Calypso_FileReader_t *reader)
+{
+    return (ATFile_close(self, reader->fileID, NULL, NULL));
+}
+/**
+ * @brief  Read a file chunk by chunk and pass the data to a sink
+ * @param  self Pointer to the calypso object.
+ * @param  path Pointer to the file path including the filename
+ * @param  offset Offset to start reading from
+ * @param  sink Callback receiving the data
+ * @param  context User pointer passed to the callback
+ * @param  totalSize Pointer to the file size, 0 if unknown. May be NULL
+ * @retval true if successful false in case of failure
+ */
+bool Calypso_readFileStream(CALYPSO *self, const char *path, uint32_t offset,
+                            Calypso_FileSink_t sink, void *context,
+                            uint32_t *totalSize)
+{
+    bool ret = false;
+    uint16_t bytesRead = 0;
+    char chunk[CALYPSO_LINE_MAX_SIZE];
+    Calypso_FileReader_t reader;
 
-            *outputLength = elen;
-            ret = true;
+    if (!Calypso_fileReaderOpen(self, &reader, path))
+    {
+        return false;
+    }
+    if (totalSize != NULL)
+    {
+        *totalSize = reader.size;
+    }
+    ret = Calypso_fileReaderSeek(&reader, offset);
+    while (ret)
+    {
+        uint32_t chunkOffset = reader.offset;
+        ret = Calypso_fileReaderReadChunk(self, &reader, CALYPSO_FILE_READ_CHUNK_SIZE,
+                                          chunk, &bytesRead);
+        if (!ret || (bytesRead == 0))
+        {
+            break;
+        }
+        if (!sink(context, (uint8_t *)chunk, bytesRead, chunkOffset))
+        {
+            break;
         }
-        ATFile_close(self, fileID, NULL, NULL);
     }
+    Calypso_fileReaderClose(self, &reader);
     return ret;
 }
+/**
+ * @brief  Read and decode the next chunk of a file in place
+ * @param  self Pointer to the calypso object.
+ * @param  reader Pointer to the reader
+ * @param  length Maximum number of bytes to read
+ * @param  chunk Buffer of CALYPSO_LINE_MAX_SIZE bytes receiving the data
+ * @param  decodedLength Number of bytes read, 0 at the end of the file
+ * @retval true if successful false in case of failure
+ */
+static bool Calypso_fileReaderReadChunk(CALYPSO *self,
+                                        Calypso_FileReader_t *reader,
+                                        uint16_t length, char *chunk,
+                                        uint16_t *decodedLength)
+{
+    uint16_t encodedLength = 0;
+    uint32_t elen = 0;
+    Calypso_DataFormat_t outputFormat;
+
+    *decodedLength = 0;
+    if (length > CALYPSO_FILE_READ_CHUNK_SIZE)
+    {
+        length = CALYPSO_FILE_READ_CHUNK_SIZE;
+    }
+    if (reader->size != 0)
+    {
+        if (reader->offset >= reader->size)
+        {
+            return true;
+        }
+        if ((reader->size - reader->offset) < length)
+        {
+            length = reader->size - reader->offset;
+        }
+    }
+    if (length == 0)
+    {
+        return true;
+    }
+    if (!ATFile_read(self, reader->fileID, reader->offset,
+                     Calypso_DataFormat_Base64, length, &outputFormat,
+                     &encodedLength, chunk))
+    {
+        /* Reading past the end of a file of unknown size fails */
+        return (reader->size == 0) && (reader->offset > 0);
+    }
+    /* Decoding in place is safe, the output is never ahead of the input */
+    if (!Calypso_decodeBase64((uint8_t *)chunk, encodedLength, (uint8_t *)chunk, &elen))
+    {
+        return false;
+    }
+    *decodedLength = (uint16_t)elen;
+    reader->offset += elen;
+    return true;
+}
 /**
  * @brief Create/open and write data to a file
  * @param  self Pointer to the calypso object.
@@ -793,52 +1422,176 @@ bool Calypso_readFile(CALYPSO *self, const char *path, char *data,
  */
 bool Calypso_writeFile(CALYPSO *self, const char *path, const char *data,
                        uint16_t dataLength)
+{
+    return Calypso_writeFileBulk(self, path, (const uint8_t *)data, dataLength,
+                                 false, NULL);
+}
+/**
+ * @brief  Create/open and write a block of data of any content to a file.
+ *         The next chunk is prepared while the module writes the current
+ *         one and sent as soon as the write is confirmed.
+ * @param  self Pointer to the calypso object.
+ * @param  path Pointer to the file path including the filename
+ * @param  data Pointer to data to be written
+ * @param  dataLength Length of data to write
+ * @param  encodeToBase64 Transfer the data base64 encoded instead of binary
+ * @param  bytesPerSecond Pointer to the achieved throughput. May be NULL
+ * @retval true if successful false in case of failure
+ */
+bool Calypso_writeFileBulk(CALYPSO *self, const char *path,
+                           const uint8_t *data, uint32_t dataLength,
+                           bool encodeToBase64, uint32_t *bytesPerSecond)
 {
     bool ret = false;
     uint32_t fileID;
     uint32_t sToken;
-    int bytesRemaining = strlen(data);
-    int startIdx = 0;
-    int writeSize = 0;
+    uint32_t offset = 0;
+    uint32_t nextOffset = 0;
+    uint16_t chunkLength = 0;
+    uint16_t nextChunkLength = 0;
+    uint16_t commandLength = 0;
+    uint16_t nextCommandLength = 0;
     uint16_t bytesWritten = 0;
-    char dataToWrite[CALYPSO_FILE_WRITE_SIZE_MAX] = {0};
-    ret = ATFile_open(self, path, ATFILE_OPEN_CREATE | ATFILE_OPEN_OVERWRITE,
-                      dataLength, &fileID, &sToken);
-    if (ret)
+    unsigned long startTime = millis();
+    unsigned long elapsed;
+    char command[CALYPSO_LINE_MAX_SIZE];
+    char *pCommand = command;
+    char *pNextCommand = requestBuffer;
+
+    if (!ATFile_open(self, path, ATFILE_OPEN_CREATE | ATFILE_OPEN_OVERWRITE,
+                     dataLength, &fileID, &sToken))
+    {
+        return false;
+    }
+
+    ret = true;
+    if (dataLength > 0)
     {
-        while (bytesRemaining > 0)
+        chunkLength = Calypso_fileWriteCommand(pCommand, fileID, 0, data,
+                                               dataLength, encodeToBase64,
+                                               &commandLength);
+        nextOffset = chunkLength;
+        Calypso_SendbytesLength(self, pCommand, commandLength);
+    }
+    while (ret && (offset < dataLength))
+    {
+        char *temp;
+        int retries = 0;
+
+        /* Build the next command while the module is busy writing */
+        nextChunkLength = 0;
+        if (nextOffset < dataLength)
         {
-            if (bytesRemaining > CALYPSO_FILE_WRITE_SIZE_MAX)
-            {
-                writeSize = CALYPSO_FILE_WRITE_SIZE_MAX - 1;
-            }
-            else
+            nextChunkLength = Calypso_fileWriteCommand(
+                pNextCommand, fileID, nextOffset, data + nextOffset,
+                dataLength - nextOffset, encodeToBase64, &nextCommandLength);
+        }
+
+        while (!Calypso_waitForReply(self, Calypso_CNFStatus_Success, true))
+        {
+            retries++;
+            if (retries == MAX_RETRIES)
             {
-                writeSize = bytesRemaining;
+                ret = false;
+                break;
             }
-            memcpy(dataToWrite, data + startIdx, writeSize);
-            dataToWrite[writeSize] = '\0';
-            ret =
-                ATFile_write(self, fileID, startIdx, Calypso_DataFormat_Binary,
-                             false, writeSize, dataToWrite, &bytesWritten);
-            if (!ret)
+            delay(10); /*Guard interval for calypso*/
+            Calypso_SendbytesLength(self, pCommand, commandLength);
+        }
+        if (ret)
+        {
+            temp = self->bufferCalypso.data;
+            ret = ATFile_ParseResponseFileWrite(&temp, &bytesWritten) &&
+                  (bytesWritten == chunkLength);
+        }
+        if (ret)
+        {
+            char *swap = pCommand;
+            offset += chunkLength;
+            nextOffset += nextChunkLength;
+            pCommand = pNextCommand;
+            pNextCommand = swap;
+            chunkLength = nextChunkLength;
+            commandLength = nextCommandLength;
+            if (chunkLength > 0)
             {
-                break;
+                Calypso_SendbytesLength(self, pCommand, commandLength);
             }
-            startIdx = startIdx + bytesWritten;
-            bytesRemaining = bytesRemaining - bytesWritten;
         }
     }
-    if (ret)
+
+    elapsed = millis() - startTime;
+    if (bytesPerSecond != NULL)
+    {
+        *bytesPerSecond = (elapsed > 0) ? (offset * 1000UL) / elapsed : offset * 1000UL;
+    }
+#if SERIAL_DEBUG
+    SSerial_printf(self->serialDebug, "Wrote %lu bytes to %s in %lu ms\r\n",
+                   (unsigned long)offset, path, elapsed);
+#endif
+
+    if (ret && ATFile_close(self, fileID, NULL, NULL))
     {
-        return (ATFile_close(self, fileID, NULL, NULL));
+        Calypso_fileCacheSetSize(path, dataLength);
+        return true;
     }
     else
     {
-        ret = ATFile_close(self, fileID, NULL, NULL);
+        ATFile_close(self, fileID, NULL, NULL);
         return false;
     }
 }
+/**
+ * @brief  Build an AT+fileWrite command for the next chunk of a bulk write.
+ *         Unlike ATFile_AddArgumentsFileWrite the data may contain any byte.
+ * @param  command Buffer of CALYPSO_LINE_MAX_SIZE bytes for the command
+ * @param  fileID File to write
+ * @param  offset Write offset
+ * @param  data Pointer to the remaining data
+ * @param  length Number of remaining bytes
+ * @param  encodeToBase64 Encode the chunk to base64
+ * @param  commandLength Length of the command
+ * @retval Number of data bytes in the command
+ */
+static uint16_t Calypso_fileWriteCommand(char *command, uint32_t fileID,
+                                         uint32_t offset, const uint8_t *data,
+                                         uint32_t length, bool encodeToBase64,
+                                         uint16_t *commandLength)
+{
+    uint16_t chunkLength;
+    uint32_t transferLength;
+    size_t headerLength;
+
+    chunkLength = encodeToBase64 ? CALYPSO_FILE_WRITE_BASE64_CHUNK_SIZE : CALYPSO_FILE_WRITE_CHUNK_SIZE;
+    if (length < chunkLength)
+    {
+        chunkLength = length;
+    }
+    transferLength = encodeToBase64 ? Calypso_getBase64EncBufSize(chunkLength) : chunkLength;
+
+    strcpy(command, "AT+fileWrite=");
+    Calypso_appendArgumentInt(command, fileID, (INTFLAGS_NOTATION_DEC | INTFLAGS_UNSIGNED), ARGUMENT_DELIM);
+    Calypso_appendArgumentInt(command, offset, (INTFLAGS_NOTATION_DEC | INTFLAGS_UNSIGNED), ARGUMENT_DELIM);
+    Calypso_appendArgumentInt(command,
+                              encodeToBase64 ? Calypso_DataFormat_Base64 : Calypso_DataFormat_Binary,
+                              (INTFLAGS_NOTATION_DEC | INTFLAGS_UNSIGNED), ARGUMENT_DELIM);
+    Calypso_appendArgumentInt(command, transferLength, (INTFLAGS_NOTATION_DEC | INTFLAGS_UNSIGNED), ARGUMENT_DELIM);
+    headerLength = strlen(command);
+
+    if (encodeToBase64)
+    {
+        Calypso_encodeBase64((uint8_t *)data, chunkLength,
+                             (uint8_t *)&command[headerLength], &transferLength);
+    }
+    else
+    {
+        memcpy(&command[headerLength], data, chunkLength);
+    }
+    memcpy(&command[headerLength + transferLength], CRLF, 2);
+    *commandLength = headerLength + transferLength + 2;
+    command[*commandLength] = '\0';
+    return chunkLength;
+}
 /**
  * @brief  Open a file
  * @param  self Pointer to the calypso object
@@ -850,7 +1603,7 @@ bool Calypso_writeFile(CALYPSO *self, const char *path, const char *data,
  * @retval true if successful false in case of failure
  */
 bool ATFile_open(CALYPSO *self, const char *fileName, uint32_t options,
-                 uint16_t fileSize, uint32_t *fileID, uint32_t *secureToken)
+                 uint32_t fileSize, uint32_t *fileID, uint32_t *secureToken)
 {
     bool ret = false;
     pRequestCommand = &requestBuffer[0];
@@ -871,6 +1624,11 @@ bool ATFile_open(CALYPSO *self, const char *fileName, uint32_t options,
         char *temp = self->bufferCalypso.data;
         ret = ATFile_ParseResponseFileOpen(&temp, fileID, secureToken);
     }
+    if (ret && (options & ATFILE_OPEN_CREATE))
+    {
+        Calypso_fileCacheUpdate(fileName, fileSize);
+        Calypso_fileCacheSetSize(fileName, FILE_CACHE_SIZE_UNKNOWN);
+    }
     return ret;
 }
 /**
@@ -908,7 +1666,7 @@ bool ATFile_close(CALYPSO *self, uint32_t fileID, char *certFileName,
  * @param  writtenBytes Number of bytes successfully written
  * @retval true if successful false in case of failure
  */
-bool ATFile_write(CALYPSO *self, uint32_t fileID, uint16_t offset,
+bool ATFile_write(CALYPSO *self, uint32_t fileID, uint32_t offset,
                   Calypso_DataFormat_t format, bool encodeToBase64,
                   uint16_t bytestoWrite, char *data, uint16_t *writtenBytes)
 {
@@ -941,7 +1699,7 @@ bool ATFile_write(CALYPSO *self, uint32_t fileID, uint16_t offset,
  * @param  data Pointer to data to be written
  * @retval true if successful false in case of failure
  */
-bool ATFile_read(CALYPSO *self, uint32_t fileID, uint16_t offset,
+bool ATFile_read(CALYPSO *self, uint32_t fileID, uint32_t offset,
                  Calypso_DataFormat_t format, uint16_t bytesToRead,
                  Calypso_DataFormat_t *pOutFormat, uint16_t *byteRead,
                  char *data)
@@ -981,6 +1739,10 @@ bool ATFile_del(CALYPSO *self, const char *fileName, uint32_t secureToken)
     {
         ret = Calypso_SendRequest(self, pRequestCommand);
     }
+    if (ret)
+    {
+        Calypso_fileCacheRemove(fileName);
+    }
     return ret;
 }
 /**
@@ -1010,13 +1772,32 @@ bool ATFile_getInfo(CALYPSO *self, const char *fileName, uint32_t secureToken)
  * @retval true if successful false in case of failure
  */
 bool Calypso_SendRequest(CALYPSO *self, const char *sendCmd)
+{
+    return Calypso_sendRequest(self, sendCmd, false);
+}
+/**
+ * @brief  Send a request to calypso and wait for the response
+ * @param  self Pointer to the calypso object.
+ * @param  sendCmd Pointer to command
+ * @param  measure true to mark the UART transfer in the open latency sample
+ * @retval true if successful false in case of failure
+ */
+static bool Calypso_sendRequest(CALYPSO *self, const char *sendCmd, bool measure)
 {
     bool ret = false;
     int retries = 0;
     while (!ret)
     {
         delay(10); /*Guard interval for calypso*/
+        if (measure)
+        {
+            LATENCY_MARK(LATENCY_POINT_UART_TX_START);
+        }
         Calypso_Sendbytes(self, sendCmd);
+        if (measure)
+        {
+            LATENCY_MARK(LATENCY_POINT_UART_TX_END);
+        }
         ret = Calypso_waitForReply(self, Calypso_CNFStatus_Success, true);
         retries++;
         if (retries == MAX_RETRIES)
@@ -1033,12 +1814,24 @@ bool Calypso_SendRequest(CALYPSO *self, const char *sendCmd)
  * @retval true if successful false in case of failure
  */
 void Calypso_Sendbytes(CALYPSO *self, const char *sendCmd)
+{
+    Calypso_SendbytesLength(self, sendCmd, strlen(sendCmd));
+}
+/**
+ * @brief  Send a command that may contain binary data on to the calypso
+ *         serial port
+ * @param  self Pointer to the calypso object.
+ * @param  sendCmd Pointer to the data to send
+ * @param  length Number of bytes to send
+ */
+void Calypso_SendbytesLength(CALYPSO *self, const char *sendCmd,
+                             uint16_t length)
 {
     requestPending = true;
     lengthResponse = 0;
 #if SERIAL_DEBUG
     SSerial_printf(self->serialDebug, "Sending to Calypso: ");
-    SSerial_writeB(self->serialDebug, sendCmd, strlen(sendCmd));
+    SSerial_writeB(self->serialDebug, sendCmd, length);
     SSerial_printf(self->serialDebug, "\r\n");
 #endif
     int written = 1;
@@ -1048,9 +1841,9 @@ void Calypso_Sendbytes(CALYPSO *self, const char *sendCmd)
         {
             HSerial_read(self->serialCalypso);
         }
-        if (strlen(sendCmd) <= HSerial_availableForWrite(self->serialCalypso))
+        if (length <= HSerial_availableForWrite(self->serialCalypso))
         {
-            HSerial_writeB(self->serialCalypso, sendCmd, strlen(sendCmd));
+            HSerial_writeB(self->serialCalypso, sendCmd, length);
             written = 0;
         }
     }
@@ -1079,6 +1872,30 @@ bool Calypso_waitForEvent(CALYPSO *self)
     }
     return (!eventPending);
 }
+/**
+ * @brief  Handle an event that has arrived, without waiting when nothing has.
+ *         The partial line is kept between the calls and completed once it
+ *         has started, within EVENT_WAIT_TIME.
+ * @param  self Pointer to the calypso object.
+ * @retval true if an event was handled, false otherwise
+ */
+bool Calypso_pollEvent(CALYPSO *self)
+{
+    unsigned long startTime = micros();
+
+    if ((HSerial_available(self->serialCalypso) < 1) && (rxByteCounter == 0) &&
+        (streamRemaining == 0))
+    {
+        return false;
+    }
+    eventPending = true;
+    do
+    {
+        Calypso_RxBytes(self);
+    } while (eventPending && ((rxByteCounter != 0) || (streamRemaining != 0)) &&
+             ((micros() - startTime) < (EVENT_WAIT_TIME * 1000)));
+    return (!eventPending);
+}
 /**
  * @brief  Wait for calypso response
  * @param  self Pointer to the calypso object.
@@ -1186,6 +2003,7 @@ void Calypso_HandleEvents(CALYPSO *self)
                             connackCode);
 #endif
                         self->status = calypso_MQTT_connected;
+                        self->sessionPresent = false;
                         break;
                     case 1:
 #if SERIAL_DEBUG
@@ -1230,13 +2048,15 @@ void Calypso_HandleEvents(CALYPSO *self)
 #endif
                         break;
                     case 256:
+                        /* Connection accepted, broker resumed the stored session */
 #if SERIAL_DEBUG
                         SSerial_printf(
                             self->serialDebug,
-                            "MQTT connection accepted %i\r\n",
+                            "MQTT connection accepted, session present %i\r\n",
                             connackCode);
 #endif
                         self->status = calypso_MQTT_connected;
+                        self->sessionPresent = true;
                         break;
                     default:
 #if SERIAL_DEBUG
@@ -1251,6 +2071,7 @@ void Calypso_HandleEvents(CALYPSO *self)
             else if (0 == strcasecmp(value, "puback"))
             {
                 // SSerial_printf(self->serialDebug, "MQTT Puback\r\n");
+                LATENCY_MARK(LATENCY_POINT_PUBACK);
             }
             else if (0 == strcasecmp(value, "suback"))
             {
@@ -1284,6 +2105,35 @@ void Calypso_HandleEvents(CALYPSO *self)
         eventPending = false;
         break;
     }
+    case ATEvent_MQTTDisconnect:
+    {
+        if (self->status == calypso_MQTT_connected)
+        {
+            self->status = calypso_MQTT_disconnected;
+            eventPending = false;
+        }
+#if SERIAL_DEBUG
+        SSerial_printf(self->serialDebug, "MQTT disconnected\r\n");
+#endif
+        break;
+    }
+    case ATEvent_WlanDisconnect:
+    case ATEvent_NetappIPv4Lost:
+    {
+        /* Leave provisioning and start-up states untouched */
+        if ((self->status == calypso_WLAN_connected) ||
+            (self->status == calypso_MQTT_disconnected) ||
+            (self->status == calypso_MQTT_connected))
+        {
+            self->status = calypso_WLAN_disconnected;
+            memset(self->IP_ADDR, '\0', sizeof(self->IP_ADDR));
+            eventPending = false;
+        }
+#if SERIAL_DEBUG
+        SSerial_printf(self->serialDebug, "Wi-Fi connection lost\r\n");
+#endif
+        break;
+    }
     case ATEvent_WlanProvisioningStatus:
     {
         char value[64];
@@ -1362,6 +2212,10 @@ void Calypso_HandleRxLine(CALYPSO *self, char *rxPacket, uint16_t rxLength)
                 memcpy(self->bufferCalypso.data, RxBuffer, rxLength);
                 lengthResponse += rxLength;
                 self->bufferCalypso.length = lengthResponse;
+                if (fileListPending)
+                {
+                    Calypso_fileCacheParseLine(self->bufferCalypso.data);
+                }
                 Calypso_HandleEvents(self);
             }
         }
@@ -1388,6 +2242,24 @@ void Calypso_RxBytes(CALYPSO *self)
     while (HSerial_available(self->serialCalypso) >= 1)
     {
         readBuffer = HSerial_read(self->serialCalypso);
+        if (streamRemaining > 0)
+        {
+            Calypso_streamByte(self, readBuffer);
+            if (streamRemaining == 0)
+            {
+                /* Payload complete, the trailing CRLF is dropped by case 0 */
+#if SERIAL_DEBUG
+                SSerial_printf(self->serialDebug, "MQTT recv streamed %lu bytes\r\n", streamOffset);
+#endif
+                rxByteCounter = 0;
+                if (streamEndsWait)
+                {
+                    eventPending = false;
+                }
+                return;
+            }
+            continue;
+        }
         switch (rxByteCounter)
         {
         case 0:
@@ -1398,6 +2270,7 @@ void Calypso_RxBytes(CALYPSO *self)
                 ('+' == readBuffer))
             {
                 RxBuffer[rxByteCounter++] = readBuffer;
+                HeaderScanner_init(&recvHeader, ARGUMENT_DELIM, MQTT_RECV_HEADER_DELIMITERS);
             }
             break;
         }
@@ -1428,9 +2301,97 @@ void Calypso_RxBytes(CALYPSO *self)
             else
             {
                 RxBuffer[rxByteCounter++] = readBuffer;
+                if ((self->streamSink != NULL) && HeaderScanner_push(&recvHeader, (char)readBuffer))
+                {
+                    Calypso_checkStreamHeader(self);
+                }
             }
             break;
         }
         }
     }
 }
+/**
+ * @brief  Check if the line being received is an MQTT recv event whose payload
+ *         does not fit into the line buffer and switch to streaming if so.
+ *         Called once per line, after the delimiter that ends the header.
+ * @param  self Pointer to the calypso object.
+ * @retval none
+ */
+static void Calypso_checkStreamHeader(CALYPSO *self)
+{
+    char value[16];
+    char *pHeader;
+    uint32_t payloadLength;
+
+    if ((rxByteCounter < strlen(MQTT_RECV_EVENT)) ||
+        (0 != strncasecmp(RxBuffer, MQTT_RECV_EVENT, strlen(MQTT_RECV_EVENT))))
+    {
+        return;
+    }
+
+    /* Header complete: +eventmqtt:recv,topic,qos,retain,duplicate,format,length, */
+    RxBuffer[rxByteCounter - 1] = STRING_TERMINATE;
+    pHeader = &RxBuffer[strlen(MQTT_RECV_EVENT)];
+    Calypso_getNextArgumentString(&pHeader, self->subTopicName.data, ARGUMENT_DELIM);
+    Calypso_getNextArgumentString(&pHeader, value, ARGUMENT_DELIM);
+    Calypso_getNextArgumentString(&pHeader, value, ARGUMENT_DELIM);
+    Calypso_getNextArgumentString(&pHeader, value, ARGUMENT_DELIM);
+    Calypso_getNextArgumentString(&pHeader, value, ARGUMENT_DELIM);
+    streamFormat = (Calypso_DataFormat_t)atoi(value);
+    Calypso_getNextArgumentString(&pHeader, value, STRING_TERMINATE);
+    payloadLength = strtoul(value, NULL, 10);
+    RxBuffer[rxByteCounter - 1] = ARGUMENT_DELIM;
+
+    if ((rxByteCounter + payloadLength + 2) <= CALYPSO_LINE_MAX_SIZE)
+    {
+        /* Fits into the line buffer, handled by Calypso_HandleEvents */
+        return;
+    }
+
+    self->subTopicName.length = strlen(self->subTopicName.data);
+    self->rxData.length = 0;
+    streamRemaining = payloadLength;
+    streamOffset = 0;
+    streamBufferLength = 0;
+    Calypso_initBase64Decoder(&streamDecoder);
+}
+/**
+ * @brief  Collect a payload byte of a streamed MQTT message and pass decoded
+ *         chunks to the registered sink.
+ * @param  self Pointer to the calypso object.
+ * @param  byte Received byte
+ * @retval none
+ */
+static void Calypso_streamByte(CALYPSO *self, uint8_t byte)
+{
+    streamBuffer[streamBufferLength++] = byte;
+    streamRemaining--;
+    if ((streamBufferLength == CALYPSO_STREAM_CHUNK_SIZE) || (streamRemaining == 0))
+    {
+        uint8_t decoded[CALYPSO_STREAM_CHUNK_SIZE];
+        uint32_t decodedLength = 0;
+        if (streamFormat == Calypso_DataFormat_Base64)
+        {
+            if (!Calypso_decodeBase64Stream(&streamDecoder, streamBuffer,
+                                            streamBufferLength, decoded,
+                                            &decodedLength))
+            {
+#if SERIAL_DEBUG
+                SSerial_printf(self->serialDebug, "MQTT recv invalid base64\r\n");
+#endif
+                decodedLength = 0;
+            }
+        }
+        else
+        {
+            memcpy(decoded, streamBuffer, streamBufferLength);
+            decodedLength = streamBufferLength;
+        }
+        self->streamSink(self->streamContext, self->subTopicName.data,
+                         decoded, (uint16_t)decodedLength, streamOffset,
+                         (streamRemaining == 0));
+        streamOffset += decodedLength;
+        streamBufferLength = 0;
+    }
+}
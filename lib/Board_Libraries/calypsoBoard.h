@@ -39,6 +39,35 @@ extern "C"
 #define RESPONSE_WAIT_TIME 3000
 #define EVENT_WAIT_TIME 3000UL
 #define MAX_RETRIES 3
+#define CALYPSO_STREAM_CHUNK_SIZE 128 /* base64 characters per sink call, multiple of 4 */
+#define CALYPSO_FILE_CACHE_ENTRIES 32  /* files tracked by the directory cache */
+#define CALYPSO_FILE_CACHE_NAME_LENGTH 20 /* name characters kept to confirm a hash match, with terminator */
+#define CALYPSO_FILE_READ_CHUNK_SIZE 1024 /* bytes per AT+fileRead, base64 fits the line buffer */
+/* Calypso_SendbytesLength waits until a whole command fits the UART TX ring
+ * buffer, whose size comes from the build flags. The ring keeps one byte free. */
+#ifndef SERIAL_BUFFER_SIZE
+#error "SERIAL_BUFFER_SIZE has to be set in the build flags"
+#endif
+#define CALYPSO_TX_MAX_COMMAND (SERIAL_BUFFER_SIZE - 1)
+/* AT+fileWrite=<id>,<offset>,<format>,<length>, and CRLF around the data */
+#define CALYPSO_FILE_WRITE_HEADER_SIZE 48
+/* Bytes per AT+fileWrite, binary and base64 encoded */
+#ifndef CALYPSO_FILE_WRITE_CHUNK_SIZE
+#define CALYPSO_FILE_WRITE_CHUNK_SIZE (CALYPSO_TX_MAX_COMMAND - CALYPSO_FILE_WRITE_HEADER_SIZE)
+#endif
+#ifndef CALYPSO_FILE_WRITE_BASE64_CHUNK_SIZE
+#define CALYPSO_FILE_WRITE_BASE64_CHUNK_SIZE (CALYPSO_FILE_WRITE_CHUNK_SIZE / 4 * 3)
+#endif
+#if (CALYPSO_FILE_WRITE_CHUNK_SIZE <= 0) ||                                       \
+    (CALYPSO_FILE_WRITE_HEADER_SIZE + CALYPSO_FILE_WRITE_CHUNK_SIZE >                \
+     CALYPSO_TX_MAX_COMMAND) ||                                                     \
+    (CALYPSO_FILE_WRITE_HEADER_SIZE + (CALYPSO_FILE_WRITE_BASE64_CHUNK_SIZE + 2) / 3 * 4 > \
+     CALYPSO_TX_MAX_COMMAND)
+#error "AT+fileWrite chunks do not fit SERIAL_BUFFER_SIZE"
+#endif
+#if CALYPSO_TX_MAX_COMMAND >= CALYPSO_LINE_MAX_SIZE
+#error "SERIAL_BUFFER_SIZE is larger than the command buffers"
+#endif
 
     typedef enum
     {
@@ -49,10 +78,37 @@ extern "C"
         calypso_WLAN_disconnected,
         calypso_WLAN_connected,
         calypso_MQTT_wrong_root_ca,
+        calypso_MQTT_disconnected,
         calypso_MQTT_connected,
         calypso_error
     } Calypso_status_t;
 
+    /**
+     * @brief Consumer of a streamed MQTT payload.
+     * Called from the UART receive path with consecutive decoded chunks, the
+     * last call has last set. The sink must not send AT commands.
+     */
+    typedef void (*Calypso_MQTTStreamSink_t)(void *context, const char *topic,
+                                             const uint8_t *data, uint16_t length,
+                                             uint32_t offset, bool last);
+
+    /**
+     * @brief Consumer of a file read in chunks by Calypso_readFileStream.
+     * Return false to stop reading.
+     */
+    typedef bool (*Calypso_FileSink_t)(void *context, const uint8_t *data,
+                                       uint16_t length, uint32_t offset);
+
+    /**
+     * @brief Open file read chunk by chunk
+     */
+    typedef struct
+    {
+        uint32_t fileID;
+        uint32_t offset;
+        uint32_t size; /* 0 if unknown, the end is then detected by a short read */
+    } Calypso_FileReader_t;
+
     typedef struct
     {
         char timezone[5];
@@ -67,6 +123,7 @@ extern "C"
         ATMQTT_securityParams_t secParams;
         ATMQTT_connectionParams_t connParams;
         ATMQTT_userOptions_t userOptions;
+        uint8_t cleanSession; /* 0 = persistent session, 1 = clean session */
     } CALYPSO_MQTTSettings_t;
 
     typedef struct
@@ -101,12 +158,14 @@ extern "C"
         PacketCalypso rxData;
         TopicCalypso subTopicName;
         Calypso_status_t status;
+        bool sessionPresent;
         char firmwareVersion[20];
         char MAC_ADDR[20];
         char IP_ADDR[20];
         char telemetryPubTopic[MQTT_MAX_TOPIC_LENGTH];
         char udid[36];
-        
+        Calypso_MQTTStreamSink_t streamSink;
+        void *streamContext;
     } CALYPSO;
 
     CALYPSO *Calypso_Create(TypeSerial *serialDebug,
@@ -126,10 +185,16 @@ extern "C"
 
     bool Calypso_MQTTconnect(CALYPSO *self);
     bool Calypso_MQTTDisconnect(CALYPSO *self);
+    bool Calypso_MQTTReconnect(CALYPSO *self);
     bool Calypso_MQTTPublishData(CALYPSO *self, char *topic, uint8_t retain,
                                  char *data, int length, bool encode);
+    bool Calypso_MQTTPublish(CALYPSO *self, char *topic, ATMQTT_QoS_t qos,
+                             uint8_t retain, char *data, int length, bool encode);
     bool Calypso_subscribe(CALYPSO *self, uint8_t index, uint8_t numOfTopics, ATMQTT_subscribeTopic_t *pTopics);
     bool Calypso_MQTTgetMessage(CALYPSO *self, bool encoded);
+    bool Calypso_MQTTpollMessage(CALYPSO *self, bool encoded);
+    void Calypso_MQTTsetStreamSink(CALYPSO *self, Calypso_MQTTStreamSink_t sink,
+                                   void *context);
 
     bool Calypso_StartProvisioning(CALYPSO *self);
     bool Calypso_StopProvisioning(CALYPSO *self);
@@ -139,11 +204,33 @@ extern "C"
 
     bool Calypso_fileList(CALYPSO *self);
     bool Calypso_fileExists(CALYPSO *self, const char *fileName);
+    bool Calypso_fileGetSize(CALYPSO *self, const char *fileName,
+                             uint32_t *maxSize);
+    bool Calypso_fileGetFingerprint(CALYPSO *self, const char *fileName,
+                                    uint32_t *fingerprint, uint32_t *size);
     bool Calypso_writeFile(CALYPSO *self, const char *path, const char *data,
                            uint16_t dataLength);
+    bool Calypso_writeFileBulk(CALYPSO *self, const char *path,
+                               const uint8_t *data, uint32_t dataLength,
+                               bool encodeToBase64, uint32_t *bytesPerSecond);
     bool Calypso_readFile(CALYPSO *self, const char *path, char *data,
                           uint16_t dataLength, uint16_t *outputLength);
+    bool Calypso_readFileOfSize(CALYPSO *self, const char *path, uint32_t size,
+                                char *data, uint16_t dataLength,
+                                uint16_t *outputLength);
     bool Calypso_deleteFile(CALYPSO *self, const char *fileName);
+    bool Calypso_fileReaderOpen(CALYPSO *self, Calypso_FileReader_t *reader,
+                                const char *path);
+    bool Calypso_fileReaderOpenSize(CALYPSO *self, Calypso_FileReader_t *reader,
+                                    const char *path, uint32_t size);
+    bool Calypso_fileReaderSeek(Calypso_FileReader_t *reader, uint32_t offset);
+    bool Calypso_fileReaderRead(CALYPSO *self, Calypso_FileReader_t *reader,
+                                uint8_t *data, uint16_t length,
+                                uint16_t *bytesRead);
+    bool Calypso_fileReaderClose(CALYPSO *self, Calypso_FileReader_t *reader);
+    bool Calypso_readFileStream(CALYPSO *self, const char *path, uint32_t offset,
+                                Calypso_FileSink_t sink, void *context,
+                                uint32_t *totalSize);
     bool Calypso_waitForResponse(CALYPSO *self);
     bool Calypso_isIPConnected(CALYPSO *self);
     bool Calypso_ProvisioningDone(CALYPSO *self);
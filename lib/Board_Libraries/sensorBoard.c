@@ -52,11 +52,10 @@ bool sensorBoard_Init()
 }
 
 /**
- * @brief  Check the communication with the sensor and init sensor settings
- * @param  self Pointer to the sensor object.
- * @retval true if successful false in case of failure
+ * @brief  Check that the sensor answers with its device ID
+ * @retval true if the sensor is present false otherwise
  */
-bool PADS_2511020213301_simpleInit()
+bool PADS_2511020213301_probe()
 {
     // On the WSEN_PADS evaluation board, the SAO pin is set to high by default
     // Using the I2C address 1 = 0x5D
@@ -79,6 +78,16 @@ bool PADS_2511020213301_simpleInit()
         WE_DEBUG_PRINT("WSEN_PADS Communication fail\r\n");
         return false;
     }
+    return true;
+}
+
+/**
+ * @brief  Init the sensor settings, the sensor must have been probed
+ * @retval true if successful false in case of failure
+ */
+bool PADS_2511020213301_configure()
+{
+    int8_t status = WE_FAIL;
 
     /*set ODR to Power down*/
     status = PADS_setOutputDataRate(&pads_2511020213301,
@@ -133,25 +142,57 @@ bool PADS_2511020213301_simpleInit()
 }
 
 /**
- * @brief  Setup the sensor in single conversion mode and trigger a readout on
- * Enter key press
+ * @brief  Check the communication with the sensor and init sensor settings
+ * @retval true if successful false in case of failure
+ */
+bool PADS_2511020213301_simpleInit()
+{
+    return PADS_2511020213301_probe() && PADS_2511020213301_configure();
+}
+
+/**
+ * @brief  Start a single conversion and read it once it is done
  * @param  pressure pointer to float to write the pressure data to.
  * @param  temp pointer to float to write the temp data to.
  * @retval true if successful false in case of failure
  */
 bool PADS_2511020213301_readSensorData(float *pressure, float *temp)
+{
+    if (!PADS_2511020213301_trigger())
+    {
+        return false;
+    }
+    delay(PADS_2511020213301_CONVERSION_TIME);
+    return PADS_2511020213301_collect(pressure, temp);
+}
+
+/**
+ * @brief  Start a single conversion, read it with
+ * PADS_2511020213301_collect() after PADS_2511020213301_CONVERSION_TIME
+ * @retval true if successful false in case of failure
+ */
+bool PADS_2511020213301_trigger()
 {
     int8_t status = WE_FAIL;
 
-    /*Start a conversion*/
     status = PADS_enableOneShot(&pads_2511020213301, PADS_enable);
     if (status != WE_SUCCESS)
     {
         WE_DEBUG_PRINT("Set single conv mode error\r\n");
         return false;
     }
+    return true;
+}
 
-    delay(15);
+/**
+ * @brief  Read the result of a single conversion
+ * @param  pressure pointer to float to write the pressure data to.
+ * @param  temp pointer to float to write the temp data to.
+ * @retval true if successful false in case of failure
+ */
+bool PADS_2511020213301_collect(float *pressure, float *temp)
+{
+    int8_t status = WE_FAIL;
 
     if (pressure)
     {
@@ -182,10 +223,10 @@ bool PADS_2511020213301_readSensorData(float *pressure, float *temp)
 }
 
 /**
- * @brief  Check the communication with the sensor and init sensor settings
- * @retval true if successful false in case of failure
+ * @brief  Check that the sensor answers with its device ID
+ * @retval true if the sensor is present false otherwise
  */
-bool ITDS_2533020201601_simpleInit()
+bool ITDS_2533020201601_probe()
 {
     int8_t status = 0;
     uint8_t deviceIdValue = 0;
@@ -205,6 +246,16 @@ bool ITDS_2533020201601_simpleInit()
         WE_DEBUG_PRINT("WSEN_ITDS Communication fail\r\n");
         return false;
     }
+    return true;
+}
+
+/**
+ * @brief  Init the sensor settings, the sensor must have been probed
+ * @retval true if successful false in case of failure
+ */
+bool ITDS_2533020201601_configure()
+{
+    int8_t status = WE_FAIL;
 
     // /*Enable high performance mode*/
     status = ITDS_setOperatingMode(&itds_2533020201601, ITDS_highPerformance);
@@ -322,6 +373,15 @@ bool ITDS_2533020201601_simpleInit()
     return true;
 }
 
+/**
+ * @brief  Check the communication with the sensor and init sensor settings
+ * @retval true if successful false in case of failure
+ */
+bool ITDS_2533020201601_simpleInit()
+{
+    return ITDS_2533020201601_probe() && ITDS_2533020201601_configure();
+}
+
 /**
  * @brief  Read the acceleration data in normal mode
  * @param  accelX pointer to float to write the x axis acceleration data to.
@@ -413,6 +473,15 @@ bool ITDS_2533020201601_readSensorData(float *accelX, float *accelY,
     return true;
 }
 
+/**
+ * @brief  Nothing to start, the sensor converts continuously at 400 Hz
+ * @retval true
+ */
+bool ITDS_2533020201601_trigger()
+{
+    return true;
+}
+
 /**
  * @brief  Read the double tap event
  * @param  stateOccured pointer to bool to store state occured.
@@ -462,10 +531,10 @@ bool ITDS_2533020201601_readFreeFallEvent(bool *stateOccured)
 }
 
 /**
- * @brief  Check the communication with the sensor and init sensor settings
- * @retval true if successful false in case of failure
+ * @brief  Check that the sensor answers with its device ID
+ * @retval true if the sensor is present false otherwise
  */
-bool TIDS_2521020222501_simpleInit()
+bool TIDS_2521020222501_probe()
 {
     int8_t status = WE_FAIL;
     uint8_t deviceIdValue = 0;
@@ -488,17 +557,39 @@ bool TIDS_2521020222501_simpleInit()
     return true;
 }
 
+/**
+ * @brief  Check the communication with the sensor
+ * @retval true if successful false in case of failure
+ */
+bool TIDS_2521020222501_simpleInit()
+{
+    return TIDS_2521020222501_probe();
+}
+
 /**
  * @brief  Read the temperature data
  * @param  temp pointer to float to write the temperature data to.
  * @retval true if successful false in case of failure
  */
 bool TIDS_2521020222501_readSensorData(float *temp)
+{
+    if (!TIDS_2521020222501_trigger())
+    {
+        return false;
+    }
+    delay(TIDS_2521020222501_CONVERSION_TIME);
+    return TIDS_2521020222501_collect(temp);
+}
+
+/**
+ * @brief  Start a single conversion, read it with
+ * TIDS_2521020222501_collect() after TIDS_2521020222501_CONVERSION_TIME
+ * @retval true if successful false in case of failure
+ */
+bool TIDS_2521020222501_trigger()
 {
     int8_t status = WE_FAIL;
-    TIDS_state_t temperatureDataStatus = TIDS_enable;
 
-    /*Start a conversion*/
     status = TIDS_softReset(&tids_2521020222501, TIDS_enable);
     if (status != WE_SUCCESS)
     {
@@ -518,23 +609,30 @@ bool TIDS_2521020222501_readSensorData(float *temp)
         WE_DEBUG_PRINT("set single conversion fail\r\n");
         return false;
     }
+    return true;
+}
 
-    /*check the temp Data status*/
-    do
-    {
-        if (TIDS_isBusy(&tids_2521020222501, &temperatureDataStatus) !=
-            WE_SUCCESS)
-        {
-            return false;
-        }
-        WE_Delay(5);
-    } while (temperatureDataStatus == TIDS_enable);
+/**
+ * @brief  Read the result of a single conversion
+ * @param  temp pointer to float to write the temperature data to.
+ * @retval true if successful, false if the conversion is still running or
+ * in case of failure
+ */
+bool TIDS_2521020222501_collect(float *temp)
+{
+    int8_t status = WE_FAIL;
+    TIDS_state_t temperatureDataStatus = TIDS_enable;
 
-    if (status != WE_SUCCESS)
+    if (TIDS_isBusy(&tids_2521020222501, &temperatureDataStatus) != WE_SUCCESS)
     {
         WE_DEBUG_PRINT("get busy bit failed\r\n");
         return false;
     }
+    if (temperatureDataStatus == TIDS_enable)
+    {
+        WE_DEBUG_PRINT("TIDS data not ready\r\n");
+        return false;
+    }
 
     if (temp)
     {
@@ -552,10 +650,10 @@ bool TIDS_2521020222501_readSensorData(float *temp)
 }
 
 /**
- * @brief  Check the communication with the sensor and init sensor settings
- * @retval true if successful false in case of failure
+ * @brief  Check that the sensor answers with its device ID
+ * @retval true if the sensor is present false otherwise
  */
-bool HIDS_2525020210001_simpleInit()
+bool HIDS_2525020210001_probe()
 {
     int8_t status = WE_FAIL;
     uint8_t deviceIdValue = 0;
@@ -575,6 +673,16 @@ bool HIDS_2525020210001_simpleInit()
         WE_DEBUG_PRINT("WSEN_HIDS Communication fail\r\n");
         return false;
     }
+    return true;
+}
+
+/**
+ * @brief  Init the sensor settings, the sensor must have been probed
+ * @retval true if successful false in case of failure
+ */
+bool HIDS_2525020210001_configure()
+{
+    int8_t status = WE_FAIL;
 
     /*enable Block Data Update*/
     status = HIDS_enableBlockDataUpdate(&hids_2525020210001, HIDS_enable);
@@ -603,6 +711,15 @@ bool HIDS_2525020210001_simpleInit()
     return true;
 }
 
+/**
+ * @brief  Check the communication with the sensor and init sensor settings
+ * @retval true if successful false in case of failure
+ */
+bool HIDS_2525020210001_simpleInit()
+{
+    return HIDS_2525020210001_probe() && HIDS_2525020210001_configure();
+}
+
 /**
  * @brief  Read the humidity data
  * @param  humidity pointer to float to write the humidity data to.
@@ -611,14 +728,40 @@ bool HIDS_2525020210001_simpleInit()
  */
 bool HIDS_2525020210001_readSensorData(float *humidity, float *temp)
 {
-    int8_t status = WE_FAIL;
-    HIDS_state_t humStatus = HIDS_disable, tempStatus = HIDS_disable;
-    /*Start a conversion*/
+    if (!HIDS_2525020210001_trigger())
+    {
+        return false;
+    }
+    delay(HIDS_2525020210001_CONVERSION_TIME);
+    return HIDS_2525020210001_collect(humidity, temp);
+}
 
+/**
+ * @brief  Start a single conversion, read it with
+ * HIDS_2525020210001_collect() after HIDS_2525020210001_CONVERSION_TIME
+ * @retval true if successful false in case of failure
+ */
+bool HIDS_2525020210001_trigger()
+{
     if (WE_FAIL == HIDS_enableOneShot(&hids_2525020210001, HIDS_enable))
     {
         WE_DEBUG_PRINT("Could not set to one shot \r\n");
+        return false;
     }
+    return true;
+}
+
+/**
+ * @brief  Read the result of a single conversion
+ * @param  humidity pointer to float to write the humidity data to.
+ * @param  temperature pointer to float to write the temperature data to.
+ * @retval true if successful, false if no data is available or in case of
+ * failure
+ */
+bool HIDS_2525020210001_collect(float *humidity, float *temp)
+{
+    int8_t status = WE_FAIL;
+    HIDS_state_t humStatus = HIDS_disable, tempStatus = HIDS_disable;
 
     // Get status of data
     HIDS_isHumidityDataAvailable(&hids_2525020210001, &humStatus);
@@ -661,10 +804,10 @@ bool HIDS_2525020210001_readSensorData(float *humidity, float *temp)
 }
 
 /**
- * @brief  Check the communication with the sensor and init sensor settings
- * @retval true if successful false in case of failure
+ * @brief  Check that the sensor answers with its device ID
+ * @retval true if the sensor is present false otherwise
  */
-bool HIDS_2525020210002_simpleInit()
+bool HIDS_2525020210002_probe()
 {
     int8_t status = WE_FAIL;
 
@@ -682,10 +825,18 @@ bool HIDS_2525020210002_simpleInit()
         WE_DEBUG_PRINT("WSEN_HIDS Communication fail\r\n");
         return false;
     }
-
     return true;
 }
 
+/**
+ * @brief  Check the communication with the sensor
+ * @retval true if successful false in case of failure
+ */
+bool HIDS_2525020210002_simpleInit()
+{
+    return HIDS_2525020210002_probe();
+}
+
 /**
  * @brief  Read the humidity data
  * @param  humidity pointer to float to write the humidity data to.
@@ -693,11 +844,41 @@ bool HIDS_2525020210002_simpleInit()
  * @retval true if successful false in case of failure
  */
 bool HIDS_2525020210002_readSensorData(float *humidity, float *temp)
+{
+    if (!HIDS_2525020210002_trigger())
+    {
+        return false;
+    }
+    delay(HIDS_2525020210002_CONVERSION_TIME);
+    return HIDS_2525020210002_collect(humidity, temp);
+}
+
+/**
+ * @brief  Start a high precision measurement, read it with
+ * HIDS_2525020210002_collect() after HIDS_2525020210002_CONVERSION_TIME
+ * @retval true if successful false in case of failure
+ */
+bool HIDS_2525020210002_trigger()
+{
+    if (HIDS_Sensor_Start_Measurement(&hids_2525020210002, HIDS_MEASURE_HPM) != WE_SUCCESS)
+    {
+        WE_DEBUG_PRINT("Could not start measurement\r\n");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief  Read the result of a measurement
+ * @param  humidity pointer to float to write the humidity data to.
+ * @param  temperature pointer to float to write the temperature data to.
+ * @retval true if successful false in case of failure
+ */
+bool HIDS_2525020210002_collect(float *humidity, float *temp)
 {
     int8_t status = WE_FAIL;
     int32_t humidity_temp, temperature_temp;
-    status = HIDS_Sensor_Measure_Raw(&hids_2525020210002, HIDS_MEASURE_HPM,
-                                     &temperature_temp, &humidity_temp);
+    status = HIDS_Sensor_Read_Raw(&hids_2525020210002, &temperature_temp, &humidity_temp);
 
     if (status != WE_SUCCESS)
     {
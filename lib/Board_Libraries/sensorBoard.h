@@ -29,30 +29,60 @@
 
 /**         Includes         */
 #include "ConfigPlatform.h"
+#include "WSEN_HIDS_2525020210002.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/*
+ * Each sensor can be read in two phases: *_trigger() starts a conversion
+ * and *_collect() reads it once the conversion time has elapsed, so the
+ * conversions of all sensors overlap. *_readSensorData() does both and
+ * blocks for the conversion time.
+ */
+#define PADS_2511020213301_CONVERSION_TIME 15 // ms
+#define ITDS_2533020201601_CONVERSION_TIME 0  // ms, converts continuously
+#define TIDS_2521020222501_CONVERSION_TIME 15 // ms
+#define HIDS_2525020210001_CONVERSION_TIME 15 // ms
+#define HIDS_2525020210002_CONVERSION_TIME HIDS_MEASUREMENT_TIME_MS // ms
+
 extern bool sensorBoard_Init();
 
+extern bool PADS_2511020213301_probe();
+extern bool PADS_2511020213301_configure();
 extern bool PADS_2511020213301_simpleInit();
 extern bool PADS_2511020213301_readSensorData(float *pressure, float *temp);
+extern bool PADS_2511020213301_trigger();
+extern bool PADS_2511020213301_collect(float *pressure, float *temp);
 
+extern bool ITDS_2533020201601_probe();
+extern bool ITDS_2533020201601_configure();
 extern bool ITDS_2533020201601_simpleInit();
 extern bool ITDS_2533020201601_readSensorData(float *accelX, float *accelY,
                                               float *accelZ, float *temp);
+extern bool ITDS_2533020201601_trigger();
 extern bool ITDS_2533020201601_readDoubleTapEvent(bool *stateOccured);
 extern bool ITDS_2533020201601_readFreeFallEvent(bool *stateOccured);
 
+extern bool TIDS_2521020222501_probe();
 extern bool TIDS_2521020222501_simpleInit();
 extern bool TIDS_2521020222501_readSensorData(float *temp);
+extern bool TIDS_2521020222501_trigger();
+extern bool TIDS_2521020222501_collect(float *temp);
 
+extern bool HIDS_2525020210001_probe();
+extern bool HIDS_2525020210001_configure();
 extern bool HIDS_2525020210001_simpleInit();
 extern bool HIDS_2525020210001_readSensorData(float *humidity, float *temp);
+extern bool HIDS_2525020210001_trigger();
+extern bool HIDS_2525020210001_collect(float *humidity, float *temp);
 
+extern bool HIDS_2525020210002_probe();
 extern bool HIDS_2525020210002_simpleInit();
 extern bool HIDS_2525020210002_readSensorData(float *humidity, float *temp);
+extern bool HIDS_2525020210002_trigger();
+extern bool HIDS_2525020210002_collect(float *humidity, float *temp);
 #ifdef __cplusplus
 }
 #endif
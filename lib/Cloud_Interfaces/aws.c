@@ -24,12 +24,22 @@
 
  #include <string.h>
 
-#include "json-builder.h"
+#include "json.h"
 
 #include "device.h"
 #include "aws.h"
 
+#if CLOUD_AWS
+
 static char displayText[128];
+
+static const ConfigSchema_entry_t awsSchema[] = {
+    CONFIG_STRING("deviceId", 1, true, DEVICE_CONFIG_SETTINGS, CalypsoSettings,
+                  mqttSettings.clientID, NULL),
+    CONFIG_BUFFER("endPoint", 2, true, DEVICE_CONFIG_ADAPTER, MAX_URL_LEN),
+    DEVICE_CONFIG_NETWORK(3),
+};
+
 /**
  * @brief Load configuration from JSON.
  * @param configuration JSON configuration object.
@@ -39,10 +49,13 @@ static char displayText[128];
 bool AWS_loadConfiguration(json_value *configuration, CALYPSO *calypso)
 {
     char endPointAddress[MAX_URL_LEN] = {0};
-    
-    strcpy(calypso->settings.mqttSettings.clientID, configuration->u.object.values[1].value->u.string.ptr);
-    strcpy(endPointAddress, configuration->u.object.values[2].value->u.string.ptr);
+    void *bases[] = {&calypso->settings, endPointAddress};
 
+    if (!Device_bindConfiguration(awsSchema, sizeof(awsSchema) / sizeof(awsSchema[0]),
+                                  configuration, bases))
+    {
+        return false;
+    }
     if (!Calypso_fileExists(calypso, DEVICE_END_POINT_ADDRESS))
     {
         if (!Calypso_writeFile(calypso, DEVICE_END_POINT_ADDRESS, endPointAddress, strlen(endPointAddress)))
@@ -50,11 +63,6 @@ bool AWS_loadConfiguration(json_value *configuration, CALYPSO *calypso)
             return false;
         }
     }
-    strcpy(calypso->settings.sntpSettings.server, configuration->u.object.values[3].value->u.string.ptr);
-    strcpy(calypso->settings.sntpSettings.timezone, configuration->u.object.values[4].value->u.string.ptr);
-    strcpy(calypso->settings.wifiSettings.SSID, configuration->u.object.values[5].value->u.string.ptr);
-    strcpy(calypso->settings.wifiSettings.securityParams.securityKey, configuration->u.object.values[6].value->u.string.ptr);
-    calypso->settings.wifiSettings.securityParams.securityType = configuration->u.object.values[7].value->u.integer;
 
     // MQTT Settings
     calypso->settings.mqttSettings.flags = ATMQTT_CREATE_FLAGS_URL | ATMQTT_CREATE_FLAGS_SEC ;
@@ -98,23 +106,27 @@ bool AWS_SubscribeToTopics(CALYPSO *calypso)
 
 /**
  * @brief Process incoming cloud messages.
- * @param cloudResponse JSON response from the cloud.
+ * @param message Message received from the cloud.
+ * @param length Length of the message.
  * @param calypso CALYPSO structure.
  * @retval None.
  */
-void AWS_ProcessCloudMessage(json_value *cloudResponse, CALYPSO *calypso)
+void AWS_ProcessCloudMessage(const char *message, uint16_t length, CALYPSO *calypso)
 {
-    if(cloudResponse == NULL)
-    {
-        return;
-    }
     char cmdTopic[128];
     sprintf(cmdTopic, AWS_COMMAND_TOPIC, calypso->settings.mqttSettings.clientID);
     if (strstr(calypso->subTopicName.data, AWS_COMMAND_TOPIC))
     {
-        int red = cloudResponse->u.object.values[0].value->u.integer;
-        int green = cloudResponse->u.object.values[1].value->u.integer;
-        int blue = cloudResponse->u.object.values[2].value->u.integer;
+        Device_LedCommand_t command;
+        if (!Device_parseLedCommand(message, length, &command))
+        {
+            sprintf(displayText, "Invalid command");
+            SH1107_Display(1, 0, 16, displayText);
+            return;
+        }
+        int32_t red = command.red;
+        int32_t green = command.green;
+        int32_t blue = command.blue;
 
         if ((red < 0) || (red > 0xFF) ||
         (green < 0) || (green > 0xFF) ||
@@ -129,9 +141,25 @@ void AWS_ProcessCloudMessage(json_value *cloudResponse, CALYPSO *calypso)
             // value valid, set and send response
             uint32_t color = ((uint32_t)(red << 16) + (uint32_t)(green << 8) + (uint32_t)blue);
             neopixelSet(color);
-            sprintf(displayText, "LED color set\r\nR: %u\r\nG: %u\r\nB: %u", red, green, blue);
+            sprintf(displayText, "LED color set\r\nR: %u\r\nG: %u\r\nB: %u",
+                    (unsigned int)red, (unsigned int)green, (unsigned int)blue);
             SH1107_Display(1, 0, 16, displayText);
         }
 
     }
-}
\ No newline at end of file
+}
+
+const CloudAdapter_t AWS_adapter = {
+    .configVersion = AWS_IOT_CORE_CONFIG_VERSION,
+    .name = "AWS IoT Core",
+    .configSchema = awsSchema,
+    .configSchemaLength = sizeof(awsSchema) / sizeof(awsSchema[0]),
+    .loadConfiguration = AWS_loadConfiguration,
+    .subscribe = AWS_SubscribeToTopics,
+    .processMessage = AWS_ProcessCloudMessage,
+    .telemetryCbor = AWS_TELEMETRY_CBOR,
+    .diagnosticsTopic = AWS_DIAGNOSTICS_PUBLISH_TOPIC,
+    .configTopic = AWS_CONFIG_TOPIC,
+};
+
+#endif /* CLOUD_AWS */
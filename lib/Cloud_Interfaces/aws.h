@@ -27,9 +27,10 @@
  #define AWS_H
   #include <string.h>
  
- #include "json-builder.h"
+ #include "json.h"
  #include "device.h"
  #include "calypsoBoard.h"
+ #include "cloudAdapter.h"
  
  #ifdef __cplusplus
  extern "C"
@@ -37,12 +38,16 @@
  #endif
  
  #define AWS_TELEMETRY_PUBLISH_TOPIC "calypso/%s/telemetry"
+ #define AWS_DIAGNOSTICS_PUBLISH_TOPIC "calypso/%s/diagnostics"
+ #define AWS_CONFIG_TOPIC "calypso/%s/config"
  #define AWS_COMMAND_TOPIC "calypso/%s/setled"
  
  
  bool AWS_loadConfiguration(json_value *configuration, CALYPSO *calypso);
  bool AWS_SubscribeToTopics(CALYPSO *calypso);
- void AWS_ProcessCloudMessage(json_value *cloudResponse, CALYPSO *calypso);
+ void AWS_ProcessCloudMessage(const char *message, uint16_t length, CALYPSO *calypso);
+
+ extern const CloudAdapter_t AWS_adapter;
  
  #ifdef __cplusplus
  }
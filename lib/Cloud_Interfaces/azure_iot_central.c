@@ -24,10 +24,13 @@
 
  #include <string.h>
 
-#include "json-builder.h"
+#include "jsonPath.h"
+#include "jsonWriter.h"
+#include "fixedFormat.h"
 #include "azure_iot_central.h"
 #include "device.h"
 
+#if CLOUD_AZURE
 
 char kitID[DEVICE_CREDENTIALS_MAX_LEN] = {0};
 char scopeID[DEVICE_CREDENTIALS_MAX_LEN] = {0};
@@ -44,6 +47,37 @@ uint8_t reqID = 0;
 float lastBattVolt = 0;
 
 static char displayText[128];
+static char provOperationID[128];
+
+JSONPATH(provOperationIdPath, JSONPATH_KEY("operationId"));
+JSONPATH(provStatusPath, JSONPATH_KEY("status"));
+JSONPATH(provAssignedHubPath, JSONPATH_KEY("registrationState"), JSONPATH_KEY("assignedHub"));
+JSONPATH(twinFrequencyPath, JSONPATH_KEY("desired"), JSONPATH_KEY("telemetrySendFrequency"));
+JSONPATH(twinVersionPath, JSONPATH_KEY("desired"), JSONPATH_KEY("$version"));
+JSONPATH(patchFrequencyPath, JSONPATH_KEY("telemetrySendFrequency"));
+JSONPATH(patchVersionPath, JSONPATH_KEY("$version"));
+JSONPATH(twinReportPath, JSONPATH_KEY("desired"), JSONPATH_KEY("reportByException"));
+JSONPATH(patchReportPath, JSONPATH_KEY("reportByException"));
+/*Destinations following DEVICE_CONFIG_ADAPTER*/
+enum
+{
+    AZURE_CONFIG_KIT_ID = DEVICE_CONFIG_ADAPTER,
+    AZURE_CONFIG_SCOPE_ID,
+    AZURE_CONFIG_DPS_SERVER,
+    AZURE_CONFIG_MODEL_ID
+};
+
+static const ConfigSchema_entry_t azureSchema[] = {
+    CONFIG_BUFFER("kitId", 1, true, AZURE_CONFIG_KIT_ID, sizeof(kitID)),
+    CONFIG_BUFFER("scopeId", 2, true, AZURE_CONFIG_SCOPE_ID, sizeof(scopeID)),
+    CONFIG_BUFFER("dpsServer", 3, true, AZURE_CONFIG_DPS_SERVER, sizeof(dpsServerAddress)),
+    CONFIG_BUFFER("modelId", 4, true, AZURE_CONFIG_MODEL_ID, sizeof(modelID)),
+    DEVICE_CONFIG_NETWORK(5),
+};
+
+JSONPATH(ledRedPath, JSONPATH_KEY("red"));
+JSONPATH(ledGreenPath, JSONPATH_KEY("green"));
+JSONPATH(ledBluePath, JSONPATH_KEY("blue"));
 
 static void Azure_PublishVoltage(CALYPSO *calypso);
 static void Azure_PublishSWVersion(CALYPSO *calypso);
@@ -51,11 +85,14 @@ static void Azure_PublishUDID(CALYPSO *calypso);
 static void Azure_PublishMACAddress(CALYPSO *calypso);
 static void Azure_PublishDirectCmdResponse(CALYPSO *calypso, int status, int requestID);
 static void Azure_PublishSendInterval(CALYPSO *calypso, uint16_t val, uint16_t ac, uint16_t av, char *ad);
+static void Azure_ApplyReportSettings(CALYPSO *calypso, const json_value *settings, uint16_t av);
 static bool Azure_PublishProvStatusReq(CALYPSO *calypso, char *operationID);
 static bool Azure_PublishRegReq(CALYPSO *calypso);
 static char *Azure_SerializeProvReq();
 static char *Azure_SerializeVoltageData(float voltage);
 static char *Azure_SerializeSendInterval(CALYPSO *calypso, uint16_t val, uint16_t ac, uint16_t av, char *ad);
+static char *Azure_SerializeReportSettings(uint16_t ac, uint16_t av, const char *ad);
+static char *Azure_SerializeComponentProperty(const char *name, const char *value);
 
 /**
  * @brief Load configuration from JSON.
@@ -65,15 +102,19 @@ static char *Azure_SerializeSendInterval(CALYPSO *calypso, uint16_t val, uint16_
  */
 bool Azure_loadConfiguration(json_value *configuration, CALYPSO *calypso)
 {
-    strcpy(kitID, configuration->u.object.values[1].value->u.string.ptr);
-    strcpy(scopeID, configuration->u.object.values[2].value->u.string.ptr);
-    strcpy(dpsServerAddress, configuration->u.object.values[3].value->u.string.ptr);
-    strcpy(modelID, configuration->u.object.values[4].value->u.string.ptr);
-    strcpy(calypso->settings.sntpSettings.server, configuration->u.object.values[5].value->u.string.ptr);
-    strcpy(calypso->settings.sntpSettings.timezone, configuration->u.object.values[6].value->u.string.ptr);
-    strcpy(calypso->settings.wifiSettings.SSID, configuration->u.object.values[7].value->u.string.ptr);
-    strcpy(calypso->settings.wifiSettings.securityParams.securityKey, configuration->u.object.values[8].value->u.string.ptr);
-    calypso->settings.wifiSettings.securityParams.securityType = configuration->u.object.values[9].value->u.integer;
+    void *bases[] = {&calypso->settings, kitID, scopeID, dpsServerAddress, modelID};
+
+    if (!Device_bindConfiguration(azureSchema, sizeof(azureSchema) / sizeof(azureSchema[0]),
+                                  configuration, bases))
+    {
+        return false;
+    }
+    /*The kit ID is also the MQTT client ID*/
+    if (strlen(kitID) >= sizeof(calypso->settings.mqttSettings.clientID))
+    {
+        SSerial_printf(calypso->serialDebug, "Config kitId: too long\r\n");
+        return false;
+    }
     strcpy(calypso->settings.mqttSettings.clientID, kitID);
 
     sprintf(calypso->telemetryPubTopic, "devices/%s/messages/events/", kitID);
@@ -164,14 +205,20 @@ bool Azure_deviceProvision(CALYPSO *calypso)
         {
             json_value *provResponse = Device_GetCloudResponse();
             bool provDone = false;
-            if (provResponse != NULL)
+            const char *operationID = NULL;
+            if (JsonPath_getString(provResponse, &provOperationIdPath, &operationID) &&
+                (strlen(operationID) < sizeof(provOperationID)))
             {
+                /*The next response replaces this one, keep the operation ID*/
+                strcpy(provOperationID, operationID);
+                Device_FreeCloudResponse(provResponse);
                 strtok(calypso->subTopicName.data, equals);
                 strtok(NULL, equals);
                 retryAfter = strtok(NULL, equals);
                 retryAfterSec = atoi(retryAfter);
                 while (!provDone)
                 {
+                    const char *status = NULL;
                     if ((retryAfterSec > 1) && (retryAfterSec < 10))
                     {
                         SSerial_printf(calypso->serialDebug, "Retry after %is\r\n", atoi(retryAfter));
@@ -183,25 +230,36 @@ bool Azure_deviceProvision(CALYPSO *calypso)
                         delay(5000);
                     }
 
-                    Azure_PublishProvStatusReq(calypso, provResponse->u.object.values[0].value->u.string.ptr);
-                    json_value *provResponse = Device_GetCloudResponse();
-                    SSerial_printf(calypso->serialDebug, "%s\r\n", provResponse->u.object.values[1].value->u.string.ptr);
+                    Azure_PublishProvStatusReq(calypso, provOperationID);
+                    provResponse = Device_GetCloudResponse();
+                    if (!JsonPath_getString(provResponse, &provStatusPath, &status))
+                    {
+                        /*No answer yet, ask again*/
+                        Device_FreeCloudResponse(provResponse);
+                        continue;
+                    }
+                    SSerial_printf(calypso->serialDebug, "%s\r\n", status);
                     strtok(calypso->subTopicName.data, equals);
                     strtok(NULL, equals);
                     retryAfter = strtok(NULL, equals);
-                    if (0 == strncmp(provResponse->u.object.values[1].value->u.string.ptr, "assigned", strlen("assigned")))
+                    if (0 == strncmp(status, "assigned", strlen("assigned")))
                     {
+                        const char *assignedHub = NULL;
                         provDone = true;
-                        strcpy(azureEndPointAddress, provResponse->u.object.values[2].value->u.object.values[3].value->u.string.ptr);
-                        if (Calypso_writeFile(calypso, DEVICE_END_POINT_ADDRESS, azureEndPointAddress, strlen(azureEndPointAddress)))
+                        if (JsonPath_getString(provResponse, &provAssignedHubPath, &assignedHub) &&
+                            (strlen(assignedHub) < MAX_URL_LEN))
                         {
-                            ret = true;
-                            sprintf(displayText, "Provisioning complete");
-                            SH1107_Display(1, 0, 24, displayText);
-                            SSerial_printf(calypso->serialDebug, "Provisioning done: Connect to IoT hub %s\r\n", azureEndPointAddress);
+                            strcpy(azureEndPointAddress, assignedHub);
+                            if (Calypso_writeFile(calypso, DEVICE_END_POINT_ADDRESS, azureEndPointAddress, strlen(azureEndPointAddress)))
+                            {
+                                ret = true;
+                                sprintf(displayText, "Provisioning complete");
+                                SH1107_Display(1, 0, 24, displayText);
+                                SSerial_printf(calypso->serialDebug, "Provisioning done: Connect to IoT hub %s\r\n", azureEndPointAddress);
+                            }
                         }
                     }
-                    else if (0 == strncmp(provResponse->u.object.values[1].value->u.string.ptr, "failed", strlen("failed")))
+                    else if (0 == strncmp(status, "failed", strlen("failed")))
                     {
                         provDone = true;
                         ret = false;
@@ -209,12 +267,12 @@ bool Azure_deviceProvision(CALYPSO *calypso)
                         SH1107_Display(1, 0, 24, displayText);
                         SSerial_printf(calypso->serialDebug, "Provisioning failed\r\n");
                     }
+                    Device_FreeCloudResponse(provResponse);
                 }
-
-                json_value_free(provResponse);
             }
             else
             {
+                Device_FreeCloudResponse(provResponse);
                 SSerial_printf(calypso->serialDebug, "Response empty\r\n");
             }
         }
@@ -295,11 +353,14 @@ void Azure_ProcessCloudMessage(json_value *cloudResponse, CALYPSO *calypso)
         {
             unsigned long desiredVal = 0;
             uint16_t version = 0;
+            json_int_t frequency;
+            json_int_t desiredVersion;
             /*Received response for the properties get request*/
-            if (0 == strncmp(cloudResponse->u.object.values[0].value->u.object.values[0].name, "telemetrySendFrequency", strlen("telemetrySendFrequency")))
+            if (JsonPath_getInteger(cloudResponse, &twinFrequencyPath, &frequency) &&
+                JsonPath_getInteger(cloudResponse, &twinVersionPath, &desiredVersion))
             {
-                desiredVal = (unsigned long)cloudResponse->u.object.values[0].value->u.object.values[0].value->u.integer;
-                version = (unsigned long)cloudResponse->u.object.values[0].value->u.object.values[1].value->u.integer;
+                desiredVal = (unsigned long)frequency;
+                version = (uint16_t)desiredVersion;
                 /*Defualt value set by the cloud */
                 if ((desiredVal > MAX_TELEMETRY_SEND_INTERVAL) || (desiredVal < MIN_TELEMETRY_SEND_INTERVAL))
                 {
@@ -320,9 +381,15 @@ void Azure_ProcessCloudMessage(json_value *cloudResponse, CALYPSO *calypso)
             {
                 /*No default value available, setting the value from the device*/
                 version = (unsigned long)0;
-                desiredVal = (unsigned long)DEFAULT_TELEMETRY_SEND_INTEVAL;
+                desiredVal = telemetrySendInterval / 1000;
                 Azure_PublishSendInterval(calypso, desiredVal, AZURE_STATUS_SET_BY_DEV, version, "initialize");
             }
+            const json_value *reportSettings = JsonPath_find(cloudResponse, &twinReportPath);
+            if ((reportSettings != NULL) &&
+                JsonPath_getInteger(cloudResponse, &twinVersionPath, &desiredVersion))
+            {
+                Azure_ApplyReportSettings(calypso, reportSettings, (uint16_t)desiredVersion);
+            }
         }
         else
         {
@@ -332,8 +399,26 @@ void Azure_ProcessCloudMessage(json_value *cloudResponse, CALYPSO *calypso)
     else if (strstr(calypso->subTopicName.data, "$iothub/twin/PATCH/properties/desired/"))
     {
         /*Request to update writable property from cloud*/
-        unsigned long desiredVal = (unsigned long)cloudResponse->u.object.values[1].value->u.integer;
-        uint16_t version = (uint16_t)cloudResponse->u.object.values[0].value->u.integer;
+        json_int_t frequency;
+        json_int_t desiredVersion;
+        const json_value *reportSettings = JsonPath_find(cloudResponse, &patchReportPath);
+        bool frequencyFound = JsonPath_getInteger(cloudResponse, &patchFrequencyPath, &frequency);
+        if ((!frequencyFound && (reportSettings == NULL)) ||
+            !JsonPath_getInteger(cloudResponse, &patchVersionPath, &desiredVersion))
+        {
+            SSerial_printf(calypso->serialDebug, "Unknown property update\r\n");
+            return;
+        }
+        if (reportSettings != NULL)
+        {
+            Azure_ApplyReportSettings(calypso, reportSettings, (uint16_t)desiredVersion);
+        }
+        if (!frequencyFound)
+        {
+            return;
+        }
+        unsigned long desiredVal = (unsigned long)frequency;
+        uint16_t version = (uint16_t)desiredVersion;
 
         SSerial_printf(calypso->serialDebug, "desired val %i, version %i\r\n", desiredVal, version);
         if ((desiredVal > MAX_TELEMETRY_SEND_INTERVAL) || (desiredVal < MIN_TELEMETRY_SEND_INTERVAL))
@@ -361,11 +446,14 @@ void Azure_ProcessCloudMessage(json_value *cloudResponse, CALYPSO *calypso)
         strtok(token, equals);
         reqIDstr = strtok(NULL, equals);
 
-        int red = cloudResponse->u.object.values[0].value->u.integer;
-        int green = cloudResponse->u.object.values[1].value->u.integer;
-        int blue = cloudResponse->u.object.values[2].value->u.integer;
+        json_int_t red = -1;
+        json_int_t green = -1;
+        json_int_t blue = -1;
+        JsonPath_getInteger(cloudResponse, &ledRedPath, &red);
+        JsonPath_getInteger(cloudResponse, &ledGreenPath, &green);
+        JsonPath_getInteger(cloudResponse, &ledBluePath, &blue);
 
-        /*Direct command to set LED color*/
+        /*Direct command to set LED color, missing values are out of range*/
         if ((red < 0) || (red > 0xFF) ||
             (green < 0) || (green > 0xFF) ||
             (blue < 0) || (blue > 0xFF))
@@ -379,7 +467,8 @@ void Azure_ProcessCloudMessage(json_value *cloudResponse, CALYPSO *calypso)
             uint32_t color = ((uint32_t)(red << 16) + (uint32_t)(green << 8) + (uint32_t)blue);
             neopixelSet(color);
             Azure_PublishDirectCmdResponse(calypso, AZURE_STATUS_SUCCESS, atoi(reqIDstr));
-            sprintf(displayText, "LED color set\r\nR: %u\r\nG: %u\r\nB: %u", red, green, blue);
+            sprintf(displayText, "LED color set\r\nR: %u\r\nG: %u\r\nB: %u",
+                    (unsigned int)red, (unsigned int)green, (unsigned int)blue);
             SH1107_Display(1, 0, 16, displayText);
         }
     }
@@ -395,6 +484,11 @@ static void Azure_PublishVoltage(CALYPSO *calypso)
     float currentVoltage = getBatteryVoltage();
 
     char *dataSerializedVolt = Azure_SerializeVoltageData(currentVoltage);
+    if (dataSerializedVolt == NULL)
+    {
+        SSerial_printf(calypso->serialDebug, "Payload too long \r\n");
+        return;
+    }
 
     reqID++;
     sprintf(azurepubtopic, "%s%u", AZURE_TWIN_MESSAGE_PATCH, reqID);
@@ -408,7 +502,9 @@ static void Azure_PublishVoltage(CALYPSO *calypso)
     }
     else
     {
-        sprintf(displayText, "Property updated\r\nBatt voltage: %0.2f V", currentVoltage);
+        char voltage[FIXEDFORMAT_BUFFER_SIZE];
+        FixedFormat_float(voltage, sizeof(voltage), currentVoltage, 2);
+        sprintf(displayText, "Property updated\r\nBatt voltage: %s V", voltage);
         SH1107_Display(1, 0, 8, displayText);
     }
 
@@ -422,15 +518,11 @@ static void Azure_PublishVoltage(CALYPSO *calypso)
  */
 static void Azure_PublishSWVersion(CALYPSO *calypso)
 {
-    json_value *fwVersion = json_object_new(2);
-    json_object_push(fwVersion, "__t", json_string_new("c"));
-    json_object_push(fwVersion, "swVersion", json_string_new(calypso->firmwareVersion));
-    json_value *payload = json_object_new(1);
-    json_object_push(payload, "calypso", fwVersion);
-    memset(azurePayload, 0, MAX_PAYLOAD_LENGTH);
-    json_serialize(azurePayload, payload);
-    json_builder_free(payload);
-    json_builder_free(fwVersion);
+    if (Azure_SerializeComponentProperty("swVersion", calypso->firmwareVersion) == NULL)
+    {
+        SSerial_printf(calypso->serialDebug, "Payload too long \r\n");
+        return;
+    }
 
     reqID++;
     azurepubtopic[0] = '\0';
@@ -456,16 +548,11 @@ static void Azure_PublishSWVersion(CALYPSO *calypso)
  */
 static void Azure_PublishUDID(CALYPSO *calypso)
 {
-    json_value *jsonUdid = json_object_new(2);
-    json_object_push(jsonUdid, "__t", json_string_new("c"));
-    json_object_push(jsonUdid, "udid", json_string_new(calypso->udid));
-
-    json_value *payload = json_object_new(1);
-    json_object_push(payload, "calypso", jsonUdid);
-    memset(azurePayload, 0, MAX_PAYLOAD_LENGTH);
-    json_serialize(azurePayload, payload);
-    json_builder_free(payload);
-    json_builder_free(jsonUdid);
+    if (Azure_SerializeComponentProperty("udid", calypso->udid) == NULL)
+    {
+        SSerial_printf(calypso->serialDebug, "Payload too long \r\n");
+        return;
+    }
 
     reqID++;
     azurepubtopic[0] = '\0';
@@ -491,16 +578,11 @@ static void Azure_PublishUDID(CALYPSO *calypso)
  */
 static void Azure_PublishMACAddress(CALYPSO *calypso)
 {
-    json_value *macAddr = json_object_new(2);
-    json_object_push(macAddr, "__t", json_string_new("c"));
-    json_object_push(macAddr, "macAddress", json_string_new(calypso->MAC_ADDR));
-
-    json_value *payload = json_object_new(1);
-    json_object_push(payload, "calypso", macAddr);
-    memset(azurePayload, 0, MAX_PAYLOAD_LENGTH);
-    json_serialize(azurePayload, payload);
-    json_builder_free(payload);
-    json_builder_free(macAddr);
+    if (Azure_SerializeComponentProperty("macAddress", calypso->MAC_ADDR) == NULL)
+    {
+        SSerial_printf(calypso->serialDebug, "Payload too long \r\n");
+        return;
+    }
 
     reqID++;
     azurepubtopic[0] = '\0';
@@ -588,6 +670,11 @@ static void Azure_PublishSendInterval(CALYPSO *calypso, uint16_t val, uint16_t a
     azurepubtopic[0] = '\0';
     sprintf(azurepubtopic, "%s%u", AZURE_TWIN_MESSAGE_PATCH, reqID);
     char *dataSerializedInterval = Azure_SerializeSendInterval(calypso, val, ac, av, ad);
+    if (dataSerializedInterval == NULL)
+    {
+        SSerial_printf(calypso->serialDebug, "Payload too long \r\n");
+        return;
+    }
     SSerial_printf(calypso->serialDebug, "%s\r\n", dataSerializedInterval);
     if (!Calypso_MQTTPublishData(calypso, azurepubtopic, 1, dataSerializedInterval, strlen(dataSerializedInterval), true))
     {
@@ -595,6 +682,35 @@ static void Azure_PublishSendInterval(CALYPSO *calypso, uint16_t val, uint16_t a
     }
 }
 
+/**
+ * @brief Apply the report-by-exception settings (Writable property) and
+ * publish the settings in use.
+ * @param calypso CALYPSO structure.
+ * @param settings Desired settings.
+ * @param av Acknowledgment version.
+ * @retval None.
+ */
+static void Azure_ApplyReportSettings(CALYPSO *calypso, const json_value *settings, uint16_t av)
+{
+    bool valid = Device_applyReportSettings(settings);
+
+    reqID++;
+    azurepubtopic[0] = '\0';
+    sprintf(azurepubtopic, "%s%u", AZURE_TWIN_MESSAGE_PATCH, reqID);
+    char *dataSerialized = Azure_SerializeReportSettings(
+        valid ? AZURE_STATUS_SUCCESS : AZURE_STATUS_BAD_REQUEST, av,
+        valid ? "success" : "invalid parameter");
+    if (dataSerialized == NULL)
+    {
+        SSerial_printf(calypso->serialDebug, "Payload too long \r\n");
+        return;
+    }
+    SSerial_printf(calypso->serialDebug, "%s\r\n", dataSerialized);
+    if (!Calypso_MQTTPublishData(calypso, azurepubtopic, 1, dataSerialized, strlen(dataSerialized), true))
+    {
+        SSerial_printf(calypso->serialDebug, "Properties Publish failed\r\n");
+    }
+}
 
 /**
  * @brief Publish device provisioning status request.
@@ -637,6 +753,11 @@ static bool Azure_PublishRegReq(CALYPSO *calypso)
     sprintf(provReqTopic, "%s%u", AZURE_PROVISIONING_REG_REQ_TOPIC, reqID);
 
     char *provReq = Azure_SerializeProvReq();
+    if (provReq == NULL)
+    {
+        SSerial_printf(calypso->serialDebug, "Payload too long \r\n");
+        return false;
+    }
 
     if (!Calypso_MQTTPublishData(calypso, provReqTopic, 1, provReq, strlen(provReq), true))
     {
@@ -652,25 +773,23 @@ static bool Azure_PublishRegReq(CALYPSO *calypso)
 
 /**
  * @brief Serialize provisioning request data.
- * @retval Pointer to serialized data.
+ * @retval Pointer to serialized data, NULL if it does not fit.
  */
 static char *Azure_SerializeProvReq()
 {
-    json_value *prov_payload_ = json_object_new(1);
-    json_value *prov_modelID_ = json_object_new(1);
-
-    json_object_push(prov_modelID_, "modelId",
-                        json_string_new(modelID));
-    json_object_push(prov_payload_, "registrationId",
-                        json_string_new(kitID));
-    json_object_push(prov_payload_, "payload",
-                        prov_modelID_);
-
-    memset(azurePayload, 0, MAX_PAYLOAD_LENGTH);
-    json_serialize(azurePayload, prov_payload_);
-
-    json_builder_free(prov_payload_);
-    json_builder_free(prov_modelID_);
+    JsonWriter_t writer;
+
+    JsonWriter_init(&writer, azurePayload, MAX_PAYLOAD_LENGTH);
+    JsonWriter_beginObject(&writer, NULL);
+    JsonWriter_string(&writer, "registrationId", kitID);
+    JsonWriter_beginObject(&writer, "payload");
+    JsonWriter_string(&writer, "modelId", modelID);
+    JsonWriter_endObject(&writer);
+    JsonWriter_endObject(&writer);
+    if (JsonWriter_finish(&writer) == 0)
+    {
+        return NULL;
+    }
 
     return azurePayload;
 }
@@ -678,17 +797,21 @@ static char *Azure_SerializeProvReq()
 /**
  * @brief Serialize voltage data to send.
  * @param voltage Voltage value to serialize.
- * @retval Pointer to serialized data.
+ * @retval Pointer to serialized data, NULL if it does not fit.
  */
 static char *Azure_SerializeVoltageData(float voltage)
 {
-    json_value *payload = json_object_new(1);
-    json_object_push(payload, "batteryVoltage", json_double_new(voltage));
+    JsonWriter_t writer;
 
-    memset(azurePayload, 0, MAX_PAYLOAD_LENGTH);
-    json_serialize(azurePayload, payload);
+    JsonWriter_init(&writer, azurePayload, MAX_PAYLOAD_LENGTH);
+    JsonWriter_beginObject(&writer, NULL);
+    JsonWriter_float(&writer, "batteryVoltage", voltage, 3);
+    JsonWriter_endObject(&writer);
+    if (JsonWriter_finish(&writer) == 0)
+    {
+        return NULL;
+    }
 
-    json_builder_free(payload);
     return azurePayload;
 }
 
@@ -699,23 +822,93 @@ static char *Azure_SerializeVoltageData(float voltage)
  * @param ac Acknowledgment code.
  * @param av Acknowledgment version.
  * @param ad Acknowledgment description.
- * @retval Pointer to serialized data.
+ * @retval Pointer to serialized data, NULL if it does not fit.
  */
 static char *Azure_SerializeSendInterval(CALYPSO *calypso, uint16_t val, uint16_t ac, uint16_t av, char *ad)
 {
-    json_value *payload = json_object_new(1);
-    json_value *obj = json_object_new(1);
+    JsonWriter_t writer;
+
+    JsonWriter_init(&writer, azurePayload, MAX_PAYLOAD_LENGTH);
+    JsonWriter_beginObject(&writer, NULL);
+    JsonWriter_beginObject(&writer, "telemetrySendFrequency");
+    JsonWriter_integer(&writer, "value", val);
+    JsonWriter_integer(&writer, "ac", ac);
+    JsonWriter_integer(&writer, "av", av);
+    JsonWriter_string(&writer, "ad", ad);
+    JsonWriter_endObject(&writer);
+    JsonWriter_endObject(&writer);
+    if (JsonWriter_finish(&writer) == 0)
+    {
+        return NULL;
+    }
+
+    return azurePayload;
+}
+
+/**
+ * @brief Serialize the report-by-exception settings in use.
+ * @param ac Acknowledgment code.
+ * @param av Acknowledgment version.
+ * @param ad Acknowledgment description.
+ * @retval Pointer to serialized data, NULL if it does not fit.
+ */
+static char *Azure_SerializeReportSettings(uint16_t ac, uint16_t av, const char *ad)
+{
+    JsonWriter_t writer;
+
+    JsonWriter_init(&writer, azurePayload, MAX_PAYLOAD_LENGTH);
+    JsonWriter_beginObject(&writer, NULL);
+    JsonWriter_beginObject(&writer, "reportByException");
+    Device_writeReportSettings(&writer, "value");
+    JsonWriter_integer(&writer, "ac", ac);
+    JsonWriter_integer(&writer, "av", av);
+    JsonWriter_string(&writer, "ad", ad);
+    JsonWriter_endObject(&writer);
+    JsonWriter_endObject(&writer);
+    if (JsonWriter_finish(&writer) == 0)
+    {
+        return NULL;
+    }
 
-    json_object_push(obj, "value", json_integer_new(val));
-    json_object_push(obj, "ac", json_integer_new(ac));
-    json_object_push(obj, "av", json_integer_new(av));
-    json_object_push(obj, "ad", json_string_new(ad));
+    return azurePayload;
+}
 
-    json_object_push(payload, "telemetrySendFrequency", obj);
-    memset(azurePayload, 0, MAX_PAYLOAD_LENGTH);
-    json_serialize(azurePayload, payload);
+/**
+ * @brief Serialize a property of the calypso component.
+ * @param name Name of the property.
+ * @param value Value of the property.
+ * @retval Pointer to serialized data, NULL if it does not fit.
+ */
+static char *Azure_SerializeComponentProperty(const char *name, const char *value)
+{
+    JsonWriter_t writer;
+
+    JsonWriter_init(&writer, azurePayload, MAX_PAYLOAD_LENGTH);
+    JsonWriter_beginObject(&writer, NULL);
+    JsonWriter_beginObject(&writer, "calypso");
+    JsonWriter_string(&writer, "__t", "c");
+    JsonWriter_string(&writer, name, value);
+    JsonWriter_endObject(&writer);
+    JsonWriter_endObject(&writer);
+    if (JsonWriter_finish(&writer) == 0)
+    {
+        return NULL;
+    }
 
-    json_builder_free(payload);
-    json_builder_free(obj);
     return azurePayload;
 }
+
+const CloudAdapter_t Azure_adapter = {
+    .configVersion = AZURE_IOT_PNP_CONFIG_VERSION,
+    .name = "Azure IoT Central",
+    .configSchema = azureSchema,
+    .configSchemaLength = sizeof(azureSchema) / sizeof(azureSchema[0]),
+    .loadConfiguration = Azure_loadConfiguration,
+    .provision = Azure_deviceProvision,
+    .beforeConnect = Azure_setUserName,
+    .afterConnect = Azure_PublishProperties,
+    .subscribe = Azure_SubscribeToTopics,
+    .processDocument = Azure_ProcessCloudMessage,
+};
+
+#endif /* CLOUD_AZURE */
@@ -27,9 +27,10 @@
 #define AZURE_IOT_CENTRAL_H
  #include <string.h>
 
-#include "json-builder.h"
+#include "json.h"
 #include "device.h"
 #include "calypsoBoard.h"
+#include "cloudAdapter.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -70,6 +71,8 @@ void Azure_PublishProperties(CALYPSO *calypso);
 bool Azure_SubscribeToTopics(CALYPSO *calypso);
 void Azure_setUserName(CALYPSO *calypso);
 
+extern const CloudAdapter_t Azure_adapter;
+
 
 #ifdef __cplusplus
 }
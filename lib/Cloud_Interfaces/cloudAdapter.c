@@ -0,0 +1,63 @@
+/**
+ * \file
+ * \brief Interface of the cloud adapters of the WE IoT design kit.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#include <stddef.h>
+
+#include "cloudAdapter.h"
+#include "mosquitto.h"
+#include "azure_iot_central.h"
+#include "aws.h"
+#include "kaaiot.h"
+
+static const CloudAdapter_t *const adapters[] = {
+#if CLOUD_MOSQUITTO
+    &Mosquitto_adapter,
+#endif
+#if CLOUD_AZURE
+    &Azure_adapter,
+#endif
+#if CLOUD_AWS
+    &AWS_adapter,
+#endif
+#if CLOUD_KAA
+    &Kaa_adapter,
+#endif
+};
+
+/**
+ * @brief  Get the adapter of a configuration file
+ * @param  configVersion Version of the configuration file
+ * @retval Pointer to the adapter, NULL if it is not built in
+ */
+const CloudAdapter_t *CloudAdapter_find(uint8_t configVersion)
+{
+    for (uint8_t i = 0; i < sizeof(adapters) / sizeof(adapters[0]); i++)
+    {
+        if (adapters[i]->configVersion == configVersion)
+        {
+            return adapters[i];
+        }
+    }
+    return NULL;
+}
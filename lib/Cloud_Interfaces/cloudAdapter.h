@@ -0,0 +1,92 @@
+/**
+ * \file
+ * \brief Interface of the cloud adapters of the WE IoT design kit.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+#ifndef CLOUD_ADAPTER_H
+#define CLOUD_ADAPTER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "json.h"
+#include "calypsoBoard.h"
+#include "configSchema.h"
+
+/*Cloud adapters built into the firmware, e.g. -D CLOUD_AZURE=0 leaves the
+Azure code and its buffers out*/
+#ifndef CLOUD_MOSQUITTO
+#define CLOUD_MOSQUITTO 1
+#endif
+#ifndef CLOUD_AZURE
+#define CLOUD_AZURE 1
+#endif
+#ifndef CLOUD_AWS
+#define CLOUD_AWS 1
+#endif
+#ifndef CLOUD_KAA
+#define CLOUD_KAA 1
+#endif
+
+#if !(CLOUD_MOSQUITTO || CLOUD_AZURE || CLOUD_AWS || CLOUD_KAA)
+#error "At least one cloud adapter has to be built in"
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief Cloud specific steps of the device, optional steps are NULL
+     */
+    typedef struct
+    {
+        uint8_t configVersion; /* selects the adapter in the configuration file */
+        const char *name;
+        /*Schema bound by loadConfiguration, also checks configuration updates*/
+        const ConfigSchema_entry_t *configSchema;
+        uint8_t configSchemaLength;
+        bool (*loadConfiguration)(json_value *configuration, CALYPSO *calypso);
+        bool (*provision)(CALYPSO *calypso);
+        void (*beforeConnect)(CALYPSO *calypso);
+        void (*afterConnect)(CALYPSO *calypso);
+        bool (*subscribe)(CALYPSO *calypso);
+        /*One of the two, the document handler is also called without a message*/
+        void (*processMessage)(const char *message, uint16_t length, CALYPSO *calypso);
+        void (*processDocument)(json_value *message, CALYPSO *calypso);
+        bool telemetryCbor;
+        bool telemetryCompression;
+        /*Topic format taking the client ID, without one the diagnostics
+        are only printed on the debug port*/
+        const char *diagnosticsTopic;
+        /*Topic format taking the client ID on which the device receives
+        configuration files, NULL if the cloud does not send them*/
+        const char *configTopic;
+    } CloudAdapter_t;
+
+    const CloudAdapter_t *CloudAdapter_find(uint8_t configVersion);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLOUD_ADAPTER_H */
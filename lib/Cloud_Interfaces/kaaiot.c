@@ -24,19 +24,45 @@
 
  #include <string.h>
 
-#include "json-builder.h"
+#include "jsonPath.h"
+#include "jsonWriter.h"
 
 #include "device.h"
 #include "kaaiot.h"
 
+#if CLOUD_KAA
+
 static char displayText[128];
 static char appVersion[32];
 static char kitID[128];
 static char endPointToken[64];
 static char cmdResponseData[MAX_PAYLOAD_LENGTH];
 
+JSONPATH(commandIdPath, JSONPATH_KEY("id"));
+JSONPATH(commandRedPath, JSONPATH_KEY("payload"), JSONPATH_KEY("red"));
+JSONPATH(commandGreenPath, JSONPATH_KEY("payload"), JSONPATH_KEY("green"));
+JSONPATH(commandBluePath, JSONPATH_KEY("payload"), JSONPATH_KEY("blue"));
+
 static void Kaa_PublishDirectCmdResponse(CALYPSO *calypso, char *appVersion, char *token, char *commandType, int requestId, int statusCode, char *reasonPhrase);
 static char *Kaa_CommandResponseData(CALYPSO *calypso, int requestId, int statusCode, char *reasonPhrase);
+
+/*Destinations following DEVICE_CONFIG_ADAPTER*/
+enum
+{
+    KAA_CONFIG_KIT_ID = DEVICE_CONFIG_ADAPTER,
+    KAA_CONFIG_END_POINT,
+    KAA_CONFIG_TOKEN,
+    KAA_CONFIG_APP_VERSION
+};
+
+static const ConfigSchema_entry_t kaaSchema[] = {
+    CONFIG_BUFFER("kitId", 1, true, KAA_CONFIG_KIT_ID, sizeof(kitID)),
+    CONFIG_BUFFER("endPoint", 2, true, KAA_CONFIG_END_POINT, MAX_URL_LEN),
+    CONFIG_BUFFER("endPointToken", 3, true, KAA_CONFIG_TOKEN, sizeof(endPointToken)),
+    CONFIG_BUFFER("appVersion", 4, true, KAA_CONFIG_APP_VERSION, sizeof(appVersion)),
+    DEVICE_CONFIG_NETWORK(5),
+};
+
 /**
  * @brief Load configuration from JSON.
  * @param configuration JSON configuration object.
@@ -46,8 +72,13 @@ static char *Kaa_CommandResponseData(CALYPSO *calypso, int requestId, int status
 bool Kaa_loadConfiguration(json_value *configuration, CALYPSO *calypso)
 {
     char endPointAddress[MAX_URL_LEN] = {0};
-    strcpy(kitID, configuration->u.object.values[1].value->u.string.ptr);
-    strcpy(endPointAddress, configuration->u.object.values[2].value->u.string.ptr);
+    void *bases[] = {&calypso->settings, kitID, endPointAddress, endPointToken, appVersion};
+
+    if (!Device_bindConfiguration(kaaSchema, sizeof(kaaSchema) / sizeof(kaaSchema[0]),
+                                  configuration, bases))
+    {
+        return false;
+    }
 
     if (!Calypso_fileExists(calypso, DEVICE_END_POINT_ADDRESS))
     {
@@ -56,16 +87,14 @@ bool Kaa_loadConfiguration(json_value *configuration, CALYPSO *calypso)
             return false;
         }
     }
-    strcpy(endPointToken, configuration->u.object.values[3].value->u.string.ptr);
-    strcpy(appVersion, configuration->u.object.values[4].value->u.string.ptr);
+    /*The token is also the MQTT client ID*/
+    if (strlen(endPointToken) >= sizeof(calypso->settings.mqttSettings.clientID))
+    {
+        SSerial_printf(calypso->serialDebug, "Config endPointToken: too long\r\n");
+        return false;
+    }
     strcpy(calypso->settings.mqttSettings.clientID, endPointToken);
 
-    strcpy(calypso->settings.sntpSettings.server, configuration->u.object.values[5].value->u.string.ptr);
-    strcpy(calypso->settings.sntpSettings.timezone, configuration->u.object.values[6].value->u.string.ptr);
-    strcpy(calypso->settings.wifiSettings.SSID, configuration->u.object.values[7].value->u.string.ptr);
-    strcpy(calypso->settings.wifiSettings.securityParams.securityKey, configuration->u.object.values[8].value->u.string.ptr);
-    calypso->settings.wifiSettings.securityParams.securityType = configuration->u.object.values[9].value->u.integer;
-
     // MQTT Settings
     calypso->settings.mqttSettings.flags = ATMQTT_CREATE_FLAGS_URL ;// | ATMQTT_CREATE_FLAGS_SEC | ATMQTT_CREATE_FLAGS_SKIP_DATE_VERIFY | ATMQTT_CREATE_FLAGS_SKIP_CERT_VERIFY | ATMQTT_CREATE_FLAGS_SKIP_DOMAIN_VERIFY;
  
@@ -141,16 +170,21 @@ void Kaa_ProcessCloudMessage(json_value *cloudResponse, CALYPSO *calypso)
     if (strstr(msgCommandType, "setled"))
     {
 
-        if (cloudResponse->type == json_array)
+        json_int_t id;
+        if ((cloudResponse->type == json_array) && (cloudResponse->u.array.length > 0) &&
+            JsonPath_getInteger(cloudResponse->u.array.values[0], &commandIdPath, &id))
         {
             json_value *commandElement = cloudResponse->u.array.values[0];
-            json_value *commandPayloadJson = commandElement->u.object.values[1].value;
+            json_int_t red = -1;
+            json_int_t green = -1;
+            json_int_t blue = -1;
 
-            commandId = commandElement->u.object.values[0].value->u.integer;
+            commandId = (int)id;
 
-            int red = commandPayloadJson->u.object.values[0].value->u.integer;
-            int green = commandPayloadJson->u.object.values[1].value->u.integer;
-            int blue = commandPayloadJson->u.object.values[2].value->u.integer;
+            /*Missing values are reported as out of range*/
+            JsonPath_getInteger(commandElement, &commandRedPath, &red);
+            JsonPath_getInteger(commandElement, &commandGreenPath, &green);
+            JsonPath_getInteger(commandElement, &commandBluePath, &blue);
 
             if ((red < 0) || (red > 0xFF) ||
             (green < 0) || (green > 0xFF) ||
@@ -166,7 +200,8 @@ void Kaa_ProcessCloudMessage(json_value *cloudResponse, CALYPSO *calypso)
                 // value valid, set and send response
                 uint32_t color = ((uint32_t)(red << 16) + (uint32_t)(green << 8) + (uint32_t)blue);
                 neopixelSet(color);
-                sprintf(displayText, "LED color set\r\nR: %u\r\nG: %u\r\nB: %u", red, green, blue);
+                sprintf(displayText, "LED color set\r\nR: %u\r\nG: %u\r\nB: %u",
+                        (unsigned int)red, (unsigned int)green, (unsigned int)blue);
                 SH1107_Display(1, 0, 16, displayText);
                 Kaa_PublishDirectCmdResponse(calypso, appVersion, msgToken, msgCommandType, commandId, 200, "OK");
             }
@@ -200,36 +235,35 @@ static void Kaa_PublishDirectCmdResponse(CALYPSO *calypso, char *appVersion, cha
  */
 static char *Kaa_CommandResponseData(CALYPSO *calypso, int requestId, int statusCode, char *reasonPhrase)
 {
-    json_value *payloadArray = json_array_new(1);
-    json_value *payload = json_object_new(4);
-    if (payload == NULL)
-    {
-        SSerial_printf(calypso->serialDebug, "Payload memory full \r\n");
-        return NULL;
-    }
-
-    // id
-    json_object_push(payload, "id", json_integer_new(requestId));
-    // statusCode
-    json_object_push(payload, "statusCode", json_integer_new(statusCode));
-    // reasonPhrase
-    json_object_push(payload, "reasonPhrase", json_string_new(reasonPhrase));
-    // payload
-    json_value *responsePayload = json_object_new(0);
-    if (responsePayload == NULL)
+    JsonWriter_t writer;
+
+    JsonWriter_init(&writer, cmdResponseData, MAX_PAYLOAD_LENGTH);
+    JsonWriter_beginArray(&writer, NULL);
+    JsonWriter_beginObject(&writer, NULL);
+    JsonWriter_integer(&writer, "id", requestId);
+    JsonWriter_integer(&writer, "statusCode", statusCode);
+    JsonWriter_string(&writer, "reasonPhrase", reasonPhrase);
+    JsonWriter_beginObject(&writer, "payload");
+    JsonWriter_endObject(&writer);
+    JsonWriter_endObject(&writer);
+    JsonWriter_endArray(&writer);
+
+    if (JsonWriter_finish(&writer) == 0)
     {
-        json_builder_free(payload);
-        SSerial_printf(calypso->serialDebug, "cmdPayload memory full \r\n");
+        SSerial_printf(calypso->serialDebug, "Payload too long \r\n");
         return NULL;
     }
-    json_object_push(payload, "payload", responsePayload);
-    json_array_push(payloadArray, payload);
-
-    memset(cmdResponseData, 0, MAX_PAYLOAD_LENGTH);
-    json_serialize(cmdResponseData, payloadArray);
-
-    json_builder_free(payload);
-    json_builder_free(payloadArray);
-    json_builder_free(responsePayload);
     return cmdResponseData;
 }
+
+const CloudAdapter_t Kaa_adapter = {
+    .configVersion = KAA_IOT_CONFIG_VERSION,
+    .name = "KaaIoT",
+    .configSchema = kaaSchema,
+    .configSchemaLength = sizeof(kaaSchema) / sizeof(kaaSchema[0]),
+    .loadConfiguration = Kaa_loadConfiguration,
+    .subscribe = Kaa_SubscribeToTopics,
+    .processDocument = Kaa_ProcessCloudMessage,
+};
+
+#endif /* CLOUD_KAA */
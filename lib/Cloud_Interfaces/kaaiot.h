@@ -25,9 +25,10 @@
  #define KAAIOT_H
  #include <string.h>
  
- #include "json-builder.h"
+ #include "json.h"
  #include "device.h"
  #include "calypsoBoard.h"
+ #include "cloudAdapter.h"
  
  #ifdef __cplusplus
  extern "C"
@@ -41,6 +42,8 @@
  bool Kaa_loadConfiguration(json_value *configuration, CALYPSO *calypso);
  bool Kaa_SubscribeToTopics(CALYPSO *calypso);
  void Kaa_ProcessCloudMessage(json_value *cloudResponse, CALYPSO *calypso);
+
+ extern const CloudAdapter_t Kaa_adapter;
  
  #ifdef __cplusplus
  }
@@ -24,12 +24,22 @@
 
  #include <string.h>
 
-#include "json-builder.h"
+#include "json.h"
 
 #include "device.h"
 #include "mosquitto.h"
 
+#if CLOUD_MOSQUITTO
+
 static char displayText[128];
+
+static const ConfigSchema_entry_t mosquittoSchema[] = {
+    CONFIG_STRING("deviceId", 1, true, DEVICE_CONFIG_SETTINGS, CalypsoSettings,
+                  mqttSettings.clientID, NULL),
+    CONFIG_BUFFER("endPoint", 2, true, DEVICE_CONFIG_ADAPTER, MAX_URL_LEN),
+    DEVICE_CONFIG_NETWORK(3),
+};
+
 /**
  * @brief Load configuration from JSON.
  * @param configuration JSON configuration object.
@@ -39,10 +49,13 @@ static char displayText[128];
 bool Mosquitto_loadConfiguration(json_value *configuration, CALYPSO *calypso)
 {
     char endPointAddress[MAX_URL_LEN] = {0};
-    
-    strcpy(calypso->settings.mqttSettings.clientID, configuration->u.object.values[1].value->u.string.ptr);
-    strcpy(endPointAddress, configuration->u.object.values[2].value->u.string.ptr);
+    void *bases[] = {&calypso->settings, endPointAddress};
 
+    if (!Device_bindConfiguration(mosquittoSchema, sizeof(mosquittoSchema) / sizeof(mosquittoSchema[0]),
+                                  configuration, bases))
+    {
+        return false;
+    }
     if (!Calypso_fileExists(calypso, DEVICE_END_POINT_ADDRESS))
     {
         if (!Calypso_writeFile(calypso, DEVICE_END_POINT_ADDRESS, endPointAddress, strlen(endPointAddress)))
@@ -50,11 +63,6 @@ bool Mosquitto_loadConfiguration(json_value *configuration, CALYPSO *calypso)
             return false;
         }
     }
-    strcpy(calypso->settings.sntpSettings.server, configuration->u.object.values[3].value->u.string.ptr);
-    strcpy(calypso->settings.sntpSettings.timezone, configuration->u.object.values[4].value->u.string.ptr);
-    strcpy(calypso->settings.wifiSettings.SSID, configuration->u.object.values[5].value->u.string.ptr);
-    strcpy(calypso->settings.wifiSettings.securityParams.securityKey, configuration->u.object.values[6].value->u.string.ptr);
-    calypso->settings.wifiSettings.securityParams.securityType = configuration->u.object.values[7].value->u.integer;
 
     // MQTT Settings
     calypso->settings.mqttSettings.flags = ATMQTT_CREATE_FLAGS_URL | ATMQTT_CREATE_FLAGS_SEC | ATMQTT_CREATE_FLAGS_SKIP_CERT_VERIFY ;
@@ -98,23 +106,27 @@ bool Mosquitto_SubscribeToTopics(CALYPSO *calypso)
 
 /**
  * @brief Process incoming cloud messages.
- * @param cloudResponse JSON response from the cloud.
+ * @param message Message received from the cloud.
+ * @param length Length of the message.
  * @param calypso CALYPSO structure.
  * @retval None.
  */
-void Mosquitto_ProcessCloudMessage(json_value *cloudResponse, CALYPSO *calypso)
+void Mosquitto_ProcessCloudMessage(const char *message, uint16_t length, CALYPSO *calypso)
 {
-    if(cloudResponse == NULL)
-    {
-        return;
-    }
     char cmdTopic[128];
     sprintf(cmdTopic, MOSQUITTO_COMMAND_TOPIC, calypso->settings.mqttSettings.clientID);
     if (strstr(calypso->subTopicName.data, cmdTopic))
     {
-        int red = cloudResponse->u.object.values[0].value->u.integer;
-        int green = cloudResponse->u.object.values[1].value->u.integer;
-        int blue = cloudResponse->u.object.values[2].value->u.integer;
+        Device_LedCommand_t command;
+        if (!Device_parseLedCommand(message, length, &command))
+        {
+            sprintf(displayText, "Invalid command");
+            SH1107_Display(1, 0, 16, displayText);
+            return;
+        }
+        int32_t red = command.red;
+        int32_t green = command.green;
+        int32_t blue = command.blue;
 
         if ((red < 0) || (red > 0xFF) ||
         (green < 0) || (green > 0xFF) ||
@@ -129,9 +141,27 @@ void Mosquitto_ProcessCloudMessage(json_value *cloudResponse, CALYPSO *calypso)
             // value valid, set and send response
             uint32_t color = ((uint32_t)(red << 16) + (uint32_t)(green << 8) + (uint32_t)blue);
             neopixelSet(color);
-            sprintf(displayText, "LED color set\r\nR: %u\r\nG: %u\r\nB: %u", red, green, blue);
+            sprintf(displayText, "LED color set\r\nR: %u\r\nG: %u\r\nB: %u",
+                    (unsigned int)red, (unsigned int)green, (unsigned int)blue);
             SH1107_Display(1, 0, 16, displayText);
         }
 
     }
-}
\ No newline at end of file
+}
+
+const CloudAdapter_t Mosquitto_adapter = {
+    .configVersion = MOSQUITTO_CONFIG_VERSION,
+    .name = "Mosquitto",
+    .configSchema = mosquittoSchema,
+    .configSchemaLength = sizeof(mosquittoSchema) / sizeof(mosquittoSchema[0]),
+    .loadConfiguration = Mosquitto_loadConfiguration,
+    .subscribe = Mosquitto_SubscribeToTopics,
+    .processMessage = Mosquitto_ProcessCloudMessage,
+    .telemetryCbor = MOSQUITTO_TELEMETRY_CBOR,
+    .diagnosticsTopic = MOSQUITTO_DIAGNOSTICS_PUBLISH_TOPIC,
+    .configTopic = MOSQUITTO_CONFIG_TOPIC,
+    /*Only the Mosquitto consumers understand the compressed envelope*/
+    .telemetryCompression = true,
+};
+
+#endif /* CLOUD_MOSQUITTO */
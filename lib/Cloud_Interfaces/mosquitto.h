@@ -28,9 +28,10 @@
 
 #include <string.h>
 
-#include "json-builder.h"
+#include "json.h"
 #include "device.h"
 #include "calypsoBoard.h"
+#include "cloudAdapter.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -38,12 +39,16 @@ extern "C"
 #endif
 
 #define MOSQUITTO_TELEMETRY_PUBLISH_TOPIC "calypso/%s/telemetry"
+#define MOSQUITTO_DIAGNOSTICS_PUBLISH_TOPIC "calypso/%s/diagnostics"
+#define MOSQUITTO_CONFIG_TOPIC "calypso/%s/config"
 #define MOSQUITTO_COMMAND_TOPIC "calypso/%s/setled"
 
 
 bool Mosquitto_loadConfiguration(json_value *configuration, CALYPSO *calypso);
 bool Mosquitto_SubscribeToTopics(CALYPSO *calypso);
-void Mosquitto_ProcessCloudMessage(json_value *cloudResponse, CALYPSO *calypso);
+void Mosquitto_ProcessCloudMessage(const char *message, uint16_t length, CALYPSO *calypso);
+
+extern const CloudAdapter_t Mosquitto_adapter;
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,70 @@
+/**
+ * \file
+ * \brief Streaming aggregation of sensor samples.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#include "aggregate.h"
+
+/**
+ * @brief  Start a new interval. The last sample is kept, so an interval
+ *         without samples can still report it.
+ * @param  aggregate Pointer to the aggregate
+ * @retval None
+ */
+void Aggregate_reset(Aggregate_t *aggregate)
+{
+    aggregate->min = 0;
+    aggregate->max = 0;
+    aggregate->sum = 0;
+    aggregate->count = 0;
+}
+
+/**
+ * @brief  Add a sample
+ * @param  aggregate Pointer to the aggregate
+ * @param  value Sample
+ * @retval None
+ */
+void Aggregate_add(Aggregate_t *aggregate, float value)
+{
+    if ((aggregate->count == 0) || (value < aggregate->min))
+    {
+        aggregate->min = value;
+    }
+    if ((aggregate->count == 0) || (value > aggregate->max))
+    {
+        aggregate->max = value;
+    }
+    aggregate->sum += value;
+    aggregate->last = value;
+    aggregate->count++;
+}
+
+/**
+ * @brief  Get the mean of the samples
+ * @param  aggregate Pointer to the aggregate
+ * @retval Mean, 0 if there are no samples
+ */
+float Aggregate_mean(const Aggregate_t *aggregate)
+{
+    return (aggregate->count == 0) ? 0 : aggregate->sum / aggregate->count;
+}
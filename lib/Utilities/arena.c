@@ -0,0 +1,95 @@
+/**
+ * \file
+ * \brief Bump pointer arena allocator.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#include <string.h>
+
+#include "arena.h"
+
+/**
+ * @brief  Initialize an arena on a block of memory
+ * @param  arena Pointer to the arena
+ * @param  memory Block of memory, aligned to ARENA_ALIGNMENT
+ * @param  size Size of the block in bytes
+ * @retval None
+ */
+void Arena_init(Arena_t *arena, void *memory, size_t size)
+{
+    arena->memory = (uint8_t *)memory;
+    arena->size = size;
+    arena->used = 0;
+    arena->highWaterMark = 0;
+    arena->failures = 0;
+}
+
+/**
+ * @brief  Allocate memory from the arena
+ * @param  arena Pointer to the arena
+ * @param  size Number of bytes
+ * @param  zero Clear the memory
+ * @retval Pointer to the memory or NULL if the arena is full
+ */
+void *Arena_alloc(Arena_t *arena, size_t size, bool zero)
+{
+    void *ptr;
+    size_t aligned = (size + (ARENA_ALIGNMENT - 1)) & ~(size_t)(ARENA_ALIGNMENT - 1);
+
+    if ((aligned < size) || (aligned > (arena->size - arena->used)))
+    {
+        arena->failures++;
+        return NULL;
+    }
+    ptr = &arena->memory[arena->used];
+    arena->used += aligned;
+    if (arena->used > arena->highWaterMark)
+    {
+        arena->highWaterMark = arena->used;
+    }
+    if (zero)
+    {
+        memset(ptr, 0, size);
+    }
+    return ptr;
+}
+
+/**
+ * @brief  Release all allocations of the arena
+ * @param  arena Pointer to the arena
+ * @retval None
+ */
+void Arena_reset(Arena_t *arena)
+{
+    arena->used = 0;
+}
+
+void *Arena_jsonAlloc(size_t size, int zero, void *user_data)
+{
+    return Arena_alloc((Arena_t *)user_data, size, zero != 0);
+}
+
+void Arena_jsonFree(void *ptr, void *user_data)
+{
+    /* Released with Arena_reset */
+    (void)ptr;
+    (void)user_data;
+}
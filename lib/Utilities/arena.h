@@ -0,0 +1,66 @@
+/**
+ * \file
+ * \brief Bump pointer arena allocator.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Allocations are taken from a fixed block of memory and are never freed
+ * one by one, the whole arena is reset once the data is no longer needed.
+ * This keeps short lived allocations such as parsed JSON messages away
+ * from the heap.
+ */
+#define ARENA_ALIGNMENT 8 /* enough for double and 64 bit integers */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    typedef struct
+    {
+        uint8_t *memory;
+        size_t size;
+        size_t used;
+        size_t highWaterMark; /* largest use since Arena_init */
+        uint32_t failures;    /* allocations that did not fit */
+    } Arena_t;
+
+    void Arena_init(Arena_t *arena, void *memory, size_t size);
+    void *Arena_alloc(Arena_t *arena, size_t size, bool zero);
+    void Arena_reset(Arena_t *arena);
+
+    /* Allocator functions for json_settings, user_data is the arena */
+    void *Arena_jsonAlloc(size_t size, int zero, void *user_data);
+    void Arena_jsonFree(void *ptr, void *user_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ARENA_H */
@@ -0,0 +1,600 @@
+/**
+ * \file
+ * \brief Minimal CBOR (RFC 8949) encoder and decoder.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "cbor.h"
+
+#define CBOR_MAJOR_UNSIGNED 0
+#define CBOR_MAJOR_NEGATIVE 1
+#define CBOR_MAJOR_BYTES 2
+#define CBOR_MAJOR_TEXT 3
+#define CBOR_MAJOR_ARRAY 4
+#define CBOR_MAJOR_MAP 5
+#define CBOR_MAJOR_TAG 6
+#define CBOR_MAJOR_SIMPLE 7
+
+#define CBOR_HALF 25
+#define CBOR_SINGLE 26
+#define CBOR_DOUBLE 27
+
+/* Scaled values beyond this are never compared for the half precision check */
+#define CBOR_HALF_SCALED_MAX 1.0e9f
+
+static void CborWriter_put(CborWriter_t *writer, const uint8_t *data, size_t length);
+static void CborWriter_header(CborWriter_t *writer, uint8_t major, uint64_t argument);
+static bool CborReader_header(CborReader_t *reader, uint8_t *major, uint8_t *info,
+                              uint64_t *argument);
+static bool CborReader_skipLevel(CborReader_t *reader, uint8_t depth);
+static uint16_t Cbor_floatToHalf(float value);
+static float Cbor_halfToFloat(uint16_t half);
+static int32_t Cbor_round(float value);
+
+/* Powers of ten for the decimals a half precision float has to keep */
+static const float Cbor_decimalScale[] = {1.0f, 10.0f, 100.0f, 1000.0f, 10000.0f};
+
+/**
+ * @brief  Start writing into a buffer
+ * @param  writer Pointer to the writer
+ * @param  buffer Output buffer
+ * @param  size Size of the buffer
+ * @retval None
+ */
+void CborWriter_init(CborWriter_t *writer, uint8_t *buffer, size_t size)
+{
+    writer->buffer = buffer;
+    writer->size = size;
+    writer->length = 0;
+    writer->error = false;
+}
+
+/**
+ * @brief  Start a map, followed by the given number of key and value pairs
+ * @param  writer Pointer to the writer
+ * @param  pairs Number of pairs
+ * @retval None
+ */
+void CborWriter_map(CborWriter_t *writer, uint32_t pairs)
+{
+    CborWriter_header(writer, CBOR_MAJOR_MAP, pairs);
+}
+
+/**
+ * @brief  Start an array, followed by the given number of items
+ * @param  writer Pointer to the writer
+ * @param  items Number of items
+ * @retval None
+ */
+void CborWriter_array(CborWriter_t *writer, uint32_t items)
+{
+    CborWriter_header(writer, CBOR_MAJOR_ARRAY, items);
+}
+
+/**
+ * @brief  Add an integer
+ * @param  writer Pointer to the writer
+ * @param  value Integer value
+ * @retval None
+ */
+void CborWriter_integer(CborWriter_t *writer, int64_t value)
+{
+    if (value < 0)
+    {
+        /*-1 - n, computed without overflow*/
+        CborWriter_header(writer, CBOR_MAJOR_NEGATIVE, ~(uint64_t)value);
+    }
+    else
+    {
+        CborWriter_header(writer, CBOR_MAJOR_UNSIGNED, (uint64_t)value);
+    }
+}
+
+/**
+ * @brief  Add a text string
+ * @param  writer Pointer to the writer
+ * @param  text NUL terminated UTF-8 string
+ * @retval None
+ */
+void CborWriter_text(CborWriter_t *writer, const char *text)
+{
+    size_t length = strlen(text);
+    CborWriter_header(writer, CBOR_MAJOR_TEXT, length);
+    CborWriter_put(writer, (const uint8_t *)text, length);
+}
+
+/**
+ * @brief  Add a float, as half precision if it keeps the value at the given
+ *         number of decimals
+ * @param  writer Pointer to the writer
+ * @param  value Value
+ * @param  decimals Significant decimals of the value
+ * @retval None
+ */
+void CborWriter_float(CborWriter_t *writer, float value, uint8_t decimals)
+{
+    uint16_t half = Cbor_floatToHalf(value);
+    bool useHalf = false;
+    uint8_t data[5];
+
+    if (value != value || value == INFINITY || value == -INFINITY)
+    {
+        useHalf = true;
+    }
+    else if (((half & 0x7C00) != 0x7C00) &&
+             (decimals < sizeof(Cbor_decimalScale) / sizeof(Cbor_decimalScale[0])))
+    {
+        /*Half precision is enough if it rounds to the same decimal value,
+          finite values that overflow to an infinite half never are*/
+        float scaled = value * Cbor_decimalScale[decimals];
+        float scaledHalf = Cbor_halfToFloat(half) * Cbor_decimalScale[decimals];
+        if ((scaled > -CBOR_HALF_SCALED_MAX) && (scaled < CBOR_HALF_SCALED_MAX))
+        {
+            useHalf = Cbor_round(scaled) == Cbor_round(scaledHalf);
+        }
+    }
+
+    if (useHalf)
+    {
+        data[0] = (CBOR_MAJOR_SIMPLE << 5) | CBOR_HALF;
+        data[1] = (uint8_t)(half >> 8);
+        data[2] = (uint8_t)half;
+        CborWriter_put(writer, data, 3);
+    }
+    else
+    {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        data[0] = (CBOR_MAJOR_SIMPLE << 5) | CBOR_SINGLE;
+        data[1] = (uint8_t)(bits >> 24);
+        data[2] = (uint8_t)(bits >> 16);
+        data[3] = (uint8_t)(bits >> 8);
+        data[4] = (uint8_t)bits;
+        CborWriter_put(writer, data, 5);
+    }
+}
+
+/**
+ * @brief  Check the written data
+ * @param  writer Pointer to the writer
+ * @retval Length of the data, 0 if it did not fit
+ */
+size_t CborWriter_finish(CborWriter_t *writer)
+{
+    return writer->error ? 0 : writer->length;
+}
+
+/**
+ * @brief  Start reading
+ * @param  reader Pointer to the reader
+ * @param  data Encoded data
+ * @param  length Length of the data
+ * @retval None
+ */
+void CborReader_init(CborReader_t *reader, const uint8_t *data, size_t length)
+{
+    reader->data = data;
+    reader->length = length;
+    reader->position = 0;
+}
+
+/**
+ * @brief  Tell CBOR maps from JSON documents, which never start with a byte
+ *         of that range
+ * @param  data Received data
+ * @param  length Length of the data
+ * @retval true if the data starts with a CBOR map
+ */
+bool CborReader_isMap(const uint8_t *data, size_t length)
+{
+    return (length > 0) && ((data[0] >> 5) == CBOR_MAJOR_MAP);
+}
+
+/**
+ * @brief  Read the start of a map
+ * @param  reader Pointer to the reader
+ * @param  pairs Number of key and value pairs that follow
+ * @retval true if the next item is a map, otherwise nothing is consumed
+ */
+bool CborReader_map(CborReader_t *reader, uint32_t *pairs)
+{
+    size_t position = reader->position;
+    uint8_t major, info;
+    uint64_t argument;
+
+    if (!CborReader_header(reader, &major, &info, &argument) ||
+        (major != CBOR_MAJOR_MAP) || (argument > UINT32_MAX))
+    {
+        reader->position = position;
+        return false;
+    }
+    *pairs = (uint32_t)argument;
+    return true;
+}
+
+/**
+ * @brief  Read the start of an array
+ * @param  reader Pointer to the reader
+ * @param  items Number of items that follow
+ * @retval true if the next item is an array, otherwise nothing is consumed
+ */
+bool CborReader_array(CborReader_t *reader, uint32_t *items)
+{
+    size_t position = reader->position;
+    uint8_t major, info;
+    uint64_t argument;
+
+    if (!CborReader_header(reader, &major, &info, &argument) ||
+        (major != CBOR_MAJOR_ARRAY) || (argument > UINT32_MAX))
+    {
+        reader->position = position;
+        return false;
+    }
+    *items = (uint32_t)argument;
+    return true;
+}
+
+/**
+ * @brief  Read an integer
+ * @param  reader Pointer to the reader
+ * @param  value Pointer to the value
+ * @retval true if the next item is an integer in the range of int64_t,
+ *         otherwise nothing is consumed
+ */
+bool CborReader_integer(CborReader_t *reader, int64_t *value)
+{
+    size_t position = reader->position;
+    uint8_t major, info;
+    uint64_t argument;
+
+    if (CborReader_header(reader, &major, &info, &argument) && (argument <= INT64_MAX))
+    {
+        if (major == CBOR_MAJOR_UNSIGNED)
+        {
+            *value = (int64_t)argument;
+            return true;
+        }
+        if (major == CBOR_MAJOR_NEGATIVE)
+        {
+            *value = -1 - (int64_t)argument;
+            return true;
+        }
+    }
+    reader->position = position;
+    return false;
+}
+
+/**
+ * @brief  Read a text string
+ * @param  reader Pointer to the reader
+ * @param  text Pointer set to the text in the data, it is not NUL terminated
+ * @param  length Length of the text
+ * @retval true if the next item is a text string, otherwise nothing is consumed
+ */
+bool CborReader_text(CborReader_t *reader, const char **text, size_t *length)
+{
+    size_t position = reader->position;
+    uint8_t major, info;
+    uint64_t argument;
+
+    if (!CborReader_header(reader, &major, &info, &argument) ||
+        (major != CBOR_MAJOR_TEXT) || (argument > (reader->length - reader->position)))
+    {
+        reader->position = position;
+        return false;
+    }
+    *text = (const char *)&reader->data[reader->position];
+    *length = (size_t)argument;
+    reader->position += (size_t)argument;
+    return true;
+}
+
+/**
+ * @brief  Read a number, integers are converted
+ * @param  reader Pointer to the reader
+ * @param  value Pointer to the value
+ * @retval true if the next item is a number, otherwise nothing is consumed
+ */
+bool CborReader_float(CborReader_t *reader, float *value)
+{
+    size_t position = reader->position;
+    uint8_t major, info;
+    uint64_t argument;
+
+    if (CborReader_header(reader, &major, &info, &argument))
+    {
+        if ((major == CBOR_MAJOR_UNSIGNED) || (major == CBOR_MAJOR_NEGATIVE))
+        {
+            *value = (major == CBOR_MAJOR_UNSIGNED) ? (float)argument : -1.0f - (float)argument;
+            return true;
+        }
+        if (major == CBOR_MAJOR_SIMPLE)
+        {
+            if (info == CBOR_HALF)
+            {
+                *value = Cbor_halfToFloat((uint16_t)argument);
+                return true;
+            }
+            if (info == CBOR_SINGLE)
+            {
+                uint32_t bits = (uint32_t)argument;
+                memcpy(value, &bits, sizeof(bits));
+                return true;
+            }
+            if (info == CBOR_DOUBLE)
+            {
+                double number;
+                memcpy(&number, &argument, sizeof(number));
+                *value = (float)number;
+                return true;
+            }
+        }
+    }
+    reader->position = position;
+    return false;
+}
+
+/**
+ * @brief  Skip the next item including everything nested in it
+ * @param  reader Pointer to the reader
+ * @retval true if successful, false for malformed or too deeply nested data
+ */
+bool CborReader_skip(CborReader_t *reader)
+{
+    return CborReader_skipLevel(reader, 0);
+}
+
+static bool CborReader_skipLevel(CborReader_t *reader, uint8_t depth)
+{
+    uint8_t major, info;
+    uint64_t argument;
+
+    if ((depth >= CBOR_MAX_DEPTH) || !CborReader_header(reader, &major, &info, &argument))
+    {
+        return false;
+    }
+    switch (major)
+    {
+    case CBOR_MAJOR_BYTES:
+    case CBOR_MAJOR_TEXT:
+        if (argument > (reader->length - reader->position))
+        {
+            return false;
+        }
+        reader->position += (size_t)argument;
+        return true;
+
+    case CBOR_MAJOR_MAP:
+    case CBOR_MAJOR_ARRAY:
+    {
+        /*Every item takes at least one byte, which bounds the loop*/
+        uint64_t items = (major == CBOR_MAJOR_MAP) ? argument * 2 : argument;
+        if ((argument > reader->length) || (items > (reader->length - reader->position)))
+        {
+            return false;
+        }
+        while (items-- > 0)
+        {
+            if (!CborReader_skipLevel(reader, depth + 1))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    case CBOR_MAJOR_TAG:
+        return CborReader_skipLevel(reader, depth + 1);
+
+    default:
+        return true;
+    }
+}
+
+static void CborWriter_put(CborWriter_t *writer, const uint8_t *data, size_t length)
+{
+    if (writer->error || (length > (writer->size - writer->length)))
+    {
+        writer->error = true;
+        return;
+    }
+    memcpy(&writer->buffer[writer->length], data, length);
+    writer->length += length;
+}
+
+static void CborWriter_header(CborWriter_t *writer, uint8_t major, uint64_t argument)
+{
+    uint8_t data[9];
+    uint8_t size;
+
+    if (argument < 24)
+    {
+        data[0] = (uint8_t)((major << 5) | argument);
+        CborWriter_put(writer, data, 1);
+        return;
+    }
+    if (argument <= UINT8_MAX)
+    {
+        data[0] = (major << 5) | 24;
+        size = 1;
+    }
+    else if (argument <= UINT16_MAX)
+    {
+        data[0] = (major << 5) | 25;
+        size = 2;
+    }
+    else if (argument <= UINT32_MAX)
+    {
+        data[0] = (major << 5) | 26;
+        size = 4;
+    }
+    else
+    {
+        data[0] = (major << 5) | 27;
+        size = 8;
+    }
+    for (uint8_t i = 0; i < size; i++)
+    {
+        data[size - i] = (uint8_t)(argument >> (8 * i));
+    }
+    CborWriter_put(writer, data, size + 1);
+}
+
+/**
+ * @brief  Read the initial byte and the argument of the next item
+ * @param  reader Pointer to the reader
+ * @param  major Major type
+ * @param  info Additional information, tells the float sizes apart
+ * @param  argument Value, length or count of the item
+ * @retval true if successful, false at the end of the data or for
+ *         indefinite lengths
+ */
+static bool CborReader_header(CborReader_t *reader, uint8_t *major, uint8_t *info,
+                              uint64_t *argument)
+{
+    uint8_t size;
+
+    if (reader->position >= reader->length)
+    {
+        return false;
+    }
+    *major = reader->data[reader->position] >> 5;
+    *info = reader->data[reader->position] & 0x1F;
+    reader->position++;
+
+    if (*info < 24)
+    {
+        *argument = *info;
+        return true;
+    }
+    if (*info > 27)
+    {
+        return false;
+    }
+    size = 1 << (*info - 24);
+    if (size > (reader->length - reader->position))
+    {
+        return false;
+    }
+    *argument = 0;
+    for (uint8_t i = 0; i < size; i++)
+    {
+        *argument = (*argument << 8) | reader->data[reader->position++];
+    }
+    return true;
+}
+
+static int32_t Cbor_round(float value)
+{
+    /*Halves away from zero, as FixedFormat_float does*/
+    return (int32_t)((value < 0) ? (value - 0.5f) : (value + 0.5f));
+}
+
+static uint16_t Cbor_floatToHalf(float value)
+{
+    uint32_t bits;
+    uint16_t sign;
+    int32_t exponent;
+    uint32_t mantissa;
+    uint32_t half;
+    uint32_t rest;
+
+    memcpy(&bits, &value, sizeof(bits));
+    sign = (uint16_t)((bits >> 16) & 0x8000);
+    exponent = (int32_t)((bits >> 23) & 0xFF) - 127 + 15;
+    mantissa = bits & 0x7FFFFF;
+
+    if (((bits >> 23) & 0xFF) == 0xFF)
+    {
+        return sign | 0x7C00 | (mantissa ? 0x200 : 0);
+    }
+    if (exponent >= 31)
+    {
+        return sign | 0x7C00;
+    }
+    if (exponent <= 0)
+    {
+        /*Subnormal half*/
+        uint32_t shift;
+        if (exponent < -10)
+        {
+            return sign;
+        }
+        mantissa |= 0x800000;
+        shift = (uint32_t)(14 - exponent);
+        half = mantissa >> shift;
+        rest = mantissa & ((1ul << shift) - 1);
+        if ((rest > (1ul << (shift - 1))) || ((rest == (1ul << (shift - 1))) && (half & 1)))
+        {
+            half++;
+        }
+        return sign | (uint16_t)half;
+    }
+    half = ((uint32_t)exponent << 10) | (mantissa >> 13);
+    rest = mantissa & 0x1FFF;
+    /*Round to nearest even, a carry into the exponent is correct*/
+    if ((rest > 0x1000) || ((rest == 0x1000) && (half & 1)))
+    {
+        half++;
+    }
+    return sign | (uint16_t)half;
+}
+
+static float Cbor_halfToFloat(uint16_t half)
+{
+    uint32_t sign = (uint32_t)(half & 0x8000) << 16;
+    uint32_t exponent = (half >> 10) & 0x1F;
+    uint32_t mantissa = half & 0x3FF;
+    uint32_t bits;
+    float value;
+
+    if (exponent == 0)
+    {
+        if (mantissa == 0)
+        {
+            bits = sign;
+        }
+        else
+        {
+            /*Subnormal half, normalized for the float*/
+            exponent = 127 - 15 + 1;
+            while (!(mantissa & 0x400))
+            {
+                mantissa <<= 1;
+                exponent--;
+            }
+            bits = sign | (exponent << 23) | ((mantissa & 0x3FF) << 13);
+        }
+    }
+    else if (exponent == 31)
+    {
+        bits = sign | 0x7F800000 | (mantissa << 13);
+    }
+    else
+    {
+        bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+    }
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
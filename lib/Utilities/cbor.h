@@ -0,0 +1,81 @@
+/**
+ * \file
+ * \brief Minimal CBOR (RFC 8949) encoder and decoder.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#ifndef CBOR_H
+#define CBOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Only definite length items are supported, which is all the firmware
+ * writes. Floats are written as half precision when that keeps the value
+ * at the given number of decimals, otherwise as single precision. The
+ * reader accepts half, single and double precision floats.
+ */
+#define CBOR_MAX_DEPTH 8 /* nesting levels skipped by CborReader_skip */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    typedef struct
+    {
+        uint8_t *buffer;
+        size_t size;
+        size_t length;
+        bool error;
+    } CborWriter_t;
+
+    typedef struct
+    {
+        const uint8_t *data;
+        size_t length;
+        size_t position;
+    } CborReader_t;
+
+    void CborWriter_init(CborWriter_t *writer, uint8_t *buffer, size_t size);
+    void CborWriter_map(CborWriter_t *writer, uint32_t pairs);
+    void CborWriter_array(CborWriter_t *writer, uint32_t items);
+    void CborWriter_integer(CborWriter_t *writer, int64_t value);
+    void CborWriter_text(CborWriter_t *writer, const char *text);
+    void CborWriter_float(CborWriter_t *writer, float value, uint8_t decimals);
+    size_t CborWriter_finish(CborWriter_t *writer);
+
+    void CborReader_init(CborReader_t *reader, const uint8_t *data, size_t length);
+    bool CborReader_isMap(const uint8_t *data, size_t length);
+    bool CborReader_map(CborReader_t *reader, uint32_t *pairs);
+    bool CborReader_array(CborReader_t *reader, uint32_t *items);
+    bool CborReader_integer(CborReader_t *reader, int64_t *value);
+    bool CborReader_text(CborReader_t *reader, const char **text, size_t *length);
+    bool CborReader_float(CborReader_t *reader, float *value);
+    bool CborReader_skip(CborReader_t *reader);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CBOR_H */
@@ -0,0 +1,140 @@
+/**
+ * \file
+ * \brief Monotonic wall clock for the WE IoT design kit.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#include "ConfigPlatform.h"
+#include "clock.h"
+
+static bool synced = false;
+/*Time of the last synchronization, Unix ms and millis()*/
+static uint64_t anchorTime = 0;
+static uint32_t anchorLocal = 0;
+/*Synchronization the drift is measured from*/
+static uint64_t referenceTime = 0;
+static uint32_t referenceLocal = 0;
+static int32_t drift = 0; /* ppm */
+static uint64_t lastTime = 0;
+
+/**
+ * @brief  Pass a time read from the reference, e.g. the SNTP time of the
+ *         Wi-Fi module
+ * @param  time Unix time in ms
+ * @param  local millis() at the time the reference was read
+ * @retval None
+ */
+void Clock_sync(uint64_t time, uint32_t local)
+{
+    if (synced)
+    {
+        uint32_t span = local - referenceLocal;
+        int64_t deviation = (int64_t)(time - referenceTime) - (int64_t)span;
+        int64_t measured = (span > 0) ? (deviation * 1000000) / (int64_t)span : 0;
+
+        if ((measured > CLOCK_MAX_DRIFT_PPM) || (measured < -CLOCK_MAX_DRIFT_PPM))
+        {
+            /*The reference jumped, measure again from here*/
+            referenceTime = time;
+            referenceLocal = local;
+        }
+        else
+        {
+            if (span >= CLOCK_DRIFT_MIN_SPAN)
+            {
+                drift = (int32_t)measured;
+            }
+            if (span >= CLOCK_DRIFT_MAX_SPAN)
+            {
+                referenceTime = time;
+                referenceLocal = local;
+            }
+        }
+    }
+    else
+    {
+        referenceTime = time;
+        referenceLocal = local;
+    }
+    anchorTime = time;
+    anchorLocal = local;
+    synced = true;
+}
+
+/**
+ * @brief  Check if the clock was synchronized
+ * @retval true if the clock has the time, false otherwise
+ */
+bool Clock_isSynced()
+{
+    return synced;
+}
+
+/**
+ * @brief  Get the current time, never earlier than a time returned before
+ * @retval Unix time in ms, 0 if the clock was not synchronized
+ */
+uint64_t Clock_now()
+{
+    uint32_t local = millis();
+
+    if (!synced)
+    {
+        return 0;
+    }
+    if ((uint32_t)(local - anchorLocal) >= CLOCK_REBASE_INTERVAL)
+    {
+        /*Keep the distance to the anchor far from the millis() wrap around*/
+        anchorTime = Clock_fromLocal(local);
+        anchorLocal = local;
+    }
+    uint64_t time = Clock_fromLocal(local);
+    if (time > lastTime)
+    {
+        lastTime = time;
+    }
+    return lastTime;
+}
+
+/**
+ * @brief  Convert a millis() value taken in the last days to Unix time, e.g.
+ *         to timestamp a sample when it is published
+ * @param  local millis() value
+ * @retval Unix time in ms, 0 if the clock was not synchronized
+ */
+uint64_t Clock_fromLocal(uint32_t local)
+{
+    if (!synced)
+    {
+        return 0;
+    }
+    int32_t elapsed = (int32_t)(local - anchorLocal);
+    return anchorTime + elapsed + ((int64_t)elapsed * drift) / 1000000;
+}
+
+/**
+ * @brief  Get the measured drift of millis() against the reference
+ * @retval Drift in ppm, positive if millis() runs slow
+ */
+int32_t Clock_getDrift()
+{
+    return drift;
+}
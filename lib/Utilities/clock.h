@@ -0,0 +1,66 @@
+/**
+ * \file
+ * \brief Monotonic wall clock for the WE IoT design kit.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Unix time in ms without talking to the Wi-Fi module. The clock is anchored
+ * to millis() whenever a time read from the module is passed to Clock_sync.
+ * Between two synchronizations the drift of the local oscillator against the
+ * module time is estimated and corrected. The time returned by Clock_now never
+ * goes backwards, a correction to an earlier time holds the clock instead.
+ */
+
+/* Shortest time between the synchronizations the drift is estimated from */
+#ifndef CLOCK_DRIFT_MIN_SPAN
+#define CLOCK_DRIFT_MIN_SPAN (6UL * 3600UL * 1000UL) /* ms */
+#endif
+/* Longest span, keeps it clear of the millis() wrap around */
+#define CLOCK_DRIFT_MAX_SPAN (20UL * 24UL * 3600UL * 1000UL) /* ms */
+/* Larger deviations are taken as a step of the reference time, not as drift */
+#ifndef CLOCK_MAX_DRIFT_PPM
+#define CLOCK_MAX_DRIFT_PPM 500
+#endif
+/* The anchor is moved forward after this time without a synchronization */
+#define CLOCK_REBASE_INTERVAL (24UL * 3600UL * 1000UL) /* ms */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    void Clock_sync(uint64_t time, uint32_t local);
+    bool Clock_isSynced();
+    uint64_t Clock_now();
+    uint64_t Clock_fromLocal(uint32_t local);
+    int32_t Clock_getDrift();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLOCK_H */
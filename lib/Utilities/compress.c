@@ -0,0 +1,246 @@
+/**
+ * \file
+ * \brief Lightweight payload compression for the WE IoT design kit.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#include <string.h>
+
+#include "compress.h"
+
+/* Preset dictionary with the keys of the telemetry messages.
+ * Changing it requires a new COMPRESS_FORMAT_VERSION. */
+static const char compressDictionary[] =
+    "{\"pressure\":\"humidity\":\"temperature\":\"acceleration\":{\"x\":\"y\":\"z\":}}";
+
+#define COMPRESS_DICTIONARY_LENGTH (sizeof(compressDictionary) - 1)
+
+/**
+ * @brief  Get a byte of the dictionary followed by the data
+ * @param  data Pointer to the data
+ * @param  index Index into dictionary and data
+ * @retval byte at index
+ */
+static inline uint8_t Compress_byteAt(const uint8_t *data, uint16_t index)
+{
+    if (index < COMPRESS_DICTIONARY_LENGTH)
+    {
+        return (uint8_t)compressDictionary[index];
+    }
+    return data[index - COMPRESS_DICTIONARY_LENGTH];
+}
+
+/**
+ * @brief  Compress data
+ * @param  in Pointer to the data to compress
+ * @param  inLength Length of the data
+ * @param  out Pointer to the output buffer
+ * @param  outSize Size of the output buffer, COMPRESS_BOUND(inLength) always fits
+ * @param  outLength Length of the compressed data
+ * @retval true if successful false in case of failure
+ */
+bool Compress_encode(const uint8_t *in, uint16_t inLength, uint8_t *out,
+                     uint16_t outSize, uint16_t *outLength)
+{
+    uint16_t inPos = 0;
+    uint16_t outPos = COMPRESS_HEADER_SIZE;
+    uint16_t flagPos = 0;
+    uint8_t flagBit = 8;
+
+    if ((in == NULL) || (out == NULL) || (outSize < COMPRESS_HEADER_SIZE))
+    {
+        return false;
+    }
+
+    out[0] = COMPRESS_MAGIC;
+    out[1] = COMPRESS_FORMAT_VERSION;
+    out[2] = (uint8_t)(inLength & 0xFF);
+    out[3] = (uint8_t)(inLength >> 8);
+
+    while (inPos < inLength)
+    {
+        uint16_t current = COMPRESS_DICTIONARY_LENGTH + inPos;
+        uint16_t windowStart = 0;
+        uint16_t bestLength = 0;
+        uint16_t bestDistance = 0;
+        uint16_t maxLength = inLength - inPos;
+
+        if (flagBit == 8)
+        {
+            if (outPos >= outSize)
+            {
+                return false;
+            }
+            flagPos = outPos++;
+            out[flagPos] = 0;
+            flagBit = 0;
+        }
+
+        if (maxLength > COMPRESS_MAX_MATCH)
+        {
+            maxLength = COMPRESS_MAX_MATCH;
+        }
+        if (current > COMPRESS_WINDOW_SIZE)
+        {
+            windowStart = current - COMPRESS_WINDOW_SIZE;
+        }
+
+        /* Brute force search, telemetry messages are short */
+        for (uint16_t candidate = windowStart; candidate < current; candidate++)
+        {
+            uint16_t length = 0;
+            while ((length < maxLength) &&
+                   (Compress_byteAt(in, candidate + length) == in[inPos + length]))
+            {
+                length++;
+            }
+            if (length > bestLength)
+            {
+                bestLength = length;
+                bestDistance = current - candidate;
+                if (length == maxLength)
+                {
+                    break;
+                }
+            }
+        }
+
+        if (bestLength >= COMPRESS_MIN_MATCH)
+        {
+            if ((outPos + 2) > outSize)
+            {
+                return false;
+            }
+            out[outPos++] = (uint8_t)((bestDistance - 1) & 0xFF);
+            out[outPos++] = (uint8_t)((((bestDistance - 1) >> 8) << 5) |
+                                      (bestLength - COMPRESS_MIN_MATCH));
+            inPos += bestLength;
+        }
+        else
+        {
+            if (outPos >= outSize)
+            {
+                return false;
+            }
+            out[flagPos] |= (uint8_t)(1 << flagBit);
+            out[outPos++] = in[inPos++];
+        }
+        flagBit++;
+    }
+
+    *outLength = outPos;
+    return true;
+}
+
+/**
+ * @brief  Decompress data produced by Compress_encode
+ * @param  in Pointer to the compressed data
+ * @param  inLength Length of the compressed data
+ * @param  out Pointer to the output buffer
+ * @param  outSize Size of the output buffer
+ * @param  outLength Length of the decompressed data
+ * @retval true if successful false in case of failure
+ */
+bool Compress_decode(const uint8_t *in, uint16_t inLength, uint8_t *out,
+                     uint16_t outSize, uint16_t *outLength)
+{
+    uint16_t inPos = COMPRESS_HEADER_SIZE;
+    uint16_t outPos = 0;
+    uint16_t expectedLength;
+    uint8_t flags = 0;
+    uint8_t flagBit = 8;
+
+    if (!Compress_isCompressed(in, inLength) ||
+        (in[1] != COMPRESS_FORMAT_VERSION))
+    {
+        return false;
+    }
+    expectedLength = (uint16_t)(in[2] | (in[3] << 8));
+    if (expectedLength > outSize)
+    {
+        return false;
+    }
+
+    while (outPos < expectedLength)
+    {
+        if (flagBit == 8)
+        {
+            if (inPos >= inLength)
+            {
+                return false;
+            }
+            flags = in[inPos++];
+            flagBit = 0;
+        }
+
+        if (flags & (1 << flagBit))
+        {
+            if (inPos >= inLength)
+            {
+                return false;
+            }
+            out[outPos++] = in[inPos++];
+        }
+        else
+        {
+            uint16_t distance;
+            uint16_t length;
+            uint16_t source;
+
+            if ((inPos + 2) > inLength)
+            {
+                return false;
+            }
+            distance = (uint16_t)(in[inPos] | ((in[inPos + 1] >> 5) << 8)) + 1;
+            length = (uint16_t)(in[inPos + 1] & 0x1F) + COMPRESS_MIN_MATCH;
+            inPos += 2;
+
+            if ((distance > (COMPRESS_DICTIONARY_LENGTH + outPos)) ||
+                ((outPos + length) > expectedLength))
+            {
+                return false;
+            }
+            /* Byte wise copy, source and destination may overlap */
+            source = COMPRESS_DICTIONARY_LENGTH + outPos - distance;
+            for (uint16_t i = 0; i < length; i++)
+            {
+                out[outPos] = Compress_byteAt(out, source + i);
+                outPos++;
+            }
+        }
+        flagBit++;
+    }
+
+    *outLength = outPos;
+    return true;
+}
+
+/**
+ * @brief  Check whether a payload carries the compressed envelope
+ * @param  in Pointer to the payload
+ * @param  inLength Length of the payload
+ * @retval true if compressed, false if plain data
+ */
+bool Compress_isCompressed(const uint8_t *in, uint16_t inLength)
+{
+    return ((in != NULL) && (inLength >= COMPRESS_HEADER_SIZE) &&
+            (in[0] == COMPRESS_MAGIC));
+}
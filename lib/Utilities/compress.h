@@ -0,0 +1,73 @@
+/**
+ * \file
+ * \brief Lightweight payload compression for the WE IoT design kit.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#ifndef COMPRESS_H
+#define COMPRESS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Compressed payload format
+ *
+ * byte 0     COMPRESS_MAGIC, tells consumers the payload is not plain JSON
+ * byte 1     COMPRESS_FORMAT_VERSION, selects the preset dictionary
+ * byte 2..3  Uncompressed length, little endian
+ * byte 4..   LZSS token stream
+ *
+ * The token stream is a sequence of groups, each led by a flag byte whose
+ * bits (LSB first) describe the following eight tokens:
+ *   1 - literal, one byte copied as is
+ *   0 - match, two bytes: b0 = (distance - 1) & 0xFF,
+ *       b1 = ((distance - 1) >> 8) << 5 | (length - COMPRESS_MIN_MATCH)
+ * Distances reach back into the preset dictionary, which is logically
+ * placed in front of the payload.
+ */
+#define COMPRESS_MAGIC 0xC7
+#define COMPRESS_FORMAT_VERSION 1
+#define COMPRESS_HEADER_SIZE 4
+
+#define COMPRESS_WINDOW_SIZE 2048
+#define COMPRESS_MIN_MATCH 3
+#define COMPRESS_MAX_MATCH (COMPRESS_MIN_MATCH + 31)
+
+/* Worst case size of the compressed data for n input bytes */
+#define COMPRESS_BOUND(n) (COMPRESS_HEADER_SIZE + (n) + ((n) + 7) / 8)
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    bool Compress_encode(const uint8_t *in, uint16_t inLength, uint8_t *out,
+                         uint16_t outSize, uint16_t *outLength);
+    bool Compress_decode(const uint8_t *in, uint16_t inLength, uint8_t *out,
+                         uint16_t outSize, uint16_t *outLength);
+    bool Compress_isCompressed(const uint8_t *in, uint16_t inLength);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* COMPRESS_H */
@@ -0,0 +1,318 @@
+/**
+ * \file
+ * \brief Declarative binding of the configuration file for the WE IoT design kit.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "configSchema.h"
+
+static const char *const statusNames[] = {"missing", "wrong type", "too long", "out of range"};
+
+static bool ConfigSchema_bindObject(const ConfigSchema_entry_t *schema, uint8_t count,
+                                    const json_value *object, void *const *bases,
+                                    ConfigSchema_result_t *result);
+static void ConfigSchema_addError(ConfigSchema_result_t *result, const char *key,
+                                  ConfigSchema_status_t status);
+static void ConfigSchema_store(const ConfigSchema_entry_t *entry, const json_value *value,
+                               void *const *bases, ConfigSchema_result_t *result);
+static void ConfigSchema_storeUnsigned(uint8_t *destination, uint16_t size, uint32_t value);
+static void ConfigSchema_storeDefault(const ConfigSchema_entry_t *entry, void *const *bases);
+
+/**
+ * @brief  Bind the members of a configuration object to their destinations
+ * @param  schema Pointer to the schema entries
+ * @param  count Number of entries, at most CONFIG_SCHEMA_MAX_ENTRIES
+ * @param  configuration Configuration object
+ * @param  bases Destination structures, indexed by the base of the entries,
+ *         NULL only checks the configuration
+ * @param  result Pointer to the result, receives all errors
+ * @retval true if every member was bound, false otherwise
+ */
+bool ConfigSchema_bind(const ConfigSchema_entry_t *schema, uint8_t count,
+                       const json_value *configuration, void *const *bases,
+                       ConfigSchema_result_t *result)
+{
+    result->errorCount = 0;
+    if ((configuration == NULL) || (configuration->type != json_object))
+    {
+        return false;
+    }
+    return ConfigSchema_bindObject(schema, count, configuration, bases, result);
+}
+
+/**
+ * @brief  Bind the members of an object, errors are added to the result
+ * @param  schema Pointer to the schema entries
+ * @param  count Number of entries, at most CONFIG_SCHEMA_MAX_ENTRIES
+ * @param  object JSON object
+ * @param  bases Destination structures or NULL
+ * @param  result Pointer to the result
+ * @retval true if no error was added, false otherwise
+ */
+static bool ConfigSchema_bindObject(const ConfigSchema_entry_t *schema, uint8_t count,
+                                    const json_value *object, void *const *bases,
+                                    ConfigSchema_result_t *result)
+{
+    uint8_t errorCount = result->errorCount;
+    uint32_t bound = 0;
+
+    if (count > CONFIG_SCHEMA_MAX_ENTRIES)
+    {
+        return false;
+    }
+
+    for (unsigned int i = 0; i < object->u.object.length; i++)
+    {
+        const json_object_entry *member = &object->u.object.values[i];
+        for (uint8_t e = 0; e < count; e++)
+        {
+            if (!(bound & ((uint32_t)1 << e)) && (strcmp(member->name, schema[e].key) == 0))
+            {
+                ConfigSchema_store(&schema[e], member->value, bases, result);
+                bound |= (uint32_t)1 << e;
+                break;
+            }
+        }
+    }
+
+    for (uint8_t e = 0; e < count; e++)
+    {
+        const ConfigSchema_entry_t *entry = &schema[e];
+        if (bound & ((uint32_t)1 << e))
+        {
+            continue;
+        }
+        /*Positions only apply to files without any of the keys, in others
+        the member is missing*/
+        if ((bound == 0) && (entry->position >= 0) &&
+            ((unsigned int)entry->position < object->u.object.length))
+        {
+            ConfigSchema_store(entry, object->u.object.values[entry->position].value,
+                               bases, result);
+        }
+        else if (entry->required)
+        {
+            ConfigSchema_addError(result, entry->key, ConfigSchema_Missing);
+        }
+        else
+        {
+            ConfigSchema_storeDefault(entry, bases);
+        }
+    }
+    return result->errorCount == errorCount;
+}
+
+/**
+ * @brief  Get the description of an error
+ * @param  status Error
+ * @retval Description
+ */
+const char *ConfigSchema_getStatusName(ConfigSchema_status_t status)
+{
+    return statusNames[status];
+}
+
+/**
+ * @brief  Record an error, errors beyond CONFIG_SCHEMA_MAX_ERRORS are only
+ *         counted
+ * @param  result Pointer to the result
+ * @param  key Key of the member
+ * @param  status Error
+ * @retval None
+ */
+static void ConfigSchema_addError(ConfigSchema_result_t *result, const char *key,
+                                  ConfigSchema_status_t status)
+{
+    if (result->errorCount < CONFIG_SCHEMA_MAX_ERRORS)
+    {
+        result->errors[result->errorCount].key = key;
+        result->errors[result->errorCount].status = status;
+    }
+    if (result->errorCount < UINT8_MAX)
+    {
+        result->errorCount++;
+    }
+}
+
+/**
+ * @brief  Check a value and copy it to the destination of an entry
+ * @param  entry Pointer to the entry
+ * @param  value Value of the member
+ * @param  bases Destination structures, NULL to only check the value
+ * @param  result Pointer to the result
+ * @retval None
+ */
+static void ConfigSchema_store(const ConfigSchema_entry_t *entry, const json_value *value,
+                               void *const *bases, ConfigSchema_result_t *result)
+{
+    uint8_t *destination = (bases != NULL) ? ((uint8_t *)bases[entry->base] + entry->offset) : NULL;
+
+    switch (entry->type)
+    {
+    case ConfigSchema_String:
+        if (value->type != json_string)
+        {
+            ConfigSchema_addError(result, entry->key, ConfigSchema_WrongType);
+        }
+        else if (value->u.string.length >= entry->size)
+        {
+            ConfigSchema_addError(result, entry->key, ConfigSchema_TooLong);
+        }
+        else if (destination != NULL)
+        {
+            memcpy(destination, value->u.string.ptr, value->u.string.length + 1);
+        }
+        break;
+
+    case ConfigSchema_Unsigned:
+    {
+        uint32_t max = (entry->size >= sizeof(uint32_t)) ? UINT32_MAX
+                                                         : (((uint32_t)1 << (8 * entry->size)) - 1);
+        if (value->type != json_integer)
+        {
+            ConfigSchema_addError(result, entry->key, ConfigSchema_WrongType);
+        }
+        else if ((value->u.integer < 0) || ((uint64_t)value->u.integer > max))
+        {
+            ConfigSchema_addError(result, entry->key, ConfigSchema_OutOfRange);
+        }
+        else if (destination != NULL)
+        {
+            ConfigSchema_storeUnsigned(destination, entry->size, (uint32_t)value->u.integer);
+        }
+        break;
+    }
+
+    case ConfigSchema_Float:
+    {
+        float number;
+        if (value->type == json_integer)
+        {
+            number = (float)value->u.integer;
+        }
+        else if (value->type == json_double)
+        {
+            number = (float)value->u.dbl;
+        }
+        else
+        {
+            ConfigSchema_addError(result, entry->key, ConfigSchema_WrongType);
+            break;
+        }
+        if (destination != NULL)
+        {
+            memcpy(destination, &number, sizeof(number));
+        }
+        break;
+    }
+
+    case ConfigSchema_Object:
+    {
+        void *objectBases[] = {destination};
+        if (value->type != json_object)
+        {
+            ConfigSchema_addError(result, entry->key, ConfigSchema_WrongType);
+            break;
+        }
+        ConfigSchema_bindObject(entry->members, entry->memberCount, value,
+                                (destination != NULL) ? objectBases : NULL, result);
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief  Store an unsigned value with the width of the destination
+ * @param  destination Pointer to the destination, may be unaligned
+ * @param  size Size of the destination in bytes
+ * @param  value Value in the range of the destination
+ * @retval None
+ */
+static void ConfigSchema_storeUnsigned(uint8_t *destination, uint16_t size, uint32_t value)
+{
+    if (size == sizeof(uint8_t))
+    {
+        uint8_t narrow = (uint8_t)value;
+        memcpy(destination, &narrow, sizeof(narrow));
+    }
+    else if (size == sizeof(uint16_t))
+    {
+        uint16_t narrow = (uint16_t)value;
+        memcpy(destination, &narrow, sizeof(narrow));
+    }
+    else
+    {
+        memcpy(destination, &value, sizeof(value));
+    }
+}
+
+/**
+ * @brief  Store the default of an optional entry that is not in the file
+ * @param  entry Pointer to the entry
+ * @param  bases Destination structures, NULL to skip the default
+ * @retval None
+ */
+static void ConfigSchema_storeDefault(const ConfigSchema_entry_t *entry, void *const *bases)
+{
+    uint8_t *destination;
+
+    if (bases == NULL)
+    {
+        return;
+    }
+    destination = (uint8_t *)bases[entry->base] + entry->offset;
+
+    switch (entry->type)
+    {
+    case ConfigSchema_String:
+        if ((entry->defaultString != NULL) && (strlen(entry->defaultString) < entry->size))
+        {
+            strcpy((char *)destination, entry->defaultString);
+        }
+        break;
+
+    case ConfigSchema_Unsigned:
+        if (!isnan(entry->defaultNumber))
+        {
+            ConfigSchema_storeUnsigned(destination, entry->size, (uint32_t)entry->defaultNumber);
+        }
+        break;
+
+    case ConfigSchema_Float:
+    {
+        float number = (float)entry->defaultNumber;
+        if (!isnan(entry->defaultNumber))
+        {
+            memcpy(destination, &number, sizeof(number));
+        }
+        break;
+    }
+
+    default:
+        break;
+    }
+}
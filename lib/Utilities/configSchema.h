@@ -0,0 +1,146 @@
+/**
+ * \file
+ * \brief Declarative binding of the configuration file for the WE IoT design kit.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+#ifndef CONFIG_SCHEMA_H
+#define CONFIG_SCHEMA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "json.h"
+
+/*
+ * A schema is a table of the members of a configuration object. Each entry
+ * names the key, the type and the destination of a member, the destination
+ * is an offset into one of several structures passed to ConfigSchema_bind.
+ * The members are matched by key in a single pass over the object. Files
+ * written before the members were looked up by key match none of the keys,
+ * only such files are bound by the position of the entries. Missing optional
+ * members get their default, all problems are collected in the result
+ * instead of stopping at the first one. Without destinations the
+ * configuration is only checked.
+ *
+ * A nested object is bound with the schema of its members, whose offsets are
+ * relative to the destination of the object and whose base is 0. A missing
+ * optional object leaves its members unchanged.
+ */
+#define CONFIG_SCHEMA_MAX_ENTRIES 32
+#define CONFIG_SCHEMA_MAX_ERRORS 8
+#define CONFIG_SCHEMA_NO_POSITION -1
+/* Default of a number that leaves the destination unchanged */
+#define CONFIG_SCHEMA_UNCHANGED NAN
+
+#define CONFIG_SCHEMA_MEMBER(type, member) \
+    (uint16_t)offsetof(type, member), (uint16_t)sizeof(((type *)0)->member)
+
+/* String member, a NULL default leaves the destination unchanged */
+#define CONFIG_STRING(key, position, required, base, type, member, defaultValue)       \
+    {                                                                                  \
+        (key), ConfigSchema_String, (base), (position), (required),                    \
+            CONFIG_SCHEMA_MEMBER(type, member), (defaultValue), 0                      \
+    }
+/* String stored in a character array of the given size at the base */
+#define CONFIG_BUFFER(key, position, required, base, size)                             \
+    {                                                                                  \
+        (key), ConfigSchema_String, (base), (position), (required), 0, (size), NULL, 0 \
+    }
+/* Unsigned integer member of 1, 2 or 4 bytes, also enumerations */
+#define CONFIG_UNSIGNED(key, position, required, base, type, member, defaultValue)     \
+    {                                                                                  \
+        (key), ConfigSchema_Unsigned, (base), (position), (required),                  \
+            CONFIG_SCHEMA_MEMBER(type, member), NULL, (defaultValue)                   \
+    }
+/* Float member, accepts integers too */
+#define CONFIG_FLOAT(key, position, required, base, type, member, defaultValue)        \
+    {                                                                                  \
+        (key), ConfigSchema_Float, (base), (position), (required),                     \
+            CONFIG_SCHEMA_MEMBER(type, member), NULL, (defaultValue)                   \
+    }
+/* Object member bound with the schema array members */
+#define CONFIG_OBJECT(key, position, required, base, type, member, members)            \
+    {                                                                                  \
+        (key), ConfigSchema_Object, (base), (position), (required),                    \
+            CONFIG_SCHEMA_MEMBER(type, member), NULL, 0, (members),                    \
+            (uint8_t)(sizeof(members) / sizeof((members)[0]))                          \
+    }
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    typedef enum
+    {
+        ConfigSchema_String,
+        ConfigSchema_Unsigned,
+        ConfigSchema_Float,
+        ConfigSchema_Object
+    } ConfigSchema_type_t;
+
+    typedef enum
+    {
+        ConfigSchema_Missing,
+        ConfigSchema_WrongType,
+        ConfigSchema_TooLong,
+        ConfigSchema_OutOfRange
+    } ConfigSchema_status_t;
+
+    typedef struct ConfigSchema_entry_t
+    {
+        const char *key;
+        ConfigSchema_type_t type;
+        uint8_t base;      /* index of the destination structure */
+        int8_t position;   /* member index in files without the key */
+        bool required;
+        uint16_t offset;   /* in the destination structure */
+        uint16_t size;     /* of the destination, strings include the terminator */
+        const char *defaultString;
+        double defaultNumber;
+        const struct ConfigSchema_entry_t *members; /* of an object */
+        uint8_t memberCount;
+    } ConfigSchema_entry_t;
+
+    typedef struct
+    {
+        const char *key;
+        ConfigSchema_status_t status;
+    } ConfigSchema_error_t;
+
+    typedef struct
+    {
+        uint8_t errorCount; /* may exceed CONFIG_SCHEMA_MAX_ERRORS */
+        ConfigSchema_error_t errors[CONFIG_SCHEMA_MAX_ERRORS];
+    } ConfigSchema_result_t;
+
+    bool ConfigSchema_bind(const ConfigSchema_entry_t *schema, uint8_t count,
+                           const json_value *configuration, void *const *bases,
+                           ConfigSchema_result_t *result);
+    const char *ConfigSchema_getStatusName(ConfigSchema_status_t status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_SCHEMA_H */
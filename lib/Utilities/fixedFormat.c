@@ -0,0 +1,133 @@
+/**
+ * \file
+ * \brief Fixed precision formatting of floating point values.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#include <math.h>
+#include <stdbool.h>
+
+#include "fixedFormat.h"
+
+static const uint32_t FixedFormat_scale[FIXEDFORMAT_MAX_DECIMALS + 1] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000};
+
+/**
+ * @brief  Format a value with a fixed number of decimals, like "%.*f"
+ * @param  buffer Output buffer
+ * @param  size Size of the buffer, FIXEDFORMAT_BUFFER_SIZE fits every value
+ * @param  value Value to format
+ * @param  decimals Number of decimals, at most FIXEDFORMAT_MAX_DECIMALS
+ * @retval Length of the NUL terminated text, 0 for values that are not finite
+ *         or do not fit
+ */
+size_t FixedFormat_float(char *buffer, size_t size, float value, uint8_t decimals)
+{
+    char digits[FIXEDFORMAT_MAX_INTEGER_DIGITS + FIXEDFORMAT_MAX_DECIMALS];
+    uint8_t count = 0;
+    size_t length = 0;
+    float magnitude = fabsf(value);
+    uint32_t fraction;
+
+    if (size == 0)
+    {
+        return 0;
+    }
+    buffer[0] = '\0';
+    if (decimals > FIXEDFORMAT_MAX_DECIMALS)
+    {
+        decimals = FIXEDFORMAT_MAX_DECIMALS;
+    }
+    /*Also rejects NaN, which fails every comparison*/
+    if (!(magnitude < 18446744073709551616.0f))
+    {
+        return 0;
+    }
+
+    /*The integer and fractional parts are converted separately, scaling the
+    whole value would lose digits of large values to the float precision*/
+    if (magnitude < 4294967296.0f)
+    {
+        uint32_t integer = (uint32_t)magnitude;
+        fraction = (uint32_t)((magnitude - (float)integer) * (float)FixedFormat_scale[decimals] + 0.5f);
+        if (fraction >= FixedFormat_scale[decimals])
+        {
+            fraction -= FixedFormat_scale[decimals];
+            integer++;
+        }
+        for (uint8_t i = 0; i < decimals; i++)
+        {
+            digits[count++] = (char)('0' + (fraction % 10));
+            fraction /= 10;
+        }
+        do
+        {
+            digits[count++] = (char)('0' + (integer % 10));
+            integer /= 10;
+        } while (integer > 0);
+    }
+    else
+    {
+        /*Floats of this size have no fractional part*/
+        uint64_t integer = (uint64_t)magnitude;
+        for (uint8_t i = 0; i < decimals; i++)
+        {
+            digits[count++] = '0';
+        }
+        do
+        {
+            digits[count++] = (char)('0' + (integer % 10));
+            integer /= 10;
+        } while (integer > 0);
+    }
+
+    /*No sign if the value rounds to zero*/
+    bool negative = false;
+    if (value < 0)
+    {
+        for (uint8_t i = 0; i < count; i++)
+        {
+            if (digits[i] != '0')
+            {
+                negative = true;
+                break;
+            }
+        }
+    }
+    if (((size_t)negative + count + (decimals > 0 ? 1 : 0) + 1) > size)
+    {
+        return 0;
+    }
+    if (negative)
+    {
+        buffer[length++] = '-';
+    }
+    while (count > 0)
+    {
+        if (count == decimals)
+        {
+            buffer[length++] = '.';
+        }
+        buffer[length++] = digits[--count];
+    }
+    buffer[length] = '\0';
+    return length;
+}
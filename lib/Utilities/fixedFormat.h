@@ -0,0 +1,55 @@
+/**
+ * \file
+ * \brief Fixed precision formatting of floating point values.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#ifndef FIXEDFORMAT_H
+#define FIXEDFORMAT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * The integer part and the fraction scaled by 10^decimals are converted to
+ * integers and printed with the decimal point in between. This replaces
+ * "%.*f" without linking the floating point support of printf, which is
+ * large and slow on a Cortex-M0+ without FPU. Unlike printf, halves are
+ * rounded away from zero and values that round to zero have no sign.
+ */
+#define FIXEDFORMAT_MAX_DECIMALS 6
+/* Integer digits of the largest value that can be formatted, below 2^64 */
+#define FIXEDFORMAT_MAX_INTEGER_DIGITS 20
+/* Sign, integer digits, decimal point, decimals and terminator */
+#define FIXEDFORMAT_BUFFER_SIZE (1 + FIXEDFORMAT_MAX_INTEGER_DIGITS + 1 + FIXEDFORMAT_MAX_DECIMALS + 1)
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    size_t FixedFormat_float(char *buffer, size_t size, float value, uint8_t decimals);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FIXEDFORMAT_H */
@@ -0,0 +1,54 @@
+/**
+ * \file
+ * \brief Header of an AT event line with a fixed number of arguments.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+#include "headerScanner.h"
+
+/**
+ * @brief  Start a new line
+ * @param  scanner Pointer to the scanner
+ * @param  delimiter Delimiter of the arguments
+ * @param  arguments Number of delimiters up to the end of the header
+ * @retval None
+ */
+void HeaderScanner_init(HeaderScanner_t *scanner, char delimiter, uint8_t arguments)
+{
+    scanner->delimiter = delimiter;
+    scanner->arguments = arguments;
+    scanner->count = 0;
+}
+
+/**
+ * @brief  Pass the next byte of the line
+ * @param  scanner Pointer to the scanner
+ * @param  byte Received byte
+ * @retval true for the delimiter that ends the header, once per line
+ */
+bool HeaderScanner_push(HeaderScanner_t *scanner, char byte)
+{
+    if ((byte != scanner->delimiter) || (scanner->count >= scanner->arguments))
+    {
+        return false;
+    }
+    scanner->count++;
+    return scanner->count == scanner->arguments;
+}
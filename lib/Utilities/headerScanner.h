@@ -0,0 +1,56 @@
+/**
+ * \file
+ * \brief Header of an AT event line with a fixed number of arguments.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+#ifndef HEADER_SCANNER_H
+#define HEADER_SCANNER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Finds the end of the header of a line while the line is received, e.g. the
+ * arguments of +eventmqtt:recv in front of the payload. The delimiters are
+ * counted up to the end of the header only, the payload may contain any
+ * number of them.
+ */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    typedef struct
+    {
+        char delimiter;
+        uint8_t arguments; /* delimiters up to the end of the header */
+        uint8_t count;     /* delimiters seen, stops at arguments */
+    } HeaderScanner_t;
+
+    void HeaderScanner_init(HeaderScanner_t *scanner, char delimiter, uint8_t arguments);
+    bool HeaderScanner_push(HeaderScanner_t *scanner, char byte);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HEADER_SCANNER_H */
@@ -28,6 +28,7 @@
  * SUCH DAMAGE.
  */
 
+#include <math.h>
 #include <string.h>
 #include <assert.h>
 #include <stdio.h>
@@ -262,6 +263,7 @@ json_value *json_object_push_nocopy(json_value *object,
     entry = object->u.object.values + object->u.object.length;
 
     entry->name_length = name_length;
+    entry->name_hash = json_key_hash(name, name_length);
     entry->name = name;
     entry->value = value;
 
@@ -688,6 +690,12 @@ size_t json_measure_ex(json_value *value, json_serialize_opts opts)
 
         case json_double:
 
+            if (!isfinite(value->u.dbl))
+            {
+                total += 4; /* `null` */
+                break;
+            }
+
             total += snprintf(NULL, 0, "%g", value->u.dbl);
 
             /* Because sometimes we need to add ".0" if sprintf does not do it
@@ -919,6 +927,13 @@ void json_serialize_ex(json_char *buf, json_value *value,
 
         case json_double:
 
+            /* JSON has no representation for infinity and NaN */
+            if (!isfinite(value->u.dbl))
+            {
+                buf += sprintf(buf, "null");
+                break;
+            }
+
             ptr = buf;
 
             buf += sprintf(buf, "%g", value->u.dbl);
@@ -39,9 +39,9 @@
 const struct _json_value json_value_none;
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
-#include <math.h>
 
 typedef unsigned int json_uchar;
 
@@ -85,6 +85,182 @@ static int would_overflow(json_int_t value, json_char b) {
     return ((JSON_INT_MAX - (b - '0')) / 10) < value;
 }
 
+/* Scanners shared by json_parse_ex and json_parse_sax. They read from ptr up
+ * to end and never past it. */
+
+/* Length of literal if the input starts with it, 0 otherwise */
+static size_t json_match_literal(const json_char *ptr, const json_char *end,
+                                 const char *literal) {
+    size_t length = strlen(literal);
+
+    if ((size_t)(end - ptr) < length || memcmp(ptr, literal, length) != 0)
+        return 0;
+
+    return length;
+}
+
+/* Decodes the escape sequence after a backslash, *ptr is moved past it */
+static int json_scan_escape(const json_char **ptr, const json_char *end,
+                            json_uchar *uchar) {
+    const json_char *p = *ptr;
+    json_uchar uchar2;
+    unsigned char digit;
+
+    if (p == end)
+        return 0;
+
+    switch (*p++) {
+    case 'b':
+        *uchar = '\b';
+        break;
+    case 'f':
+        *uchar = '\f';
+        break;
+    case 'n':
+        *uchar = '\n';
+        break;
+    case 'r':
+        *uchar = '\r';
+        break;
+    case 't':
+        *uchar = '\t';
+        break;
+    case 'u':
+        if (end - p < 4)
+            return 0;
+
+        *uchar = 0;
+        for (int i = 0; i < 4; ++i) {
+            if ((digit = hex_value(*p++)) == 0xFF)
+                return 0;
+            *uchar = (*uchar << 4) | digit;
+        }
+
+        if ((*uchar & 0xF800) == 0xD800) {
+            if (end - p < 6 || p[0] != '\\' || p[1] != 'u')
+                return 0;
+
+            p += 2;
+            uchar2 = 0;
+            for (int i = 0; i < 4; ++i) {
+                if ((digit = hex_value(*p++)) == 0xFF)
+                    return 0;
+                uchar2 = (uchar2 << 4) | digit;
+            }
+
+            *uchar = 0x010000 | ((*uchar & 0x3FF) << 10) | (uchar2 & 0x3FF);
+        }
+        break;
+    default:
+        *uchar = (unsigned char)p[-1]; /* \" \\ \/ */
+        break;
+    }
+
+    *ptr = p;
+    return 1;
+}
+
+/* Writes uchar as UTF-8 unless string is NULL, returns the number of bytes */
+static unsigned int json_utf8_encode(json_uchar uchar, json_char *string) {
+    if (uchar <= 0x7F) {
+        if (string)
+            string[0] = (json_char)uchar;
+        return 1;
+    }
+
+    if (uchar <= 0x7FF) {
+        if (string) {
+            string[0] = 0xC0 | (uchar >> 6);
+            string[1] = 0x80 | (uchar & 0x3F);
+        }
+        return 2;
+    }
+
+    if (uchar <= 0xFFFF) {
+        if (string) {
+            string[0] = 0xE0 | (uchar >> 12);
+            string[1] = 0x80 | ((uchar >> 6) & 0x3F);
+            string[2] = 0x80 | (uchar & 0x3F);
+        }
+        return 3;
+    }
+
+    if (string) {
+        string[0] = 0xF0 | (uchar >> 18);
+        string[1] = 0x80 | ((uchar >> 12) & 0x3F);
+        string[2] = 0x80 | ((uchar >> 6) & 0x3F);
+        string[3] = 0x80 | (uchar & 0x3F);
+    }
+    return 4;
+}
+
+/* Scans a number and stores it in value unless value is NULL, *ptr is moved
+ * past it. Returns NULL if successful, the error otherwise. */
+static const char *json_scan_number(const json_char **ptr,
+                                    const json_char *end, json_value *value) {
+    const json_char *p = *ptr;
+    json_int_t integer = 0;
+    int negative = 0, is_double = 0;
+    char number[64];
+
+    if (*p == '-') {
+        negative = 1;
+        ++p;
+    }
+
+    if (p == end || !isdigit((unsigned char)*p))
+        return "Invalid number";
+
+    if (*p == '0') {
+        ++p;
+    } else {
+        while (p != end && isdigit((unsigned char)*p)) {
+            if (would_overflow(integer, *p))
+                is_double = 1;
+            else
+                integer = (integer * 10) + (*p - '0');
+            ++p;
+        }
+    }
+
+    if (p != end && *p == '.') {
+        is_double = 1;
+        ++p;
+        if (p == end || !isdigit((unsigned char)*p))
+            return "Expected digit after `.`";
+        while (p != end && isdigit((unsigned char)*p))
+            ++p;
+    }
+
+    if (p != end && (*p == 'e' || *p == 'E')) {
+        is_double = 1;
+        ++p;
+        if (p != end && (*p == '+' || *p == '-'))
+            ++p;
+        if (p == end || !isdigit((unsigned char)*p))
+            return "Expected digit after `e`";
+        while (p != end && isdigit((unsigned char)*p))
+            ++p;
+    }
+
+    if ((size_t)(p - *ptr) >= sizeof(number))
+        return "Number too long";
+
+    if (value && !is_double) {
+        value->type = json_integer;
+        value->u.integer = negative ? -integer : integer;
+    } else if (value) {
+        /* strtod needs the terminator the input may not have */
+        memcpy(number, *ptr, p - *ptr);
+        number[p - *ptr] = 0;
+        value->type = json_double;
+        value->u.dbl = strtod(number, NULL);
+    }
+
+    *ptr = p;
+    return 0;
+}
+
 typedef struct {
     unsigned long used_memory;
 
@@ -138,6 +314,8 @@ static int new_value(json_state *state, json_value **top, json_value **root,
             if (!(value->u.array.values = (json_value **)json_alloc(
                       state, value->u.array.length * sizeof(json_value *),
                       0))) {
+                /* Leave nothing for json_value_free_ex to walk */
+                value->u.array.length = 0;
                 return 0;
             }
 
@@ -156,6 +334,8 @@ static int new_value(json_state *state, json_value **top, json_value **root,
                       state,
                       values_size + ((unsigned long)value->u.object.values),
                       0))) {
+                value->u.object.values = 0;
+                value->u.object.length = 0;
                 return 0;
             }
 
@@ -170,6 +350,7 @@ static int new_value(json_state *state, json_value **top, json_value **root,
             if (!(value->u.string.ptr = (json_char *)json_alloc(
                       state, (value->u.string.length + 1) * sizeof(json_char),
                       0))) {
+                value->u.string.length = 0;
                 return 0;
             }
 
@@ -224,14 +405,11 @@ static int new_value(json_state *state, json_value **top, json_value **root,
 
 #define line_and_col state.cur_line, state.cur_col
 
-static const long flag_next = 1 << 0, flag_reproc = 1 << 1,
-                  flag_need_comma = 1 << 2, flag_seek_value = 1 << 3,
-                  flag_escaped = 1 << 4, flag_string = 1 << 5,
-                  flag_need_colon = 1 << 6, flag_done = 1 << 7,
-                  flag_num_negative = 1 << 8, flag_num_zero = 1 << 9,
-                  flag_num_e = 1 << 10, flag_num_e_got_sign = 1 << 11,
-                  flag_num_e_negative = 1 << 12, flag_line_comment = 1 << 13,
-                  flag_block_comment = 1 << 14, flag_num_got_decimal = 1 << 15;
+static const long flag_next = 1 << 0, flag_need_comma = 1 << 1,
+                  flag_seek_value = 1 << 2, flag_escaped = 1 << 3,
+                  flag_string = 1 << 4, flag_need_colon = 1 << 5,
+                  flag_done = 1 << 6, flag_line_comment = 1 << 7,
+                  flag_block_comment = 1 << 8;
 
 json_value *json_parse_ex(json_settings *settings, const json_char *json,
                           size_t length, char *error_buf) {
@@ -240,8 +418,6 @@ json_value *json_parse_ex(json_settings *settings, const json_char *json,
     json_value *top, *root, *alloc = 0;
     json_state state = {0};
     long flags = 0;
-    double num_digits = 0, num_e = 0;
-    double num_fraction = 0;
 
     /* Skip UTF-8 BOM
      */
@@ -270,7 +446,6 @@ json_value *json_parse_ex(json_settings *settings, const json_char *json,
 
     for (state.first_pass = 1; state.first_pass >= 0; --state.first_pass) {
         json_uchar uchar;
-        unsigned char uc_b1, uc_b2, uc_b3, uc_b4;
         json_char *string = 0;
         unsigned int string_length = 0;
 
@@ -293,113 +468,20 @@ json_value *json_parse_ex(json_settings *settings, const json_char *json,
                     goto e_overflow;
 
                 if (flags & flag_escaped) {
-                    flags &= ~flag_escaped;
+                    const json_char *escape = state.ptr;
 
-                    switch (b) {
-                    case 'b':
-                        string_add('\b');
-                        break;
-                    case 'f':
-                        string_add('\f');
-                        break;
-                    case 'n':
-                        string_add('\n');
-                        break;
-                    case 'r':
-                        string_add('\r');
-                        break;
-                    case 't':
-                        string_add('\t');
-                        break;
-                    case 'u':
-
-                        if (end - state.ptr <= 4 ||
-                            (uc_b1 = hex_value(*++state.ptr)) == 0xFF ||
-                            (uc_b2 = hex_value(*++state.ptr)) == 0xFF ||
-                            (uc_b3 = hex_value(*++state.ptr)) == 0xFF ||
-                            (uc_b4 = hex_value(*++state.ptr)) == 0xFF) {
-                            sprintf(error,
-                                    "Invalid character value `%c` (at %d:%d)",
-                                    b, line_and_col);
-                            goto e_failed;
-                        }
-
-                        uc_b1 = (uc_b1 << 4) | uc_b2;
-                        uc_b2 = (uc_b3 << 4) | uc_b4;
-                        uchar = (uc_b1 << 8) | uc_b2;
-
-                        if ((uchar & 0xF800) == 0xD800) {
-                            json_uchar uchar2;
-
-                            if (end - state.ptr <= 6 ||
-                                (*++state.ptr) != '\\' ||
-                                (*++state.ptr) != 'u' ||
-                                (uc_b1 = hex_value(*++state.ptr)) == 0xFF ||
-                                (uc_b2 = hex_value(*++state.ptr)) == 0xFF ||
-                                (uc_b3 = hex_value(*++state.ptr)) == 0xFF ||
-                                (uc_b4 = hex_value(*++state.ptr)) == 0xFF) {
-                                sprintf(
-                                    error,
-                                    "Invalid character value `%c` (at %d:%d)",
-                                    b, line_and_col);
-                                goto e_failed;
-                            }
-
-                            uc_b1 = (uc_b1 << 4) | uc_b2;
-                            uc_b2 = (uc_b3 << 4) | uc_b4;
-                            uchar2 = (uc_b1 << 8) | uc_b2;
-
-                            uchar = 0x010000 | ((uchar & 0x3FF) << 10) |
-                                    (uchar2 & 0x3FF);
-                        }
-
-                        if (sizeof(json_char) >= sizeof(json_uchar) ||
-                            (uchar <= 0x7F)) {
-                            string_add((json_char)uchar);
-                            break;
-                        }
-
-                        if (uchar <= 0x7FF) {
-                            if (state.first_pass)
-                                string_length += 2;
-                            else {
-                                string[string_length++] = 0xC0 | (uchar >> 6);
-                                string[string_length++] = 0x80 | (uchar & 0x3F);
-                            }
-
-                            break;
-                        }
-
-                        if (uchar <= 0xFFFF) {
-                            if (state.first_pass)
-                                string_length += 3;
-                            else {
-                                string[string_length++] = 0xE0 | (uchar >> 12);
-                                string[string_length++] =
-                                    0x80 | ((uchar >> 6) & 0x3F);
-                                string[string_length++] = 0x80 | (uchar & 0x3F);
-                            }
-
-                            break;
-                        }
-
-                        if (state.first_pass)
-                            string_length += 4;
-                        else {
-                            string[string_length++] = 0xF0 | (uchar >> 18);
-                            string[string_length++] =
-                                0x80 | ((uchar >> 12) & 0x3F);
-                            string[string_length++] =
-                                0x80 | ((uchar >> 6) & 0x3F);
-                            string[string_length++] = 0x80 | (uchar & 0x3F);
-                        }
-
-                        break;
+                    flags &= ~flag_escaped;
 
-                    default:
-                        string_add(b);
-                    };
+                    if (!json_scan_escape(&escape, end, &uchar)) {
+                        sprintf(error,
+                                "Invalid character value `%c` (at %d:%d)", b,
+                                line_and_col);
+                        goto e_failed;
+                    }
 
+                    state.ptr = escape - 1;
+                    string_length += json_utf8_encode(
+                        uchar, state.first_pass ? 0 : string + string_length);
                     continue;
                 }
 
@@ -435,6 +517,11 @@ json_value *json_parse_ex(json_settings *settings, const json_char *json,
                             top->u.object.values[top->u.object.length]
                                 .name_length = string_length;
 
+                            top->u.object.values[top->u.object.length]
+                                .name_hash = json_key_hash(
+                                    (json_char *)top->_reserved.object_mem,
+                                    string_length);
+
                             (*(json_char **)&top->_reserved.object_mem) +=
                                 string_length + 1;
                         }
@@ -604,10 +691,10 @@ json_value *json_parse_ex(json_settings *settings, const json_char *json,
 
                     case 't':
 
-                        if ((end - state.ptr) < 3 || *(++state.ptr) != 'r' ||
-                            *(++state.ptr) != 'u' || *(++state.ptr) != 'e') {
+                        if (!json_match_literal(state.ptr, end, "true"))
                             goto e_unknown_value;
-                        }
+
+                        state.ptr += 3;
 
                         if (!new_value(&state, &top, &root, &alloc,
                                        json_boolean))
@@ -620,11 +707,10 @@ json_value *json_parse_ex(json_settings *settings, const json_char *json,
 
                     case 'f':
 
-                        if ((end - state.ptr) < 4 || *(++state.ptr) != 'a' ||
-                            *(++state.ptr) != 'l' || *(++state.ptr) != 's' ||
-                            *(++state.ptr) != 'e') {
+                        if (!json_match_literal(state.ptr, end, "false"))
                             goto e_unknown_value;
-                        }
+
+                        state.ptr += 4;
 
                         if (!new_value(&state, &top, &root, &alloc,
                                        json_boolean))
@@ -635,10 +721,10 @@ json_value *json_parse_ex(json_settings *settings, const json_char *json,
 
                     case 'n':
 
-                        if ((end - state.ptr) < 3 || *(++state.ptr) != 'u' ||
-                            *(++state.ptr) != 'l' || *(++state.ptr) != 'l') {
+                        if (!json_match_literal(state.ptr, end, "null"))
                             goto e_unknown_value;
-                        }
+
+                        state.ptr += 3;
 
                         if (!new_value(&state, &top, &root, &alloc, json_null))
                             goto e_alloc_failure;
@@ -649,40 +735,25 @@ json_value *json_parse_ex(json_settings *settings, const json_char *json,
                     default:
 
                         if (isdigit(b) || b == '-') {
+                            const json_char *number = state.ptr;
+                            const char *number_error;
+
                             if (!new_value(&state, &top, &root, &alloc,
                                            json_integer))
                                 goto e_alloc_failure;
 
-                            if (!state.first_pass) {
-                                while (isdigit(b) || b == '+' || b == '-' ||
-                                       b == 'e' || b == 'E' || b == '.') {
-                                    if ((++state.ptr) == end) {
-                                        b = 0;
-                                        break;
-                                    }
-
-                                    b = *state.ptr;
-                                }
-
-                                flags |= flag_next | flag_reproc;
-                                break;
-                            }
-
-                            flags &= ~(flag_num_negative | flag_num_e |
-                                       flag_num_e_got_sign |
-                                       flag_num_e_negative | flag_num_zero);
-
-                            num_digits = 0;
-                            num_fraction = 0;
-                            num_e = 0;
-
-                            if (b != '-') {
-                                flags |= flag_reproc;
-                                break;
+                            /* The second pass keeps the first pass's value */
+                            if ((number_error = json_scan_number(
+                                     &number, end,
+                                     state.first_pass ? top : 0))) {
+                                sprintf(error, "%d:%d: %s", line_and_col,
+                                        number_error);
+                                goto e_failed;
                             }
 
-                            flags |= flag_num_negative;
-                            continue;
+                            state.ptr = number - 1;
+                            flags |= flag_next;
+                            break;
                         } else {
                             sprintf(error,
                                     "%d:%d: Unexpected %c when seeking value",
@@ -734,131 +805,11 @@ json_value *json_parse_ex(json_settings *settings, const json_char *json,
 
                     break;
 
-                case json_integer:
-                case json_double:
-
-                    if (isdigit(b)) {
-                        ++num_digits;
-
-                        if (top->type == json_integer || flags & flag_num_e) {
-                            if (!(flags & flag_num_e)) {
-                                if (flags & flag_num_zero) {
-                                    sprintf(error,
-                                            "%d:%d: Unexpected `0` before `%c`",
-                                            line_and_col, b);
-                                    goto e_failed;
-                                }
-
-                                if (num_digits == 1 && b == '0')
-                                    flags |= flag_num_zero;
-                            } else {
-                                flags |= flag_num_e_got_sign;
-                                num_e = (num_e * 10) + (b - '0');
-                                continue;
-                            }
-
-                            if (would_overflow(top->u.integer, b)) {
-                                --num_digits;
-                                --state.ptr;
-                                top->type = json_double;
-                                top->u.dbl = (double)top->u.integer;
-                                continue;
-                            }
-
-                            top->u.integer = (top->u.integer * 10) + (b - '0');
-                            continue;
-                        }
-
-                        if (flags & flag_num_got_decimal)
-                            num_fraction = (num_fraction * 10) + (b - '0');
-                        else
-                            top->u.dbl = (top->u.dbl * 10) + (b - '0');
-
-                        continue;
-                    }
-
-                    if (b == '+' || b == '-') {
-                        if ((flags & flag_num_e) &&
-                            !(flags & flag_num_e_got_sign)) {
-                            flags |= flag_num_e_got_sign;
-
-                            if (b == '-')
-                                flags |= flag_num_e_negative;
-
-                            continue;
-                        }
-                    } else if (b == '.' && top->type == json_integer) {
-                        if (!num_digits) {
-                            sprintf(error, "%d:%d: Expected digit before `.`",
-                                    line_and_col);
-                            goto e_failed;
-                        }
-
-                        top->type = json_double;
-                        top->u.dbl = (double)top->u.integer;
-
-                        flags |= flag_num_got_decimal;
-                        num_digits = 0;
-                        continue;
-                    }
-
-                    if (!(flags & flag_num_e)) {
-                        if (top->type == json_double) {
-                            if (!num_digits) {
-                                sprintf(error,
-                                        "%d:%d: Expected digit after `.`",
-                                        line_and_col);
-                                goto e_failed;
-                            }
-
-                            top->u.dbl += num_fraction / pow(10.0, num_digits);
-                        }
-
-                        if (b == 'e' || b == 'E') {
-                            flags |= flag_num_e;
-
-                            if (top->type == json_integer) {
-                                top->type = json_double;
-                                top->u.dbl = (double)top->u.integer;
-                            }
-
-                            num_digits = 0;
-                            flags &= ~flag_num_zero;
-
-                            continue;
-                        }
-                    } else {
-                        if (!num_digits) {
-                            sprintf(error, "%d:%d: Expected digit after `e`",
-                                    line_and_col);
-                            goto e_failed;
-                        }
-
-                        top->u.dbl *=
-                            pow(10.0,
-                                (flags & flag_num_e_negative ? -num_e : num_e));
-                    }
-
-                    if (flags & flag_num_negative) {
-                        if (top->type == json_integer)
-                            top->u.integer = -top->u.integer;
-                        else
-                            top->u.dbl = -top->u.dbl;
-                    }
-
-                    flags |= flag_next | flag_reproc;
-                    break;
-
                 default:
                     break;
                 };
             }
 
-            if (flags & flag_reproc) {
-                flags &= ~flag_reproc;
-                --state.ptr;
-            }
-
             if (flags & flag_next) {
                 flags = (flags & ~flag_next) | flag_need_comma;
 
@@ -932,8 +883,16 @@ e_failed:
             strcpy(error_buf, "Unknown error");
     }
 
-    if (state.first_pass)
+    if (state.first_pass) {
         alloc = root;
+    } else {
+        /* Values still being parsed are not linked to their parents yet */
+        while (top) {
+            json_value *parent = top->parent;
+            json_value_free_ex(&state.settings, top);
+            top = parent;
+        }
+    }
 
     while (alloc) {
         top = alloc->_reserved.next_alloc;
@@ -941,9 +900,6 @@ e_failed:
         alloc = top;
     }
 
-    if (!state.first_pass)
-        json_value_free_ex(&state.settings, root);
-
     return 0;
 }
 
@@ -952,6 +908,264 @@ json_value *json_parse(const json_char *json, size_t length) {
     return json_parse_ex(&settings, json, length, 0);
 }
 
+unsigned int json_key_hash(const json_char *name, unsigned int length) {
+    unsigned int hash = 0, factor = 1;
+
+    while (length--) {
+        hash += ((unsigned char)*name++) * factor;
+        factor *= 31;
+    }
+
+    return hash;
+}
+
+typedef struct {
+    const json_char *ptr;
+    const json_char *end;
+    json_char string[JSON_SAX_STRING_MAX];
+    unsigned int string_length;
+    char *error;
+} json_sax_state;
+
+#define sax_fail(state, ...)                                                   \
+    do {                                                                       \
+        sprintf((state)->error, __VA_ARGS__);                                  \
+        return 0;                                                              \
+    } while (0)
+
+#define sax_emit(callback, ...)                                                \
+    do {                                                                       \
+        if ((callback) && !(callback)(__VA_ARGS__)) {                          \
+            strcpy(error, "Stopped by handler");                               \
+            goto e_failed;                                                     \
+        }                                                                      \
+    } while (0)
+
+static int sax_string_add(json_sax_state *state, json_uchar uchar) {
+    if (state->string_length + json_utf8_encode(uchar, 0) >= JSON_SAX_STRING_MAX)
+        sax_fail(state, "String too long");
+
+    state->string_length +=
+        json_utf8_encode(uchar, state->string + state->string_length);
+    return 1;
+}
+
+/* Reads a string up to the closing quote, the opening quote is consumed */
+static int sax_string(json_sax_state *state) {
+    json_uchar uchar;
+    json_char b;
+
+    state->string_length = 0;
+    for (;;) {
+        /* NUL ends the input, as in json_parse_ex */
+        if (state->ptr == state->end || *state->ptr == 0)
+            sax_fail(state, "Unexpected EOF in string");
+
+        b = *state->ptr++;
+        if (b == '"')
+            break;
+
+        if (b != '\\') {
+            /* Raw bytes are copied, UTF-8 sequences stay intact */
+            if (state->string_length + 1 >= JSON_SAX_STRING_MAX)
+                sax_fail(state, "String too long");
+            state->string[state->string_length++] = b;
+            continue;
+        }
+
+        if (!json_scan_escape(&state->ptr, state->end, &uchar))
+            sax_fail(state, "Invalid escape sequence");
+
+        if (!sax_string_add(state, uchar))
+            return 0;
+    }
+
+    state->string[state->string_length] = 0;
+    return 1;
+}
+
+static int sax_number(json_sax_state *state, json_value *value) {
+    const char *number_error = json_scan_number(&state->ptr, state->end, value);
+
+    if (number_error)
+        sax_fail(state, "%s", number_error);
+
+    return 1;
+}
+
+static int sax_literal(json_sax_state *state, const char *literal) {
+    size_t length = json_match_literal(state->ptr, state->end, literal);
+
+    if (!length)
+        sax_fail(state, "Unknown value");
+
+    state->ptr += length;
+    return 1;
+}
+
+int json_parse_sax(const json_sax_handler *handler, void *user_data,
+                   const json_char *json, size_t length, char *error_buf) {
+    enum {
+        expect_value,
+        expect_value_or_end, /* after [ */
+        expect_key_or_end,   /* after { */
+        expect_key,
+        expect_colon,
+        expect_comma_or_end,
+        expect_nothing
+    } expect = expect_value;
+    json_char error[json_error_max];
+    json_sax_state state;
+    json_value value;
+    uint32_t objects = 0; /* bit per level, set for objects */
+    unsigned int depth = 0;
+    json_char b;
+
+    memset(&value, 0, sizeof(value));
+    state.ptr = json;
+    state.end = json + length;
+    state.error = error;
+    *error = 0;
+
+    for (;;) {
+        while (state.ptr != state.end &&
+               (*state.ptr == ' ' || *state.ptr == '\t' || *state.ptr == '\r' ||
+                *state.ptr == '\n'))
+            ++state.ptr;
+
+        /* The buffer may be NUL terminated within its length */
+        if (state.ptr == state.end || *state.ptr == 0) {
+            if (expect == expect_nothing)
+                return 1;
+            strcpy(error, "Unexpected EOF");
+            goto e_failed;
+        }
+
+        b = *state.ptr;
+        switch (expect) {
+        case expect_value_or_end:
+            if (b == ']') {
+                ++state.ptr;
+                --depth;
+                sax_emit(handler->array_end, user_data);
+                expect = depth ? expect_comma_or_end : expect_nothing;
+                continue;
+            }
+            /* fall through */
+        case expect_value:
+            if (b == '{' || b == '[') {
+                if (depth == JSON_SAX_MAX_DEPTH) {
+                    strcpy(error, "Nesting too deep");
+                    goto e_failed;
+                }
+                ++state.ptr;
+                if (b == '{') {
+                    objects |= (1UL << depth);
+                    ++depth;
+                    sax_emit(handler->object_start, user_data);
+                    expect = expect_key_or_end;
+                } else {
+                    objects &= ~(1UL << depth);
+                    ++depth;
+                    sax_emit(handler->array_start, user_data);
+                    expect = expect_value_or_end;
+                }
+                continue;
+            }
+
+            if (b == '"') {
+                ++state.ptr;
+                if (!sax_string(&state))
+                    goto e_failed;
+                value.type = json_string;
+                value.u.string.length = state.string_length;
+                value.u.string.ptr = state.string;
+            } else if (b == '-' || isdigit((unsigned char)b)) {
+                if (!sax_number(&state, &value))
+                    goto e_failed;
+            } else if (b == 't' || b == 'f') {
+                if (!sax_literal(&state, b == 't' ? "true" : "false"))
+                    goto e_failed;
+                value.type = json_boolean;
+                value.u.boolean = (b == 't');
+            } else if (b == 'n') {
+                if (!sax_literal(&state, "null"))
+                    goto e_failed;
+                value.type = json_null;
+            } else {
+                sprintf(error, "Unexpected `%c` when seeking value", b);
+                goto e_failed;
+            }
+            sax_emit(handler->value, user_data, &value);
+            expect = depth ? expect_comma_or_end : expect_nothing;
+            continue;
+
+        case expect_key_or_end:
+            if (b == '}') {
+                ++state.ptr;
+                --depth;
+                sax_emit(handler->object_end, user_data);
+                expect = depth ? expect_comma_or_end : expect_nothing;
+                continue;
+            }
+            /* fall through */
+        case expect_key:
+            if (b != '"') {
+                sprintf(error, "Unexpected `%c` in object", b);
+                goto e_failed;
+            }
+            ++state.ptr;
+            if (!sax_string(&state))
+                goto e_failed;
+            sax_emit(handler->key, user_data, state.string, state.string_length);
+            expect = expect_colon;
+            continue;
+
+        case expect_colon:
+            if (b != ':') {
+                sprintf(error, "Expected `:` before `%c`", b);
+                goto e_failed;
+            }
+            ++state.ptr;
+            expect = expect_value;
+            continue;
+
+        case expect_comma_or_end:
+            ++state.ptr;
+            if (b == ',') {
+                expect = (objects & (1UL << (depth - 1))) ? expect_key
+                                                           : expect_value;
+                continue;
+            }
+            if (b == ((objects & (1UL << (depth - 1))) ? '}' : ']')) {
+                --depth;
+                if (b == '}')
+                    sax_emit(handler->object_end, user_data);
+                else
+                    sax_emit(handler->array_end, user_data);
+                expect = depth ? expect_comma_or_end : expect_nothing;
+                continue;
+            }
+            sprintf(error, "Unexpected `%c` after value", b);
+            goto e_failed;
+
+        case expect_nothing:
+            sprintf(error, "Trailing garbage: `%c`", b);
+            goto e_failed;
+        }
+    }
+
+e_failed:
+
+    if (error_buf) {
+        if (*error)
+            strcpy(error_buf, error);
+        else
+            strcpy(error_buf, "Unknown error");
+    }
+    return 0;
+}
+
 void json_value_free_ex(json_settings *settings, json_value *value) {
     json_value *cur_value;
 
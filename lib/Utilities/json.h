@@ -89,6 +89,7 @@ extern const struct _json_value json_value_none;
 typedef struct _json_object_entry {
     json_char *name;
     unsigned int name_length;
+    unsigned int name_hash; /* json_key_hash() of the name */
 
     struct _json_value *value;
 
@@ -236,6 +237,36 @@ void json_value_free(json_value *);
  */
 void json_value_free_ex(json_settings *settings, json_value *);
 
+/* Hash of an object key, stored in json_object_entry.name_hash so keys can
+ * be compared without touching the name. The hash is the sum of
+ * name[i] * 31^i modulo 2^32, which allows it to be computed at compile
+ * time as well (see jsonPath.h).
+ */
+unsigned int json_key_hash(const json_char *name, unsigned int length);
+
+/* Event based parsing in a single pass without any allocation. The handler
+ * is called for every token, callbacks that are NULL are skipped and a
+ * callback returning 0 stops the parse. Strings and keys are passed
+ * unescaped in a buffer that is only valid during the callback, scalar
+ * values are passed as a temporary json_value without parent.
+ */
+#ifndef JSON_SAX_STRING_MAX
+#define JSON_SAX_STRING_MAX 128 /* longest string or key, including the NUL */
+#endif
+#define JSON_SAX_MAX_DEPTH 32
+
+typedef struct {
+    int (*object_start)(void *user_data);
+    int (*object_end)(void *user_data);
+    int (*array_start)(void *user_data);
+    int (*array_end)(void *user_data);
+    int (*key)(void *user_data, const json_char *name, unsigned int length);
+    int (*value)(void *user_data, const json_value *value);
+} json_sax_handler;
+
+int json_parse_sax(const json_sax_handler *handler, void *user_data,
+                   const json_char *json, size_t length, char *error);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
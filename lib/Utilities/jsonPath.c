@@ -0,0 +1,146 @@
+/**
+ * \file
+ * \brief Lookup of values in a parsed JSON document by key path.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#include <string.h>
+
+#include "jsonPath.h"
+
+/**
+ * @brief  Find the value at the end of a key path
+ * @param  root Parsed document
+ * @param  path Key path
+ * @retval Pointer to the value or NULL if a key is missing
+ */
+const json_value *JsonPath_find(const json_value *root, const JsonPath_t *path)
+{
+    const json_value *value = root;
+
+    for (uint8_t level = 0; (value != NULL) && (level < path->depth); level++)
+    {
+        const JsonPath_key_t *key = &path->keys[level];
+        const json_value *next = NULL;
+
+        if (value->type != json_object)
+        {
+            return NULL;
+        }
+        for (unsigned int i = 0; i < value->u.object.length; i++)
+        {
+            const json_object_entry *member = &value->u.object.values[i];
+            if ((member->name_length == key->length) && (member->name_hash == key->hash) &&
+                (memcmp(member->name, key->s, key->length) == 0))
+            {
+                next = member->value;
+                break;
+            }
+        }
+        value = next;
+    }
+    return value;
+}
+
+/**
+ * @brief  Read an integer
+ * @param  root Parsed document
+ * @param  path Key path
+ * @param  value Pointer to the integer
+ * @retval true if the value exists and is an integer
+ */
+bool JsonPath_getInteger(const json_value *root, const JsonPath_t *path, json_int_t *value)
+{
+    const json_value *found = JsonPath_find(root, path);
+
+    if ((found == NULL) || (found->type != json_integer))
+    {
+        return false;
+    }
+    *value = found->u.integer;
+    return true;
+}
+
+/**
+ * @brief  Read a number, integers are converted
+ * @param  root Parsed document
+ * @param  path Key path
+ * @param  value Pointer to the number
+ * @retval true if the value exists and is a number
+ */
+bool JsonPath_getDouble(const json_value *root, const JsonPath_t *path, double *value)
+{
+    const json_value *found = JsonPath_find(root, path);
+
+    if (found == NULL)
+    {
+        return false;
+    }
+    if (found->type == json_double)
+    {
+        *value = found->u.dbl;
+        return true;
+    }
+    if (found->type == json_integer)
+    {
+        *value = (double)found->u.integer;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief  Read a string
+ * @param  root Parsed document
+ * @param  path Key path
+ * @param  value Pointer set to the NUL terminated string inside the document
+ * @retval true if the value exists and is a string
+ */
+bool JsonPath_getString(const json_value *root, const JsonPath_t *path, const char **value)
+{
+    const json_value *found = JsonPath_find(root, path);
+
+    if ((found == NULL) || (found->type != json_string))
+    {
+        return false;
+    }
+    *value = found->u.string.ptr;
+    return true;
+}
+
+/**
+ * @brief  Read a boolean
+ * @param  root Parsed document
+ * @param  path Key path
+ * @param  value Pointer to the boolean
+ * @retval true if the value exists and is a boolean
+ */
+bool JsonPath_getBoolean(const json_value *root, const JsonPath_t *path, bool *value)
+{
+    const json_value *found = JsonPath_find(root, path);
+
+    if ((found == NULL) || (found->type != json_boolean))
+    {
+        return false;
+    }
+    *value = (found->u.boolean != 0);
+    return true;
+}
@@ -0,0 +1,122 @@
+/**
+ * \file
+ * \brief Lookup of values in a parsed JSON document by key path.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#ifndef JSONPATH_H
+#define JSONPATH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "json.h"
+
+/*
+ * A path is a list of object keys, e.g. {"desired", "telemetrySendFrequency"}
+ * for desired.telemetrySendFrequency. The keys are hashed by the compiler
+ * with the same function as json_key_hash(), so a lookup compares the
+ * length and hash stored in each json_object_entry first and only compares
+ * the name when both match.
+ *
+ * JSONPATH(desiredFrequency, JSONPATH_KEY("desired"),
+ *          JSONPATH_KEY("telemetrySendFrequency"));
+ * ...
+ * if (JsonPath_getInteger(response, &desiredFrequency, &frequency)) ...
+ */
+#define JSONPATH_KEY_MAX 32 /* longest key supported by JSONPATH_KEY */
+
+#define JSONPATH_CHAR(s, i, f)                                              \
+    ((i) < sizeof(s) - 1                                                     \
+         ? (unsigned int)(unsigned char)(s)[(i) < sizeof(s) - 1 ? (i) : 0] * (f) \
+         : 0u)
+
+/* Hash of a string literal, fails to compile for keys that are too long */
+#define JSONPATH_HASH(s) \
+    (JSONPATH_CHAR(s, 0, 0x00000001u) + \
+     JSONPATH_CHAR(s, 1, 0x0000001Fu) + \
+     JSONPATH_CHAR(s, 2, 0x000003C1u) + \
+     JSONPATH_CHAR(s, 3, 0x0000745Fu) + \
+     JSONPATH_CHAR(s, 4, 0x000E1781u) + \
+     JSONPATH_CHAR(s, 5, 0x01B4D89Fu) + \
+     JSONPATH_CHAR(s, 6, 0x34E63B41u) + \
+     JSONPATH_CHAR(s, 7, 0x67E12CDFu) + \
+     JSONPATH_CHAR(s, 8, 0x94446F01u) + \
+     JSONPATH_CHAR(s, 9, 0xF449711Fu) + \
+     JSONPATH_CHAR(s, 10, 0x94E4B2C1u) + \
+     JSONPATH_CHAR(s, 11, 0x07B1A55Fu) + \
+     JSONPATH_CHAR(s, 12, 0xEE830681u) + \
+     JSONPATH_CHAR(s, 13, 0xE1DDC99Fu) + \
+     JSONPATH_CHAR(s, 14, 0x59DB6A41u) + \
+     JSONPATH_CHAR(s, 15, 0xE191DDDFu) + \
+     JSONPATH_CHAR(s, 16, 0x50A9DE01u) + \
+     JSONPATH_CHAR(s, 17, 0xC491E21Fu) + \
+     JSONPATH_CHAR(s, 18, 0xCDAA61C1u) + \
+     JSONPATH_CHAR(s, 19, 0xE7A1D65Fu) + \
+     JSONPATH_CHAR(s, 20, 0x0C98F581u) + \
+     JSONPATH_CHAR(s, 21, 0x8685BA9Fu) + \
+     JSONPATH_CHAR(s, 22, 0x4A319941u) + \
+     JSONPATH_CHAR(s, 23, 0xFC018EDFu) + \
+     JSONPATH_CHAR(s, 24, 0x84304D01u) + \
+     JSONPATH_CHAR(s, 25, 0x01D9531Fu) + \
+     JSONPATH_CHAR(s, 26, 0x395110C1u) + \
+     JSONPATH_CHAR(s, 27, 0xF0D1075Fu) + \
+     JSONPATH_CHAR(s, 28, 0x294FE481u) + \
+     JSONPATH_CHAR(s, 29, 0x00ACAB9Fu) + \
+     JSONPATH_CHAR(s, 30, 0x14E8C841u) + \
+     JSONPATH_CHAR(s, 31, 0x88303FDFu) + \
+     0u * sizeof(char[(sizeof(s) <= JSONPATH_KEY_MAX + 1) ? 1 : -1]))
+
+#define JSONPATH_KEY(s) {JSONPATH_HASH(s), sizeof(s) - 1, s}
+
+#define JSONPATH(name, ...)                                    \
+    static const JsonPath_key_t name##Keys[] = {__VA_ARGS__}; \
+    static const JsonPath_t name = {name##Keys, sizeof(name##Keys) / sizeof(name##Keys[0])}
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    typedef struct
+    {
+        unsigned int hash;
+        unsigned int length;
+        const char *s;
+    } JsonPath_key_t;
+
+    typedef struct
+    {
+        const JsonPath_key_t *keys;
+        uint8_t depth;
+    } JsonPath_t;
+
+    const json_value *JsonPath_find(const json_value *root, const JsonPath_t *path);
+    bool JsonPath_getInteger(const json_value *root, const JsonPath_t *path, json_int_t *value);
+    bool JsonPath_getDouble(const json_value *root, const JsonPath_t *path, double *value);
+    bool JsonPath_getString(const json_value *root, const JsonPath_t *path, const char **value);
+    bool JsonPath_getBoolean(const json_value *root, const JsonPath_t *path, bool *value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* JSONPATH_H */
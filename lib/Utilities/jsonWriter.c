@@ -0,0 +1,346 @@
+/**
+ * \file
+ * \brief Streaming JSON writer into a fixed buffer.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#include <string.h>
+
+#include "fixedFormat.h"
+#include "jsonWriter.h"
+
+static void JsonWriter_put(JsonWriter_t *writer, const char *data, size_t length);
+static void JsonWriter_putChar(JsonWriter_t *writer, char c);
+static void JsonWriter_putString(JsonWriter_t *writer, const char *value);
+static void JsonWriter_beginValue(JsonWriter_t *writer, const char *key);
+
+/**
+ * @brief  Start writing into a buffer
+ * @param  writer Pointer to the writer
+ * @param  buffer Output buffer
+ * @param  size Size of the buffer including the terminating NUL
+ * @retval None
+ */
+void JsonWriter_init(JsonWriter_t *writer, char *buffer, size_t size)
+{
+    writer->buffer = buffer;
+    writer->size = size;
+    writer->length = 0;
+    writer->hasMembers = 0;
+    writer->depth = 0;
+    writer->error = (size == 0);
+    if (size > 0)
+    {
+        buffer[0] = '\0';
+    }
+}
+
+/**
+ * @brief  Open an object
+ * @param  writer Pointer to the writer
+ * @param  key Key of the object, NULL in arrays and at the top level
+ * @retval None
+ */
+void JsonWriter_beginObject(JsonWriter_t *writer, const char *key)
+{
+    JsonWriter_beginValue(writer, key);
+    JsonWriter_putChar(writer, '{');
+    if (writer->depth >= JSONWRITER_MAX_DEPTH)
+    {
+        writer->error = true;
+        return;
+    }
+    writer->hasMembers &= ~(1ul << writer->depth);
+    writer->depth++;
+}
+
+/**
+ * @brief  Close the current object
+ * @param  writer Pointer to the writer
+ * @retval None
+ */
+void JsonWriter_endObject(JsonWriter_t *writer)
+{
+    if (writer->depth == 0)
+    {
+        writer->error = true;
+        return;
+    }
+    writer->depth--;
+    JsonWriter_putChar(writer, '}');
+}
+
+/**
+ * @brief  Open an array
+ * @param  writer Pointer to the writer
+ * @param  key Key of the array, NULL in arrays and at the top level
+ * @retval None
+ */
+void JsonWriter_beginArray(JsonWriter_t *writer, const char *key)
+{
+    JsonWriter_beginValue(writer, key);
+    JsonWriter_putChar(writer, '[');
+    if (writer->depth >= JSONWRITER_MAX_DEPTH)
+    {
+        writer->error = true;
+        return;
+    }
+    writer->hasMembers &= ~(1ul << writer->depth);
+    writer->depth++;
+}
+
+/**
+ * @brief  Close the current array
+ * @param  writer Pointer to the writer
+ * @retval None
+ */
+void JsonWriter_endArray(JsonWriter_t *writer)
+{
+    if (writer->depth == 0)
+    {
+        writer->error = true;
+        return;
+    }
+    writer->depth--;
+    JsonWriter_putChar(writer, ']');
+}
+
+/**
+ * @brief  Add a string, quotes and control characters are escaped
+ * @param  writer Pointer to the writer
+ * @param  key Key of the member, NULL in arrays and at the top level
+ * @param  value NUL terminated string
+ * @retval None
+ */
+void JsonWriter_string(JsonWriter_t *writer, const char *key, const char *value)
+{
+    JsonWriter_beginValue(writer, key);
+    JsonWriter_putString(writer, value);
+}
+
+/**
+ * @brief  Add an integer
+ * @param  writer Pointer to the writer
+ * @param  key Key of the member, NULL in arrays and at the top level
+ * @param  value Integer value
+ * @retval None
+ */
+void JsonWriter_integer(JsonWriter_t *writer, const char *key, int64_t value)
+{
+    char digits[20];
+    uint8_t count = 0;
+    uint64_t magnitude = (value < 0) ? (0 - (uint64_t)value) : (uint64_t)value;
+
+    JsonWriter_beginValue(writer, key);
+    if (value < 0)
+    {
+        JsonWriter_putChar(writer, '-');
+    }
+    /*Most values fit in 32 bit, avoid the 64 bit division for them*/
+    if (magnitude <= UINT32_MAX)
+    {
+        uint32_t small = (uint32_t)magnitude;
+        do
+        {
+            digits[count++] = (char)('0' + (small % 10));
+            small /= 10;
+        } while (small > 0);
+    }
+    else
+    {
+        do
+        {
+            digits[count++] = (char)('0' + (magnitude % 10));
+            magnitude /= 10;
+        } while (magnitude > 0);
+    }
+    while (count > 0)
+    {
+        JsonWriter_putChar(writer, digits[--count]);
+    }
+}
+
+/**
+ * @brief  Add a number with up to a given number of decimals, trailing zeros
+ *         are dropped as in the output of json_serialize()
+ * @param  writer Pointer to the writer
+ * @param  key Key of the member, NULL in arrays and at the top level
+ * @param  value Number, written as null if it cannot be formatted
+ * @param  decimals Number of decimals, at most FIXEDFORMAT_MAX_DECIMALS
+ * @retval None
+ */
+void JsonWriter_float(JsonWriter_t *writer, const char *key, float value, uint8_t decimals)
+{
+    char number[FIXEDFORMAT_BUFFER_SIZE + 2];
+    size_t length = FixedFormat_float(number, FIXEDFORMAT_BUFFER_SIZE, value, decimals);
+
+    JsonWriter_beginValue(writer, key);
+    if (length == 0)
+    {
+        JsonWriter_put(writer, "null", 4);
+        return;
+    }
+    if (decimals == 0)
+    {
+        number[length++] = '.';
+        number[length++] = '0';
+    }
+    else
+    {
+        while (number[length - 2] != '.' && number[length - 1] == '0')
+        {
+            length--;
+        }
+    }
+    JsonWriter_put(writer, number, length);
+}
+
+/**
+ * @brief  Add a boolean
+ * @param  writer Pointer to the writer
+ * @param  key Key of the member, NULL in arrays and at the top level
+ * @param  value Boolean value
+ * @retval None
+ */
+void JsonWriter_boolean(JsonWriter_t *writer, const char *key, bool value)
+{
+    JsonWriter_beginValue(writer, key);
+    if (value)
+    {
+        JsonWriter_put(writer, "true", 4);
+    }
+    else
+    {
+        JsonWriter_put(writer, "false", 5);
+    }
+}
+
+/**
+ * @brief  Check the written document
+ * @param  writer Pointer to the writer
+ * @retval Length of the document, 0 if it did not fit or is not complete
+ */
+size_t JsonWriter_finish(JsonWriter_t *writer)
+{
+    if (writer->error || (writer->depth != 0))
+    {
+        return 0;
+    }
+    return writer->length;
+}
+
+/**
+ * @brief  Write the separator and key in front of a value
+ * @param  writer Pointer to the writer
+ * @param  key Key of the member or NULL
+ * @retval None
+ */
+static void JsonWriter_beginValue(JsonWriter_t *writer, const char *key)
+{
+    if (writer->depth > 0)
+    {
+        uint32_t mask = 1ul << (writer->depth - 1);
+        if (writer->hasMembers & mask)
+        {
+            JsonWriter_putChar(writer, ',');
+        }
+        writer->hasMembers |= mask;
+    }
+    if (key != NULL)
+    {
+        JsonWriter_putString(writer, key);
+        JsonWriter_putChar(writer, ':');
+    }
+}
+
+static void JsonWriter_putString(JsonWriter_t *writer, const char *value)
+{
+    const char *start = value;
+
+    JsonWriter_putChar(writer, '"');
+    for (; *value != '\0'; value++)
+    {
+        char escaped;
+        switch (*value)
+        {
+        case '"':
+            escaped = '"';
+            break;
+        case '\\':
+            escaped = '\\';
+            break;
+        case '\b':
+            escaped = 'b';
+            break;
+        case '\f':
+            escaped = 'f';
+            break;
+        case '\n':
+            escaped = 'n';
+            break;
+        case '\r':
+            escaped = 'r';
+            break;
+        case '\t':
+            escaped = 't';
+            break;
+        default:
+            if ((unsigned char)*value < 0x20)
+            {
+                /*The other control characters have no short escape*/
+                static const char hex[] = "0123456789abcdef";
+                char unicode[6] = {'\\', 'u', '0', '0', hex[(*value >> 4) & 0x0F], hex[*value & 0x0F]};
+                JsonWriter_put(writer, start, value - start);
+                JsonWriter_put(writer, unicode, sizeof(unicode));
+                start = value + 1;
+            }
+            continue;
+        }
+        /*Copy the plain characters in one go*/
+        JsonWriter_put(writer, start, value - start);
+        JsonWriter_putChar(writer, '\\');
+        JsonWriter_putChar(writer, escaped);
+        start = value + 1;
+    }
+    JsonWriter_put(writer, start, value - start);
+    JsonWriter_putChar(writer, '"');
+}
+
+static void JsonWriter_put(JsonWriter_t *writer, const char *data, size_t length)
+{
+    if (writer->error)
+    {
+        return;
+    }
+    if (length >= (writer->size - writer->length))
+    {
+        writer->error = true;
+        return;
+    }
+    memcpy(&writer->buffer[writer->length], data, length);
+    writer->length += length;
+    writer->buffer[writer->length] = '\0';
+}
+
+static void JsonWriter_putChar(JsonWriter_t *writer, char c)
+{
+    JsonWriter_put(writer, &c, 1);
+}
@@ -0,0 +1,72 @@
+/**
+ * \file
+ * \brief Streaming JSON writer into a fixed buffer.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#ifndef JSONWRITER_H
+#define JSONWRITER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Keys and values are written to the buffer as they are added, without
+ * building a tree and without using the heap. The output is the packed
+ * format of json_serialize(). Every function takes the key of the member
+ * it adds, the key is NULL for array elements and the top level value.
+ * Writing past the end of the buffer sets an error that is reported by
+ * JsonWriter_finish(), the buffer always stays NUL terminated.
+ */
+#define JSONWRITER_MAX_DEPTH 32
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    typedef struct
+    {
+        char *buffer;
+        size_t size;
+        size_t length;
+        uint32_t hasMembers; /* one bit per open object or array */
+        uint8_t depth;
+        bool error;
+    } JsonWriter_t;
+
+    void JsonWriter_init(JsonWriter_t *writer, char *buffer, size_t size);
+    void JsonWriter_beginObject(JsonWriter_t *writer, const char *key);
+    void JsonWriter_endObject(JsonWriter_t *writer);
+    void JsonWriter_beginArray(JsonWriter_t *writer, const char *key);
+    void JsonWriter_endArray(JsonWriter_t *writer);
+    void JsonWriter_string(JsonWriter_t *writer, const char *key, const char *value);
+    void JsonWriter_integer(JsonWriter_t *writer, const char *key, int64_t value);
+    void JsonWriter_float(JsonWriter_t *writer, const char *key, float value, uint8_t decimals);
+    void JsonWriter_boolean(JsonWriter_t *writer, const char *key, bool value);
+    size_t JsonWriter_finish(JsonWriter_t *writer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* JSONWRITER_H */
@@ -0,0 +1,233 @@
+/**
+ * \file
+ * \brief Publish latency instrumentation for the WE IoT design kit.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#include <string.h>
+
+#include "ConfigPlatform.h"
+#include "latency.h"
+
+typedef struct
+{
+    Latency_point_t start;
+    Latency_point_t end;
+    const char *name;
+} Latency_stageDefinition_t;
+
+static const Latency_stageDefinition_t stageDefinitions[LATENCY_STAGE_COUNT] = {
+    {LATENCY_POINT_READ_START, LATENCY_POINT_READ_END, "read"},
+    {LATENCY_POINT_SERIALIZE_START, LATENCY_POINT_SERIALIZE_END, "serialize"},
+    {LATENCY_POINT_ENCODE_START, LATENCY_POINT_ENCODE_END, "encode"},
+    {LATENCY_POINT_UART_TX_START, LATENCY_POINT_UART_TX_END, "uartTx"},
+    {LATENCY_POINT_UART_TX_END, LATENCY_POINT_MODULE_OK, "moduleOk"},
+    {LATENCY_POINT_MODULE_OK, LATENCY_POINT_PUBACK, "puback"},
+    {LATENCY_POINT_READ_START, LATENCY_POINT_PUBACK, "total"}};
+
+static Latency_histogram_t histograms[LATENCY_STAGE_COUNT];
+static unsigned long points[LATENCY_POINT_COUNT];
+static uint16_t pointsMarked = 0;
+static bool sampleOpen = false;
+
+/**
+ * @brief  Get the histogram bucket of a duration
+ * @param  duration Duration in microseconds
+ * @retval bucket index
+ */
+static uint8_t Latency_getBucket(uint32_t duration)
+{
+    uint8_t bucket = 0;
+    while ((duration > 1) && (bucket < (LATENCY_BUCKETS - 1)))
+    {
+        duration >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+/**
+ * @brief  Start a new sample, points marked before are discarded
+ * @retval none
+ */
+void Latency_begin()
+{
+    pointsMarked = 0;
+    sampleOpen = true;
+}
+
+/**
+ * @brief  Record the current time for a point of the open sample.
+ *         Ignored if no sample is open.
+ * @param  point Point to record
+ * @retval none
+ */
+void Latency_mark(Latency_point_t point)
+{
+    if (sampleOpen && (point < LATENCY_POINT_COUNT))
+    {
+        points[point] = micros();
+        pointsMarked |= (uint16_t)(1 << point);
+    }
+}
+
+/**
+ * @brief  Close the open sample and add its stage durations to the histograms
+ * @param  success false to discard the sample
+ * @retval none
+ */
+void Latency_end(bool success)
+{
+    if (!sampleOpen)
+    {
+        return;
+    }
+    sampleOpen = false;
+    if (!success)
+    {
+        return;
+    }
+
+    for (uint8_t stage = 0; stage < LATENCY_STAGE_COUNT; stage++)
+    {
+        const Latency_stageDefinition_t *definition = &stageDefinitions[stage];
+        uint16_t required = (uint16_t)((1 << definition->start) | (1 << definition->end));
+        if ((pointsMarked & required) != required)
+        {
+            continue;
+        }
+
+        uint32_t duration = points[definition->end] - points[definition->start];
+        Latency_histogram_t *histogram = &histograms[stage];
+        if ((histogram->count == 0) || (duration < histogram->min))
+        {
+            histogram->min = duration;
+        }
+        if (duration > histogram->max)
+        {
+            histogram->max = duration;
+        }
+        histogram->count++;
+
+        uint8_t bucket = Latency_getBucket(duration);
+        if (histogram->buckets[bucket] < UINT16_MAX)
+        {
+            histogram->buckets[bucket]++;
+        }
+    }
+}
+
+/**
+ * @brief  Clear all histograms
+ * @retval none
+ */
+void Latency_reset()
+{
+    memset(histograms, 0, sizeof(histograms));
+    sampleOpen = false;
+}
+
+/**
+ * @brief  Get the histogram of a stage
+ * @param  stage Stage
+ * @retval Pointer to the histogram or NULL
+ */
+const Latency_histogram_t *Latency_getHistogram(Latency_stage_t stage)
+{
+    if (stage >= LATENCY_STAGE_COUNT)
+    {
+        return NULL;
+    }
+    return &histograms[stage];
+}
+
+/**
+ * @brief  Estimate a percentile of a stage, interpolated inside the bucket
+ * @param  stage Stage
+ * @param  percentile Percentile, 0 - 100
+ * @retval Duration in microseconds, 0 if no samples
+ */
+uint32_t Latency_getPercentile(Latency_stage_t stage, uint8_t percentile)
+{
+    const Latency_histogram_t *histogram = Latency_getHistogram(stage);
+    uint32_t total = 0;
+    uint32_t rank;
+    uint32_t cumulative = 0;
+
+    if (histogram == NULL)
+    {
+        return 0;
+    }
+    for (uint8_t bucket = 0; bucket < LATENCY_BUCKETS; bucket++)
+    {
+        total += histogram->buckets[bucket];
+    }
+    if (total == 0)
+    {
+        return 0;
+    }
+    if (percentile > 100)
+    {
+        percentile = 100;
+    }
+
+    rank = ((total * percentile) + 99) / 100;
+    if (rank == 0)
+    {
+        rank = 1;
+    }
+
+    for (uint8_t bucket = 0; bucket < LATENCY_BUCKETS; bucket++)
+    {
+        uint16_t bucketCount = histogram->buckets[bucket];
+        if ((cumulative + bucketCount) >= rank)
+        {
+            uint32_t lower = (bucket == 0) ? 0 : ((uint32_t)1 << bucket);
+            uint32_t upper = (uint32_t)1 << (bucket + 1);
+            uint32_t value = lower + (uint32_t)(((uint64_t)(upper - lower) * (rank - cumulative)) / bucketCount);
+            if (value < histogram->min)
+            {
+                value = histogram->min;
+            }
+            if (value > histogram->max)
+            {
+                value = histogram->max;
+            }
+            return value;
+        }
+        cumulative += bucketCount;
+    }
+    return histogram->max;
+}
+
+/**
+ * @brief  Get the name of a stage
+ * @param  stage Stage
+ * @retval Name of the stage
+ */
+const char *Latency_getStageName(Latency_stage_t stage)
+{
+    if (stage >= LATENCY_STAGE_COUNT)
+    {
+        return "";
+    }
+    return stageDefinitions[stage].name;
+}
@@ -0,0 +1,103 @@
+/**
+ * \file
+ * \brief Publish latency instrumentation for the WE IoT design kit.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Set to 0 to compile the instrumentation out */
+#ifndef LATENCY_INSTRUMENTATION
+#define LATENCY_INSTRUMENTATION 1
+#endif
+
+/* Bucket i counts durations in [2^i, 2^(i+1)) microseconds */
+#define LATENCY_BUCKETS 24
+
+#if LATENCY_INSTRUMENTATION
+#define LATENCY_BEGIN() Latency_begin()
+#define LATENCY_MARK(point) Latency_mark(point)
+#define LATENCY_END(success) Latency_end(success)
+#else
+#define LATENCY_BEGIN()
+#define LATENCY_MARK(point)
+#define LATENCY_END(success)
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /* Points in time along the publish path */
+    typedef enum
+    {
+        LATENCY_POINT_READ_START,
+        LATENCY_POINT_READ_END,
+        LATENCY_POINT_SERIALIZE_START,
+        LATENCY_POINT_SERIALIZE_END,
+        LATENCY_POINT_ENCODE_START,
+        LATENCY_POINT_ENCODE_END,
+        LATENCY_POINT_UART_TX_START,
+        LATENCY_POINT_UART_TX_END,
+        LATENCY_POINT_MODULE_OK,
+        LATENCY_POINT_PUBACK,
+        LATENCY_POINT_COUNT
+    } Latency_point_t;
+
+    /* Durations between two points */
+    typedef enum
+    {
+        LATENCY_STAGE_READ,
+        LATENCY_STAGE_SERIALIZE,
+        LATENCY_STAGE_ENCODE,
+        LATENCY_STAGE_UART_TX,
+        LATENCY_STAGE_MODULE_OK,
+        LATENCY_STAGE_PUBACK,
+        LATENCY_STAGE_TOTAL,
+        LATENCY_STAGE_COUNT
+    } Latency_stage_t;
+
+    typedef struct
+    {
+        uint32_t count;
+        uint32_t min;
+        uint32_t max;
+        uint16_t buckets[LATENCY_BUCKETS];
+    } Latency_histogram_t;
+
+    void Latency_begin();
+    void Latency_mark(Latency_point_t point);
+    void Latency_end(bool success);
+    void Latency_reset();
+    const Latency_histogram_t *Latency_getHistogram(Latency_stage_t stage);
+    uint32_t Latency_getPercentile(Latency_stage_t stage, uint8_t percentile);
+    const char *Latency_getStageName(Latency_stage_t stage);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LATENCY_H */
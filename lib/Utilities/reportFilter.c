@@ -0,0 +1,82 @@
+/**
+ * \file
+ * \brief Report-by-exception filter of a telemetry channel.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#include <math.h>
+
+#include "reportFilter.h"
+
+/**
+ * @brief  Set the thresholds, the next value is reported
+ * @param  filter Pointer to the filter
+ * @param  deadband Change since the last report, 0 disables the check
+ * @param  rate Change per second since the previous value, 0 disables the check
+ * @retval None
+ */
+void ReportFilter_setThresholds(ReportFilter_t *filter, float deadband, float rate)
+{
+    filter->deadband = deadband;
+    filter->rate = rate;
+    filter->hasReported = false;
+}
+
+/**
+ * @brief  Check a new value, it becomes the previous value of the next check
+ * @param  filter Pointer to the filter
+ * @param  value New value
+ * @param  now Current time in ms
+ * @retval true if the value has to be reported, false otherwise
+ */
+bool ReportFilter_check(ReportFilter_t *filter, float value, uint32_t now)
+{
+    bool report = !filter->hasReported ||
+                  ((filter->deadband <= 0) && (filter->rate <= 0));
+
+    if ((filter->deadband > 0) && (fabsf(value - filter->reported) >= filter->deadband))
+    {
+        report = true;
+    }
+    if ((filter->rate > 0) && filter->hasPrevious && (now != filter->previousTime))
+    {
+        float perSecond = fabsf(value - filter->previous) * 1000 / (uint32_t)(now - filter->previousTime);
+        if (perSecond >= filter->rate)
+        {
+            report = true;
+        }
+    }
+    filter->previous = value;
+    filter->previousTime = now;
+    filter->hasPrevious = true;
+    return report;
+}
+
+/**
+ * @brief  Take the value of the last check as reported
+ * @param  filter Pointer to the filter
+ * @retval None
+ */
+void ReportFilter_commit(ReportFilter_t *filter)
+{
+    filter->reported = filter->previous;
+    filter->hasReported = true;
+}
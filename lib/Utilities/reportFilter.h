@@ -0,0 +1,62 @@
+/**
+ * \file
+ * \brief Report-by-exception filter of a telemetry channel.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+#ifndef REPORT_FILTER_H
+#define REPORT_FILTER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Decides whether a new value of a channel is worth publishing. A value is
+ * reported when it differs from the last reported value by at least the
+ * deadband, or when it changed faster than the rate since the previous
+ * value. A threshold of 0 disables that check, with both disabled every
+ * value is reported. A zero initialized filter reports every value.
+ */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    typedef struct
+    {
+        float deadband;         /* change since the last report */
+        float rate;             /* change per second since the previous value */
+        float reported;         /* last reported value */
+        float previous;         /* last value checked */
+        uint32_t previousTime;  /* ms */
+        bool hasReported;
+        bool hasPrevious;
+    } ReportFilter_t;
+
+    void ReportFilter_setThresholds(ReportFilter_t *filter, float deadband, float rate);
+    bool ReportFilter_check(ReportFilter_t *filter, float value, uint32_t now);
+    void ReportFilter_commit(ReportFilter_t *filter);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* REPORT_FILTER_H */
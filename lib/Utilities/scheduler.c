@@ -0,0 +1,176 @@
+/**
+ * \file
+ * \brief Cooperative run to completion task scheduler.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#include <stddef.h>
+
+#include "ConfigPlatform.h"
+#include "scheduler.h"
+
+static Scheduler_task_t *tasks[SCHEDULER_MAX_TASKS];
+static uint8_t taskCount = 0;
+
+/**
+ * @brief  Register a task, it stays inactive until it is started
+ * @param  task Pointer to the task, must stay valid
+ * @retval true if successful, false if the task table is full
+ */
+bool Scheduler_add(Scheduler_task_t *task)
+{
+    if (taskCount >= SCHEDULER_MAX_TASKS)
+    {
+        return false;
+    }
+    tasks[taskCount++] = task;
+    return true;
+}
+
+/**
+ * @brief  Activate a task
+ * @param  task Pointer to the task
+ * @param  delay Time until the first run in ms
+ * @param  period Time between runs in ms, 0 to run the task once
+ * @retval None
+ */
+void Scheduler_start(Scheduler_task_t *task, uint32_t delay, uint32_t period)
+{
+    task->period = period;
+    task->deadline = millis() + delay;
+    task->active = true;
+}
+
+/**
+ * @brief  Move the next run of an active task, e.g. from within the task to
+ *         wait instead of blocking
+ * @param  task Pointer to the task
+ * @param  delay Time from now until the next run in ms
+ * @retval None
+ */
+void Scheduler_delay(Scheduler_task_t *task, uint32_t delay)
+{
+    task->deadline = millis() + delay;
+    task->active = true;
+}
+
+/**
+ * @brief  Change the period of a task, takes effect after the next run
+ * @param  task Pointer to the task
+ * @param  period Time between runs in ms
+ * @retval None
+ */
+void Scheduler_setPeriod(Scheduler_task_t *task, uint32_t period)
+{
+    task->period = period;
+}
+
+/**
+ * @brief  Deactivate a task
+ * @param  task Pointer to the task
+ * @retval None
+ */
+void Scheduler_stop(Scheduler_task_t *task)
+{
+    task->active = false;
+}
+
+/**
+ * @brief  Run the most urgent due task
+ * @retval true if a task was run, false if none was due
+ */
+bool Scheduler_run()
+{
+    Scheduler_task_t *next = NULL;
+    uint32_t now = millis();
+
+    for (uint8_t i = 0; i < taskCount; i++)
+    {
+        Scheduler_task_t *task = tasks[i];
+        if (!task->active || ((int32_t)(now - task->deadline) < 0))
+        {
+            continue;
+        }
+        if ((next == NULL) || (task->priority < next->priority) ||
+            ((task->priority == next->priority) &&
+             ((int32_t)(task->deadline - next->deadline) < 0)))
+        {
+            next = task;
+        }
+    }
+    if (next == NULL)
+    {
+        return false;
+    }
+
+    uint32_t lateness = now - next->deadline;
+    if (lateness > next->statistics.maxLateness)
+    {
+        next->statistics.maxLateness = lateness;
+    }
+
+    /*Reschedule first, so the task can stop itself or move its deadline*/
+    if (next->period == 0)
+    {
+        next->active = false;
+    }
+    else if (lateness >= next->period)
+    {
+        /*Missed runs are dropped instead of run back to back*/
+        next->deadline = now + next->period;
+    }
+    else
+    {
+        next->deadline += next->period;
+    }
+
+    uint32_t start = micros();
+    next->function(next->context);
+    uint32_t runtime = micros() - start;
+
+    next->statistics.runs++;
+    next->statistics.lastRuntime = runtime;
+    next->statistics.totalRuntime += runtime;
+    if (runtime > next->statistics.maxRuntime)
+    {
+        next->statistics.maxRuntime = runtime;
+    }
+    return true;
+}
+
+/**
+ * @brief  Get the number of registered tasks
+ * @retval Number of tasks
+ */
+uint8_t Scheduler_getTaskCount()
+{
+    return taskCount;
+}
+
+/**
+ * @brief  Get a registered task, e.g. to report its statistics
+ * @param  index Index of the task in the order of registration
+ * @retval Pointer to the task, NULL if the index is out of range
+ */
+const Scheduler_task_t *Scheduler_getTask(uint8_t index)
+{
+    return (index < taskCount) ? tasks[index] : NULL;
+}
@@ -0,0 +1,87 @@
+/**
+ * \file
+ * \brief Cooperative run to completion task scheduler.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Tasks are owned by the caller and registered once. Scheduler_run() runs
+ * the due task with the highest priority (lowest number, earliest deadline
+ * first among equal priorities) to completion. Deadlines are millis()
+ * values, so the scheduler only needs the Arduino time base.
+ */
+#ifndef SCHEDULER_MAX_TASKS
+#define SCHEDULER_MAX_TASKS 10
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    typedef void (*Scheduler_function_t)(void *context);
+
+    typedef struct
+    {
+        uint32_t runs;
+        uint32_t lastRuntime;  /* us */
+        uint32_t maxRuntime;   /* us */
+        uint32_t totalRuntime; /* us, wraps after about 71 minutes of run time */
+        uint32_t maxLateness;  /* ms between the deadline and the start */
+    } Scheduler_statistics_t;
+
+    typedef struct
+    {
+        const char *name;
+        Scheduler_function_t function;
+        void *context;
+        uint8_t priority;
+        uint32_t period; /* ms, 0 for one-shot tasks */
+        uint32_t deadline;
+        bool active;
+        Scheduler_statistics_t statistics;
+    } Scheduler_task_t;
+
+#define SCHEDULER_TASK(name, function, context, priority)          \
+    {                                                              \
+        (name), (function), (context), (priority), 0, 0, false, { 0 } \
+    }
+
+    bool Scheduler_add(Scheduler_task_t *task);
+    void Scheduler_start(Scheduler_task_t *task, uint32_t delay, uint32_t period);
+    void Scheduler_delay(Scheduler_task_t *task, uint32_t delay);
+    void Scheduler_setPeriod(Scheduler_task_t *task, uint32_t period);
+    void Scheduler_stop(Scheduler_task_t *task);
+    bool Scheduler_run();
+    uint8_t Scheduler_getTaskCount();
+    const Scheduler_task_t *Scheduler_getTask(uint8_t index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SCHEDULER_H */
@@ -141,7 +141,7 @@ int8_t HIDS_Set_Measurement_Type(WE_sensorInterface_t *sensorInterface, hids_mea
 	status = HIDS_WriteData(sensorInterface, &temp, 1);
 
 	/* mandatory wait for measurement to be performed, see user manual of 2525020210002 */
-	WE_Delay(10);
+	WE_Delay(HIDS_MEASUREMENT_TIME_MS);
 	if (status != WE_SUCCESS)
 	{
 		/* error! */
@@ -167,6 +167,31 @@ int8_t HIDS_Sensor_Measure_Raw(WE_sensorInterface_t *sensorInterface, hids_measu
 		return WE_FAIL;
 	}
 
+	return HIDS_Sensor_Read_Raw(sensorInterface, temperatureRaw, humidityRaw);
+}
+
+/**
+ * @brief Start a measurement without waiting for it, read the result with
+ * HIDS_Sensor_Read_Raw() after HIDS_MEASUREMENT_TIME_MS
+ * @param[in] sensorInterface Pointer to sensor interface
+ * @param[in] measureCmd Measurement command
+ * @retval Error code
+ */
+int8_t HIDS_Sensor_Start_Measurement(WE_sensorInterface_t *sensorInterface, hids_measureCmd_t measureCmd)
+{
+	uint8_t temp = measureCmd;
+	return HIDS_WriteData(sensorInterface, &temp, 1);
+}
+
+/**
+ * @brief Read the result of a measurement in milli values
+ * @param[in] sensorInterface Pointer to sensor interface
+ * @param[out] Temperature value in milli
+ * @param[out] Humidity value in milli
+ * @retval Error code
+ */
+int8_t HIDS_Sensor_Read_Raw(WE_sensorInterface_t *sensorInterface, int32_t *temperatureRaw, int32_t *humidityRaw)
+{
 	uint8_t dataBytes[6] = {0};
 	int8_t status = WE_FAIL;
 	uint16_t t_ticks = 0;
@@ -273,6 +298,6 @@ int8_t HIDS_Reset(WE_sensorInterface_t *sensorInterface)
 		/* error! */
 		return WE_FAIL;
 	}
-	WE_Delay(10);
+	WE_Delay(HIDS_MEASUREMENT_TIME_MS);
 	return WE_SUCCESS;
 }
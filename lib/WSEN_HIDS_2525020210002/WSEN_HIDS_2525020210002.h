@@ -41,6 +41,7 @@
 #define CRC8_POLYNOMIAL 0x31
 #define CRC8_LEN 1
 #define HIDS_WORD_SIZE 2
+#define HIDS_MEASUREMENT_TIME_MS 10 /* wait between a measurement command and the readout */
 
 typedef enum
 {
@@ -67,6 +68,8 @@ int8_t HIDS_Sensor_Read_SlNo(WE_sensorInterface_t* sensorInterface, uint32_t* se
 int8_t HIDS_Sensor_Init(WE_sensorInterface_t* sensorInterface);
 int8_t HIDS_Reset(WE_sensorInterface_t* sensorInterface);
 int8_t HIDS_Sensor_Measure_Raw(WE_sensorInterface_t* sensorInterface, hids_measureCmd_t meausureCmd, int32_t* temperatureRaw, int32_t* humidityRaw);
+int8_t HIDS_Sensor_Start_Measurement(WE_sensorInterface_t* sensorInterface, hids_measureCmd_t measureCmd);
+int8_t HIDS_Sensor_Read_Raw(WE_sensorInterface_t* sensorInterface, int32_t* temperatureRaw, int32_t* humidityRaw);
 int8_t HIDS_Get_Default_Interface(WE_sensorInterface_t* sensorInterface);
 #ifdef __cplusplus
 }
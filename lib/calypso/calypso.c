@@ -179,6 +179,72 @@ bool Calypso_decodeBase64(uint8_t *inputData, uint32_t inputLength, uint8_t *out
 
     return true;
 }
+/**
+ * @brief  Reset a streaming base64 decoder
+ * @param  decoder Pointer to the decoder state
+ * @retval none
+ */
+void Calypso_initBase64Decoder(Calypso_Base64Decoder_t *decoder)
+{
+    decoder->value = 0;
+    decoder->count = 0;
+    decoder->padding = 0;
+}
+
+/**
+ * @brief  Decode a part of a base64 stream. Characters of an incomplete
+ *         quadruple are kept in the decoder until the next call.
+ * @param  decoder Pointer to the decoder state
+ * @param  inputData Pointer to the base64 characters
+ * @param  inputLength Number of characters
+ * @param  outputData Pointer to output data, at least 3 * (inputLength + 3) / 4 bytes
+ * @param  outputLength Pointer to the number of decoded bytes
+ * @retval true if successful false in case of invalid input
+ */
+bool Calypso_decodeBase64Stream(Calypso_Base64Decoder_t *decoder, const uint8_t *inputData, uint32_t inputLength, uint8_t *outputData, uint32_t *outputLength)
+{
+    uint32_t i, j;
+
+    if ((decoder == NULL) || (outputData == NULL))
+    {
+        return false;
+    }
+
+    for (i = 0, j = 0; i < inputLength; i++)
+    {
+        uint8_t sextet = 0;
+        if (inputData[i] == '=')
+        {
+            decoder->padding++;
+        }
+        else if ((decoder->padding == 0) && (inputData[i] < sizeof(Calypso_base64DecTable)))
+        {
+            sextet = Calypso_base64DecTable[inputData[i]];
+        }
+        else
+        {
+            return false;
+        }
+
+        decoder->value = (decoder->value << 6) | sextet;
+        decoder->count++;
+
+        if (decoder->count == 4)
+        {
+            outputData[j++] = (decoder->value >> 2 * 8) & 0xFF;
+            if (decoder->padding < 2)
+                outputData[j++] = (decoder->value >> 1 * 8) & 0xFF;
+            if (decoder->padding < 1)
+                outputData[j++] = (decoder->value >> 0 * 8) & 0xFF;
+            decoder->value = 0;
+            decoder->count = 0;
+        }
+    }
+    *outputLength = j;
+
+    return true;
+}
+
 /**
  * @brief  Encode data using base64 encoding
  * @param  inputData Pointer to the input data.
@@ -895,7 +961,7 @@ bool ATMQTT_addArgumentsSubscribe(char *pAtCommand, uint8_t index, uint8_t numOf
  * @RetVal true if arguments were added successful
  * false otherwise
  */
-bool ATFile_AddArgumentsFileOpen(char *pAtCommand, const char *fileName, uint32_t options, uint16_t fileSize)
+bool ATFile_AddArgumentsFileOpen(char *pAtCommand, const char *fileName, uint32_t options, uint32_t fileSize)
 {
     bool ret = false;
 
@@ -1025,7 +1091,7 @@ bool ATFile_AddArgumentsFileDel(char *pAtCommand, const char *fileName, uint32_t
  * @RetVal true if arguments were added successful
  * false otherwise
  */
-bool ATFile_AddArgumentsFileRead(char *pAtCommand, uint32_t fileID, uint16_t offset, Calypso_DataFormat_t format, uint16_t bytesToRead)
+bool ATFile_AddArgumentsFileRead(char *pAtCommand, uint32_t fileID, uint32_t offset, Calypso_DataFormat_t format, uint16_t bytesToRead)
 {
     bool ret = false;
 
@@ -1073,7 +1139,7 @@ bool ATFile_AddArgumentsFileRead(char *pAtCommand, uint32_t fileID, uint16_t off
  * @RetVal true if arguments were added successful
  * false otherwise
  */
-bool ATFile_AddArgumentsFileWrite(char *pAtCommand, uint32_t fileID, uint16_t offset, Calypso_DataFormat_t format, bool encodeToBase64, uint16_t bytesToWrite, char *pData)
+bool ATFile_AddArgumentsFileWrite(char *pAtCommand, uint32_t fileID, uint32_t offset, Calypso_DataFormat_t format, bool encodeToBase64, uint16_t bytesToWrite, char *pData)
 {
     bool ret = false;
 
@@ -265,6 +265,14 @@ extern "C"
         Calypso_DataFormat_NumberOfValues,
     } Calypso_DataFormat_t;
 
+    /* State of a base64 decode spread over several calls */
+    typedef struct Calypso_Base64Decoder_t
+    {
+        uint32_t value;
+        uint8_t count;
+        uint8_t padding;
+    } Calypso_Base64Decoder_t;
+
     typedef struct ATMQTT_connectionParams_t
     {
         ATMQTT_ProtocolVersion_t protocolVersion;
@@ -302,8 +310,11 @@ extern "C"
     bool Calypso_appendArgumentString(char *pOutString, const char *pInArgument, char delimeter);
     bool ATWLAN_addConnectionArguments(char *pOutString, ATWLAN_ConnectionArguments_t connectionArgs, char lastDelim);
     bool Calypso_getNextArgumentString(char **pInArguments, char *pOutargument, char delim);
+    uint32_t Calypso_getBase64EncBufSize(uint32_t inputLength);
     bool Calypso_encodeBase64(uint8_t *inputData, uint32_t inputLength, uint8_t *outputData, uint32_t *outputLength);
     bool Calypso_decodeBase64(uint8_t *inputData, uint32_t inputLength, uint8_t *outputData, uint32_t *outputLength);
+    void Calypso_initBase64Decoder(Calypso_Base64Decoder_t *decoder);
+    bool Calypso_decodeBase64Stream(Calypso_Base64Decoder_t *decoder, const uint8_t *inputData, uint32_t inputLength, uint8_t *outputData, uint32_t *outputLength);
     bool Calypso_getCmdName(char **pInAtCmd, char *pCmdName, char delim);
     bool Calypso_getNextArgumentInt(char **pInArguments, void *pOutargument, uint16_t intflags, char delim);
     bool ATSocket_parseSocketFamily(const char *familyString, ATSocket_Family_t *pOutFamily);
@@ -317,11 +328,11 @@ extern "C"
     bool ATMQTT_addArgumentsPublish(char *pAtCommand, uint8_t index, char *topicString, ATMQTT_QoS_t QoS, uint8_t retain, uint16_t messageLength, char *pMessage);
     bool ATMQTT_addArgumentsSubscribe(char *pAtCommand, uint8_t index, uint8_t numOfTopics, ATMQTT_subscribeTopic_t *pTopics);
 
-    bool ATFile_AddArgumentsFileOpen(char *pAtCommand, const char *fileName, uint32_t options, uint16_t fileSize);
+    bool ATFile_AddArgumentsFileOpen(char *pAtCommand, const char *fileName, uint32_t options, uint32_t fileSize);
     bool ATFile_AddArgumentsFileClose(char *pAtCommand, uint32_t fileID, const char *certName, const char *signature);
     bool ATFile_AddArgumentsFileDel(char *pAtCommand, const char *fileName, uint32_t secureToken);
-    bool ATFile_AddArgumentsFileRead(char *pAtCommand, uint32_t fileID, uint16_t offset, Calypso_DataFormat_t format, uint16_t bytesToRead);
-    bool ATFile_AddArgumentsFileWrite(char *pAtCommand, uint32_t fileID, uint16_t offset, Calypso_DataFormat_t format, bool encodeToBase64, uint16_t bytesToWrite, char *data);
+    bool ATFile_AddArgumentsFileRead(char *pAtCommand, uint32_t fileID, uint32_t offset, Calypso_DataFormat_t format, uint16_t bytesToRead);
+    bool ATFile_AddArgumentsFileWrite(char *pAtCommand, uint32_t fileID, uint32_t offset, Calypso_DataFormat_t format, bool encodeToBase64, uint16_t bytesToWrite, char *data);
 
     bool ATFile_ParseResponseFileOpen(char **pAtCommand, uint32_t *fileID, uint32_t *secureToken);
     bool ATFile_ParseResponseFileRead(char **pAtCommand, Calypso_DataFormat_t *pOutFormat, uint16_t *bytesRead, char *data);
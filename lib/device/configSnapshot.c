@@ -0,0 +1,315 @@
+/**
+ * \file
+ * \brief Binary snapshot of the device configuration for a fast boot.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#include <string.h>
+
+#include "configSnapshot.h"
+
+#define CONFIG_SNAPSHOT_HEADER_SIZE 16
+
+static uint32_t ConfigSnapshot_layoutHash(const ConfigSchema_entry_t *schema, uint8_t count);
+static uint32_t ConfigSnapshot_crc32(const uint8_t *data, uint16_t length);
+static void ConfigSnapshot_put16(uint8_t *data, uint16_t value);
+static void ConfigSnapshot_put32(uint8_t *data, uint32_t value);
+static uint16_t ConfigSnapshot_get16(const uint8_t *data);
+static uint32_t ConfigSnapshot_get32(const uint8_t *data);
+
+/**
+ * @brief  Start recording a snapshot
+ * @param  snapshot Pointer to the snapshot
+ * @param  buffer Buffer receiving the snapshot file
+ * @param  bufferSize Size of the buffer
+ * @retval None
+ */
+void ConfigSnapshot_begin(ConfigSnapshot_t *snapshot, uint8_t *buffer, uint16_t bufferSize)
+{
+    snapshot->buffer = buffer;
+    snapshot->size = bufferSize;
+    snapshot->length = CONFIG_SNAPSHOT_HEADER_SIZE;
+    snapshot->position = CONFIG_SNAPSHOT_HEADER_SIZE;
+    snapshot->restoring = false;
+    snapshot->valid = (bufferSize >= CONFIG_SNAPSHOT_HEADER_SIZE);
+}
+
+/**
+ * @brief  Record the members bound with a schema
+ * @param  snapshot Pointer to the snapshot
+ * @param  schema Schema entries
+ * @param  count Number of schema entries
+ * @param  bases Destinations the schema was bound to
+ * @retval true if the members fit into the snapshot
+ */
+bool ConfigSnapshot_record(ConfigSnapshot_t *snapshot, const ConfigSchema_entry_t *schema,
+                           uint8_t count, void *const *bases)
+{
+    uint16_t length = snapshot->length;
+
+    if (!snapshot->valid || ((snapshot->size - length) < 4))
+    {
+        snapshot->valid = false;
+        return false;
+    }
+    ConfigSnapshot_put32(&snapshot->buffer[length], ConfigSnapshot_layoutHash(schema, count));
+    length += 4;
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        const ConfigSchema_entry_t *entry = &schema[i];
+        const uint8_t *member = (const uint8_t *)bases[entry->base] + entry->offset;
+        uint16_t needed = entry->size;
+
+        if (entry->type == ConfigSchema_String)
+        {
+            const uint8_t *terminator = (const uint8_t *)memchr(member, '\0', entry->size);
+            if (terminator == NULL)
+            {
+                snapshot->valid = false;
+                return false;
+            }
+            needed = (uint16_t)(terminator - member) + 1;
+        }
+        if ((snapshot->size - length) < needed)
+        {
+            snapshot->valid = false;
+            return false;
+        }
+        memcpy(&snapshot->buffer[length], member, needed);
+        length += needed;
+    }
+    snapshot->length = length;
+    return true;
+}
+
+/**
+ * @brief  Store a recorded snapshot
+ * @param  calypso Pointer to the calypso object.
+ * @param  snapshot Pointer to the recorded snapshot
+ * @param  fingerprint Fingerprint of the configuration file
+ * @retval true if successful false if the snapshot is incomplete or can not
+ *         be written
+ */
+bool ConfigSnapshot_save(CALYPSO *calypso, ConfigSnapshot_t *snapshot, uint32_t fingerprint)
+{
+    uint8_t *buffer = snapshot->buffer;
+    uint16_t payloadLength = snapshot->length - CONFIG_SNAPSHOT_HEADER_SIZE;
+
+    if (!snapshot->valid || snapshot->restoring)
+    {
+        return false;
+    }
+    ConfigSnapshot_put16(&buffer[0], CONFIG_SNAPSHOT_MAGIC);
+    buffer[2] = CONFIG_SNAPSHOT_VERSION;
+    buffer[3] = 0;
+    ConfigSnapshot_put32(&buffer[4], fingerprint);
+    ConfigSnapshot_put16(&buffer[8], payloadLength);
+    ConfigSnapshot_put16(&buffer[10], 0);
+    ConfigSnapshot_put32(&buffer[12], ConfigSnapshot_crc32(&buffer[CONFIG_SNAPSHOT_HEADER_SIZE],
+                                                           payloadLength));
+
+    return Calypso_writeFileBulk(calypso, CONFIG_SNAPSHOT_PATH, buffer, snapshot->length,
+                                 false, NULL);
+}
+
+/**
+ * @brief  Load the snapshot of a configuration file for restoring
+ * @param  calypso Pointer to the calypso object.
+ * @param  fingerprint Fingerprint of the current configuration file
+ * @param  snapshot Pointer to the snapshot
+ * @param  buffer Buffer for the snapshot file, must stay valid while restoring
+ * @param  bufferSize Size of the buffer
+ * @retval true if there is a valid snapshot of the configuration file
+ */
+bool ConfigSnapshot_load(CALYPSO *calypso, uint32_t fingerprint, ConfigSnapshot_t *snapshot,
+                         uint8_t *buffer, uint16_t bufferSize)
+{
+    uint16_t length = 0;
+    uint16_t payloadLength;
+
+    /* The header holds the length, the file information is not requested */
+    if (!Calypso_readFileOfSize(calypso, CONFIG_SNAPSHOT_PATH, 0, (char *)buffer,
+                                bufferSize, &length) ||
+        (length < CONFIG_SNAPSHOT_HEADER_SIZE))
+    {
+        return false;
+    }
+
+    payloadLength = ConfigSnapshot_get16(&buffer[8]);
+    if ((ConfigSnapshot_get16(&buffer[0]) != CONFIG_SNAPSHOT_MAGIC) ||
+        (buffer[2] != CONFIG_SNAPSHOT_VERSION) ||
+        (ConfigSnapshot_get32(&buffer[4]) != fingerprint) ||
+        (payloadLength != (length - CONFIG_SNAPSHOT_HEADER_SIZE)) ||
+        (ConfigSnapshot_get32(&buffer[12]) !=
+         ConfigSnapshot_crc32(&buffer[CONFIG_SNAPSHOT_HEADER_SIZE], payloadLength)))
+    {
+        return false;
+    }
+
+    snapshot->buffer = buffer;
+    snapshot->size = bufferSize;
+    snapshot->length = length;
+    snapshot->position = CONFIG_SNAPSHOT_HEADER_SIZE;
+    snapshot->restoring = true;
+    snapshot->valid = true;
+    return true;
+}
+
+/**
+ * @brief  Restore the members of the next schema of a loaded snapshot
+ * @param  snapshot Pointer to the loaded snapshot
+ * @param  schema Schema entries, the same as when recording
+ * @param  count Number of schema entries
+ * @param  bases Destinations of the members
+ * @retval true if successful false if the snapshot does not match the schema,
+ *         members may then be partly restored
+ */
+bool ConfigSnapshot_restore(ConfigSnapshot_t *snapshot, const ConfigSchema_entry_t *schema,
+                            uint8_t count, void *const *bases)
+{
+    const uint8_t *data = &snapshot->buffer[snapshot->position];
+    const uint8_t *end = &snapshot->buffer[snapshot->length];
+
+    if (!snapshot->valid || !snapshot->restoring || ((end - data) < 4) ||
+        (ConfigSnapshot_get32(data) != ConfigSnapshot_layoutHash(schema, count)))
+    {
+        snapshot->valid = false;
+        return false;
+    }
+    data += 4;
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        const ConfigSchema_entry_t *entry = &schema[i];
+        uint8_t *member = (uint8_t *)bases[entry->base] + entry->offset;
+        uint16_t length = entry->size;
+
+        /* The checksum matched, the bounds protect against a changed format */
+        if (entry->type == ConfigSchema_String)
+        {
+            uint16_t available = ((end - data) < entry->size) ? (uint16_t)(end - data) : entry->size;
+            const uint8_t *terminator = (const uint8_t *)memchr(data, '\0', available);
+            if (terminator == NULL)
+            {
+                snapshot->valid = false;
+                return false;
+            }
+            length = (uint16_t)(terminator - data) + 1;
+        }
+        else if ((end - data) < length)
+        {
+            snapshot->valid = false;
+            return false;
+        }
+        memcpy(member, data, length);
+        data += length;
+    }
+    snapshot->position = (uint16_t)(data - snapshot->buffer);
+    return true;
+}
+
+/**
+ * @brief  Delete the configuration snapshot
+ * @param  calypso Pointer to the calypso object.
+ * @retval None
+ */
+void ConfigSnapshot_delete(CALYPSO *calypso)
+{
+    if (Calypso_fileExists(calypso, CONFIG_SNAPSHOT_PATH))
+    {
+        Calypso_deleteFile(calypso, CONFIG_SNAPSHOT_PATH);
+    }
+}
+
+/**
+ * @brief  Hash the destinations of a schema, a snapshot is only restored
+ *         into the layout it was recorded from
+ * @param  schema Schema entries
+ * @param  count Number of schema entries
+ * @retval FNV-1a hash of type, destination and size of the entries
+ */
+static uint32_t ConfigSnapshot_layoutHash(const ConfigSchema_entry_t *schema, uint8_t count)
+{
+    uint32_t hash = 2166136261UL;
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        uint8_t layout[6] = {(uint8_t)schema[i].type, schema[i].base,
+                             (uint8_t)schema[i].offset, (uint8_t)(schema[i].offset >> 8),
+                             (uint8_t)schema[i].size, (uint8_t)(schema[i].size >> 8)};
+        for (uint8_t j = 0; j < sizeof(layout); j++)
+        {
+            hash ^= layout[j];
+            hash *= 16777619UL;
+        }
+        /*An object is recorded as a whole, its members change the layout too*/
+        if (schema[i].type == ConfigSchema_Object)
+        {
+            hash ^= ConfigSnapshot_layoutHash(schema[i].members, schema[i].memberCount);
+            hash *= 16777619UL;
+        }
+    }
+    return hash;
+}
+
+/**
+ * @brief  Calculate the CRC-32 (IEEE 802.3) of a buffer
+ * @param  data Pointer to the data
+ * @param  length Number of bytes
+ * @retval CRC of the data
+ */
+static uint32_t ConfigSnapshot_crc32(const uint8_t *data, uint16_t length)
+{
+    uint32_t crc = 0xFFFFFFFFUL;
+    for (uint16_t i = 0; i < length; i++)
+    {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320UL & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+static void ConfigSnapshot_put16(uint8_t *data, uint16_t value)
+{
+    data[0] = (uint8_t)value;
+    data[1] = (uint8_t)(value >> 8);
+}
+
+static void ConfigSnapshot_put32(uint8_t *data, uint32_t value)
+{
+    ConfigSnapshot_put16(data, (uint16_t)value);
+    ConfigSnapshot_put16(data + 2, (uint16_t)(value >> 16));
+}
+
+static uint16_t ConfigSnapshot_get16(const uint8_t *data)
+{
+    return (uint16_t)(data[0] | (data[1] << 8));
+}
+
+static uint32_t ConfigSnapshot_get32(const uint8_t *data)
+{
+    return ((uint32_t)ConfigSnapshot_get16(data) |
+            ((uint32_t)ConfigSnapshot_get16(data + 2) << 16));
+}
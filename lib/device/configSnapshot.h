@@ -0,0 +1,86 @@
+/**
+ * \file
+ * \brief Binary snapshot of the device configuration for a fast boot.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#ifndef CONFIG_SNAPSHOT_H
+#define CONFIG_SNAPSHOT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "calypsoBoard.h"
+#include "configSchema.h"
+
+/*
+ * After the configuration file has been parsed and bound once, the values
+ * bound by the schemas are stored in a binary snapshot file:
+ *
+ *   header  magic (2), version (1), reserved (1),
+ *           fingerprint of the JSON file (4), payload length (2),
+ *           reserved (2), CRC-32 of the payload (4)
+ *   schema  layout hash of the schema (4), then the bound members in
+ *           schema order: strings with their terminator, numbers with the
+ *           size of the member
+ *
+ * Restoring copies the values straight back into the structures of the
+ * same schemas, neither JSON nodes are built nor keys matched. The schemas
+ * have to be restored in the order they were recorded, the layout hash
+ * rejects a snapshot written by firmware with other schemas. The snapshot
+ * is only used as long as the fingerprint of the JSON file is unchanged.
+ */
+#define CONFIG_SNAPSHOT_PATH "user/devconfbin"
+#define CONFIG_SNAPSHOT_MAGIC 0xC5F1
+#define CONFIG_SNAPSHOT_VERSION 2
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief Snapshot being recorded or restored
+     */
+    typedef struct
+    {
+        uint8_t *buffer;
+        uint16_t size;     /* of the buffer */
+        uint16_t length;   /* recorded bytes or bytes of the loaded file */
+        uint16_t position; /* of the next schema to restore */
+        bool restoring;
+        bool valid;        /* false once a schema did not fit or match */
+    } ConfigSnapshot_t;
+
+    void ConfigSnapshot_begin(ConfigSnapshot_t *snapshot, uint8_t *buffer, uint16_t bufferSize);
+    bool ConfigSnapshot_record(ConfigSnapshot_t *snapshot, const ConfigSchema_entry_t *schema,
+                               uint8_t count, void *const *bases);
+    bool ConfigSnapshot_save(CALYPSO *calypso, ConfigSnapshot_t *snapshot, uint32_t fingerprint);
+    bool ConfigSnapshot_load(CALYPSO *calypso, uint32_t fingerprint, ConfigSnapshot_t *snapshot,
+                             uint8_t *buffer, uint16_t bufferSize);
+    bool ConfigSnapshot_restore(ConfigSnapshot_t *snapshot, const ConfigSchema_entry_t *schema,
+                                uint8_t count, void *const *bases);
+    void ConfigSnapshot_delete(CALYPSO *calypso);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_SNAPSHOT_H */
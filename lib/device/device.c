@@ -22,17 +22,25 @@
  * IN THE ROOT DIRECTORY OF THIS PACKAGE
  */
 
+#include <stdlib.h>
 #include <string.h>
 
-#include "json-builder.h"
+#include "json.h"
+#include "jsonWriter.h"
+#include "fixedFormat.h"
 #include "device.h"
 #include "time.h"
+#include "clock.h"
 #include "debug.h"
+#include "compress.h"
+#include "latency.h"
+#include "arena.h"
+#include "history.h"
+#include "configSnapshot.h"
+#include "cbor.h"
+#include "aggregate.h"
 
-#include "mosquitto.h"
-#include "azure_iot_central.h"
-#include "aws.h"
-#include "kaaiot.h"
+#include "cloudAdapter.h"
 
 #define MAX_PACKET_LOSS 3
 
@@ -44,27 +52,29 @@ TypeHardwareSerial *SerialCalypso;
 //------Calpyso
 CALYPSO *calypso;
 
-float PADS_pressure, PADS_temp;
-float ITDS_accelX, ITDS_accelY, ITDS_accelZ, ITDS_temp;
 bool ITDS_doubleTapEvent, ITDS_freeFallEvent;
-float TIDS_temp;
-float HIDS_humidity, HIDS_temp;
-
-bool sensorsPresent;
 
 int messageID = 0;
 int sessionID = 0;
 bool deviceProvisioned = false;
 bool deviceConfigured = false;
-bool hids1_detected = false;
-bool hids2_detected = false;
 
-uint8_t configVersion = 0;
+/*Adapter of the configured cloud, NULL until the configuration is loaded*/
+static const CloudAdapter_t *cloud = NULL;
+/*Snapshot recorded or restored by Device_bindConfiguration while loading*/
+static ConfigSnapshot_t *configSnapshot = NULL;
 
 volatile unsigned long telemetrySendInterval = (unsigned long)(DEFAULT_TELEMETRY_SEND_INTEVAL * 1000);
 
 uint8_t packetLost = 0;
+#if LATENCY_INSTRUMENTATION
+static uint16_t publishCount = 0;
+#endif
 
+static uint8_t reconnectAttempts = 0;
+static unsigned long reconnectBackoff = RECONNECT_BACKOFF_MIN;
+static unsigned long reconnectStart = 0;
+static unsigned long reconnectDelay = 0;
 
 char endPointAddress[MAX_URL_LEN] = {0};
 uint16_t endPointAddrLen = 0;
@@ -73,9 +83,169 @@ static char displayText[128];
 
 static char sensorPayload[MAX_PAYLOAD_LENGTH];
 
+/*Parsed JSON lives in the arena, it is reset for every message*/
+static uint64_t jsonArenaMemory[JSON_ARENA_SIZE / sizeof(uint64_t)];
+static Arena_t jsonArena;
+static json_settings jsonSettings = {0, 0, Arena_jsonAlloc, Arena_jsonFree, &jsonArena, 0};
+
+/*Report-by-exception heartbeat, all sensors are published at least this often*/
+static unsigned long reportHeartbeat = REPORT_HEARTBEAT_INTERVAL * 1000UL;
+static unsigned long lastFullReport = 0;
+static bool fullReportSent = false;
+
+/*Report-by-exception thresholds of a sensor*/
+typedef struct
+{
+    float deadband;
+    float rate;
+} Device_ReportThresholds_t;
+
+/*Keys of the sensors in the report settings, see Sensors_getKey()*/
+static const char *const reportSensorKeys[] = {"pressure", "humidity", "temperature", "acceleration"};
+#define DEVICE_REPORT_SENSORS (sizeof(reportSensorKeys) / sizeof(reportSensorKeys[0]))
+
+/*Report-by-exception settings, the sensors in the order of reportSensorKeys*/
+typedef struct
+{
+    uint32_t heartbeat; /* s */
+    Device_ReportThresholds_t sensors[DEVICE_REPORT_SENSORS];
+} Device_ReportSettings_t;
+
+/*Members of the configuration read by the device itself*/
+typedef struct
+{
+    uint8_t version;
+    uint16_t sendInterval; /* s */
+    Device_ReportSettings_t report;
+} Device_config_t;
+
+/*A threshold that is not given is disabled*/
+static const ConfigSchema_entry_t reportThresholdSchema[] = {
+    CONFIG_FLOAT("deadband", CONFIG_SCHEMA_NO_POSITION, false, 0, Device_ReportThresholds_t,
+                 deadband, 0),
+    CONFIG_FLOAT("rate", CONFIG_SCHEMA_NO_POSITION, false, 0, Device_ReportThresholds_t, rate, 0),
+};
+
+/*Sensors that are not given keep their thresholds*/
+static const ConfigSchema_entry_t reportSchema[] = {
+    CONFIG_UNSIGNED("heartbeat", CONFIG_SCHEMA_NO_POSITION, false, 0, Device_ReportSettings_t,
+                    heartbeat, CONFIG_SCHEMA_UNCHANGED),
+    CONFIG_OBJECT("pressure", CONFIG_SCHEMA_NO_POSITION, false, 0, Device_ReportSettings_t,
+                  sensors[0], reportThresholdSchema),
+    CONFIG_OBJECT("humidity", CONFIG_SCHEMA_NO_POSITION, false, 0, Device_ReportSettings_t,
+                  sensors[1], reportThresholdSchema),
+    CONFIG_OBJECT("temperature", CONFIG_SCHEMA_NO_POSITION, false, 0, Device_ReportSettings_t,
+                  sensors[2], reportThresholdSchema),
+    CONFIG_OBJECT("acceleration", CONFIG_SCHEMA_NO_POSITION, false, 0, Device_ReportSettings_t,
+                  sensors[3], reportThresholdSchema),
+};
+
+static const ConfigSchema_entry_t deviceSchema[] = {
+    CONFIG_UNSIGNED("configVersion", 0, true, 0, Device_config_t, version, 0),
+    CONFIG_UNSIGNED("telemetrySendFrequency", CONFIG_SCHEMA_NO_POSITION, false, 0,
+                    Device_config_t, sendInterval, DEFAULT_TELEMETRY_SEND_INTEVAL),
+    CONFIG_OBJECT("reportByException", CONFIG_SCHEMA_NO_POSITION, false, 0, Device_config_t,
+                  report, reportSchema),
+};
+
+static unsigned long lastHistorySample = 0;
+static bool historySampled = false;
+typedef struct
+{
+    uint16_t length;
+    uint16_t records;
+    bool failed;
+} Device_HistoryBatch_t;
+
+/*State of the SAX handlers that extract cloud commands*/
+#define DEVICE_SAX_KEY_LEN 16
+typedef struct
+{
+    uint8_t depth;
+    char key[DEVICE_SAX_KEY_LEN];    /* last key seen */
+    char parent[DEVICE_SAX_KEY_LEN]; /* key of the enclosing object */
+} Device_SaxState_t;
+
+typedef struct
+{
+    Device_SaxState_t sax;
+    uint32_t from;
+    uint32_t to;
+    bool found;
+} Device_HistoryRequest_t;
+
+typedef struct
+{
+    Device_SaxState_t sax;
+    Device_LedCommand_t *command;
+    uint8_t fields;
+} Device_LedRequest_t;
+
+static const ATMQTT_QoS_t messageClassQoS[Device_MessageClass_NumberOfValues] = {
+    TELEMETRY_QOS,
+    DIAGNOSTICS_QOS,
+    HISTORY_QOS,
+    ACCELERATION_STREAM_QOS};
+static uint32_t messageClassSequence[Device_MessageClass_NumberOfValues] = {0};
+#if TELEMETRY_COMPRESSION
+static uint8_t compressedPayload[COMPRESS_BOUND(MAX_PAYLOAD_LENGTH)];
+#endif
+
+#if CONFIG_UPDATE
+/*Configuration file received on the configuration topic, filled by the
+stream sink and stored by Device_processCloudMessage*/
+typedef struct
+{
+    uint8_t data[CONFIG_FILE_MAX_SIZE];
+    uint16_t length;
+    bool overflow;
+    bool complete;
+} Device_ConfigUpdate_t;
+
+static Device_ConfigUpdate_t configUpdate;
+static char configTopic[DEVICE_TOPIC_LENGTH] = {0};
+#endif
+
 static bool Device_loadConfiguration();
-static char *Device_SerializeData();
+static bool Device_applyConfiguration(json_value *configuration);
+static json_value *Device_parseJson(const char *json, size_t length);
+static char *Device_SerializeData(uint16_t *length, uint32_t sensors);
+static bool Device_telemetryCbor();
+static uint16_t Device_SerializeDataCbor(uint32_t sensors);
+static bool Device_publish(Device_MessageClass_t messageClass, char *data, int length);
+static void Device_addSequence(JsonWriter_t *writer, Device_MessageClass_t messageClass);
 static void removeChar(char *s, char c);
+static uint16_t Device_receiveCloudMessage(bool wait);
+static void Device_handleCloudMessage(uint16_t length);
+static void Device_clearCloudMessage();
+static bool Device_handleHistoryRequest(const char *message, uint16_t length);
+static int Device_saxObjectStart(void *user_data);
+static int Device_saxObjectEnd(void *user_data);
+static int Device_saxKey(void *user_data, const json_char *name, unsigned int length);
+static int Device_historyObjectStart(void *user_data);
+static int Device_historyValue(void *user_data, const json_value *value);
+static int Device_ledValue(void *user_data, const json_value *value);
+static void Device_writeChannels(JsonWriter_t *writer, Sensors_Statistic_t statistic,
+                                 uint32_t sensors);
+static void Device_writeChannelsCbor(CborWriter_t *writer, Sensors_Statistic_t statistic,
+                                     uint32_t sensors);
+static uint8_t Device_countSensors(uint32_t sensors);
+static void Device_getReportSettings(Device_ReportSettings_t *report);
+static bool Device_setReportSettings(const Device_ReportSettings_t *report);
+static bool Device_parseLedCommandCbor(const uint8_t *message, uint16_t length,
+                                       Device_LedCommand_t *command);
+static void Device_formatQuantity(char *buffer, size_t size, Sensors_Quantity_t quantity);
+static bool Device_historySink(void *context, const History_record_t *record);
+static bool Device_publishHistoryBatch(Device_HistoryBatch_t *batch);
+#if CONFIG_UPDATE
+static void Device_configUpdateSink(void *context, const char *topic, const uint8_t *data,
+                                    uint16_t length, uint32_t offset, bool last);
+static void Device_storeConfigUpdate(const uint8_t *data, uint16_t length);
+static bool Device_validateConfiguration(const json_value *configuration);
+static bool Device_replaceConfiguration(const uint8_t *data, uint16_t length);
+static void Device_recoverConfigUpdate(char *buffer, uint16_t size);
+#endif
+
 
 /**
  * @brief Initialize all components of a device.
@@ -100,62 +270,15 @@ TypeSerial *Device_init(void *Debug, void *CalypsoSerial)
                    (uint8_t)((0x10ul) | (0x1ul) | (0x400ul)));
 
     calypso = Calypso_Create(SerialDebug, SerialCalypso, &calypsoParams);
+    Arena_init(&jsonArena, jsonArenaMemory, sizeof(jsonArenaMemory));
 
     if (!sensorBoard_Init())
     {
         SSerial_printf(SerialDebug,"I2C init failed \r\n");
-        sensorsPresent = false;
-    }
-
-    // Initialize the sensors in default mode
-    if (!PADS_2511020213301_simpleInit())
-    {
-        SSerial_printf(SerialDebug,"PADS init failed \r\n");
-        sensorsPresent = false;
-    }
-    else
-    {
-        sensorsPresent = true;
-    }
-
-    if (!ITDS_2533020201601_simpleInit())
-    {
-        SSerial_printf(SerialDebug,"ITDS init failed \r\n");
-        sensorsPresent = false;
     }
     else
     {
-        sensorsPresent = true;
-    }
-
-    if (!TIDS_2521020222501_simpleInit())
-    {
-        SSerial_printf(SerialDebug,"TIDS init failed \r\n");
-        sensorsPresent = false;
-    }
-    else
-    {
-        sensorsPresent = true;
-    }
-
-    if (!HIDS_2525020210002_simpleInit())
-    {
-        //Check if the old HIDS sensor is present
-        if (!HIDS_2525020210001_simpleInit())
-        {
-            SSerial_printf(SerialDebug,"HIDS init failed \r\n");
-            sensorsPresent = false;
-        }
-        else
-        {
-            sensorsPresent = true;
-            hids1_detected = true;
-        }
-    }
-    else
-    {
-        sensorsPresent = true;
-        hids2_detected = true;
+        SSerial_printf(SerialDebug, "%u sensors found\r\n", Sensors_init());
     }
 
     SSerial_printf(SerialDebug, "Starting the application v%s\r\n", HOST_FIRMWARE_VERSION);
@@ -166,8 +289,13 @@ TypeSerial *Device_init(void *Debug, void *CalypsoSerial)
         sprintf(displayText, "Calypso Init Failed...");
         SH1107_Display(1, 0, 24, displayText);
     }
+    /*Load the file directory once, file existence checks are answered from RAM*/
+    Calypso_fileList(calypso);
+    History_init(calypso);
     messageID = 0;
     packetLost = 0;
+    /*Seed the reconnect jitter, start-up timing differs between devices*/
+    srand(micros());
 
     // Device_writeConfigFiles();
     sprintf(displayText, "Loading configuration...");
@@ -198,59 +326,163 @@ TypeSerial *Device_init(void *Debug, void *CalypsoSerial)
     return SerialDebug;
 }
 /**
- * @brief Load device configuration from the stored file
+ * @brief Load device configuration from the stored file. While the JSON file
+ * is unchanged, the values bound from it are restored from the binary
+ * snapshot, otherwise the JSON is parsed and bound and a new snapshot is
+ * stored.
  *
  * @return true - Config load success
  * @return false - Config load failed
  */
 bool Device_loadConfiguration()
 {
-    char configBuf[512];
+#if CONFIG_UPDATE
+    /*Unused until the device subscribes to the configuration topic*/
+    char *configBuf = (char *)configUpdate.data;
+#else
+    char configBuf[CONFIG_FILE_MAX_SIZE];
+#endif
+    ConfigSnapshot_t snapshot;
+    json_value *configuration = NULL;
+    uint32_t fingerprint = 0;
+    uint32_t size = 0;
+    bool fingerprintValid;
+    bool ret;
     uint16_t len;
+#if CONFIG_UPDATE
+    Device_recoverConfigUpdate(configBuf, CONFIG_FILE_MAX_SIZE);
+#endif
     if (!Calypso_fileExists(calypso, CONFIG_FILE_PATH))
     {
         return false;
     }
 
-    if (Calypso_readFile(calypso, CONFIG_FILE_PATH, (char *)configBuf, 512, &len))
+    /*One file information request validates the snapshot and sizes the read*/
+    fingerprintValid = Calypso_fileGetFingerprint(calypso, CONFIG_FILE_PATH, &fingerprint, &size);
+    if (fingerprintValid &&
+        ConfigSnapshot_load(calypso, fingerprint, &snapshot, (uint8_t *)configBuf, CONFIG_FILE_MAX_SIZE))
     {
-        json_value *configuration = json_parse(configBuf, len);
-        if (configuration == NULL)
+        configSnapshot = &snapshot;
+        ret = Device_applyConfiguration(NULL);
+        configSnapshot = NULL;
+        if (ret)
         {
-            SSerial_printf(SerialDebug, "Unable to parse config file\r\n");
-            return false;
-        }
-        
-        configVersion = configuration->u.object.values[0].value->u.integer;
-        switch (configVersion)
-        {
-            case MOSQUITTO_CONFIG_VERSION:
-                Mosquitto_loadConfiguration(configuration, calypso);
-                break;
-
-            case AZURE_IOT_PNP_CONFIG_VERSION:
-                Azure_loadConfiguration(configuration, calypso);
-                break;
-
-            case AWS_IOT_CORE_CONFIG_VERSION:
-                AWS_loadConfiguration(configuration, calypso);
-                break;
-            
-            case KAA_IOT_CONFIG_VERSION:
-                Kaa_loadConfiguration(configuration, calypso);
-                break;
-            
-            default:
-                return false;
-                break;
+            SSerial_printf(SerialDebug, "Config loaded from snapshot\r\n");
+            return true;
         }
-       
+        /*Everything restored so far is bound again from the JSON file*/
+        SSerial_printf(SerialDebug, "Config snapshot does not match\r\n");
+    }
+
+    if (!Calypso_readFileOfSize(calypso, CONFIG_FILE_PATH, fingerprintValid ? size : 0,
+                                (char *)configBuf, CONFIG_FILE_MAX_SIZE, &len))
+    {
+        return false;
+    }
+    if (len >= CONFIG_FILE_MAX_SIZE)
+    {
+        SSerial_printf(SerialDebug, "Config file exceeds %u bytes\r\n", (unsigned int)CONFIG_FILE_MAX_SIZE);
+        return false;
+    }
+    configuration = Device_parseJson(configBuf, len);
+    if (configuration == NULL)
+    {
+        SSerial_printf(SerialDebug, "Unable to parse config file\r\n");
+        return false;
+    }
+
+    /*The parsed values are copies, the file buffer records the bound values*/
+    ConfigSnapshot_begin(&snapshot, (uint8_t *)configBuf, CONFIG_FILE_MAX_SIZE);
+    configSnapshot = &snapshot;
+    ret = Device_applyConfiguration(configuration);
+    configSnapshot = NULL;
+    if (ret && fingerprintValid && !ConfigSnapshot_save(calypso, &snapshot, fingerprint))
+    {
+        SSerial_printf(SerialDebug, "Config snapshot not stored\r\n");
+    }
+    Arena_reset(&jsonArena);
+    return ret;
+}
+
+/**
+ * @brief Pass the configuration to the adapter of the configured cloud.
+ * @param configuration Configuration object, NULL while restoring the snapshot.
+ * @retval true if successful, false otherwise.
+ */
+static bool Device_applyConfiguration(json_value *configuration)
+{
+    bool loaded;
+    Device_config_t config;
+    void *bases[] = {&config};
+
+    Device_getReportSettings(&config.report);
+    if (!Device_bindConfiguration(deviceSchema, sizeof(deviceSchema) / sizeof(deviceSchema[0]),
+                                  configuration, bases))
+    {
+        return false;
+    }
+    if ((config.sendInterval > MAX_TELEMETRY_SEND_INTERVAL) ||
+        (config.sendInterval < MIN_TELEMETRY_SEND_INTERVAL))
+    {
+        SSerial_printf(SerialDebug, "Config telemetrySendFrequency: out of range\r\n");
     }
     else
     {
+        telemetrySendInterval = (unsigned long)config.sendInterval * 1000;
+    }
+    cloud = CloudAdapter_find(config.version);
+    if (cloud == NULL)
+    {
+        SSerial_printf(SerialDebug, "Cloud %u not built in\r\n", (unsigned int)config.version);
         return false;
     }
-    return true;
+    SSerial_printf(SerialDebug, "Cloud: %s\r\n", cloud->name);
+    loaded = cloud->loadConfiguration(configuration, calypso);
+    /*Optional for every cloud*/
+    if (loaded && !Device_setReportSettings(&config.report))
+    {
+        SSerial_printf(SerialDebug, "Invalid report settings\r\n");
+    }
+    return loaded;
+}
+
+/**
+ * @brief Bind the members of the configuration with a schema and report all
+ * invalid members. While the configuration is loaded, the bound values are
+ * recorded in the snapshot or restored from it.
+ * @param schema Schema entries.
+ * @param count Number of schema entries.
+ * @param configuration JSON configuration object, NULL while restoring.
+ * @param bases Destinations, indexed by the base of the entries.
+ * @retval true if all members are valid, false otherwise.
+ */
+bool Device_bindConfiguration(const ConfigSchema_entry_t *schema, uint8_t count,
+                              const json_value *configuration, void *const *bases)
+{
+    ConfigSchema_result_t result;
+    bool bound;
+
+    if ((configSnapshot != NULL) && configSnapshot->restoring)
+    {
+        return ConfigSnapshot_restore(configSnapshot, schema, count, bases);
+    }
+    bound = ConfigSchema_bind(schema, count, configuration, bases, &result);
+    if (bound && (configSnapshot != NULL))
+    {
+        ConfigSnapshot_record(configSnapshot, schema, count, bases);
+    }
+
+    for (uint8_t i = 0; (i < result.errorCount) && (i < CONFIG_SCHEMA_MAX_ERRORS); i++)
+    {
+        SSerial_printf(SerialDebug, "Config %s: %s\r\n", result.errors[i].key,
+                       ConfigSchema_getStatusName(result.errors[i].status));
+    }
+    if (result.errorCount > CONFIG_SCHEMA_MAX_ERRORS)
+    {
+        SSerial_printf(SerialDebug, "%u more config errors\r\n",
+                       (unsigned int)(result.errorCount - CONFIG_SCHEMA_MAX_ERRORS));
+    }
+    return bound;
 }
 
 /**
@@ -278,6 +510,82 @@ bool Device_isStatusOK()
     }
 }
 
+/**
+ * @brief Keep the cloud connection up. A lost Wi-Fi or broker connection is
+ *        re-established with exponential backoff and jitter, reusing the
+ *        existing MQTT client.
+ * @retval true if connected to the cloud, false otherwise.
+ */
+bool Device_maintainConnection()
+{
+    if (calypso->status == calypso_MQTT_connected)
+    {
+        return true;
+    }
+    if ((reconnectAttempts > 0) && ((millis() - reconnectStart) < reconnectDelay))
+    {
+        return false;
+    }
+    if (reconnectAttempts >= MAX_RECONNECT_ATTEMPTS)
+    {
+        SSerial_printf(SerialDebug, "Reconnect failed, restarting\r\n");
+        calypso->status = calypso_error;
+        return false;
+    }
+    reconnectAttempts++;
+    SSerial_printf(SerialDebug, "Reconnecting, attempt %u\r\n", reconnectAttempts);
+    sprintf(displayText, "Reconnecting to \r\nEnd point...");
+    SH1107_Display(1, 0, 24, displayText);
+
+    if (calypso->status == calypso_WLAN_disconnected)
+    {
+        /*Calypso may already have rejoined using the stored profile*/
+        if (!Calypso_isIPConnected(calypso))
+        {
+            Calypso_WLANconnect(calypso);
+        }
+    }
+    if (calypso->status != calypso_WLAN_disconnected)
+    {
+        if (reconnectAttempts > RECONNECT_RECREATE_ATTEMPTS)
+        {
+            /*The client may be stale, start over with a fresh one*/
+            Calypso_MQTTDisconnect(calypso);
+            Calypso_MQTTconnect(calypso);
+        }
+        else
+        {
+            Calypso_MQTTReconnect(calypso);
+        }
+    }
+
+    if (calypso->status == calypso_MQTT_connected)
+    {
+        SSerial_printf(SerialDebug, "Reconnected after %u attempts\r\n", reconnectAttempts);
+        sprintf(displayText, "Connected to \r\nend point");
+        SH1107_Display(1, 0, 24, displayText);
+        /*Subscriptions survive only if the broker resumed the session*/
+        if (!calypso->sessionPresent)
+        {
+            Device_SubscribeToTopics();
+        }
+        packetLost = 0;
+        reconnectAttempts = 0;
+        reconnectBackoff = RECONNECT_BACKOFF_MIN;
+        return true;
+    }
+
+    /*Wait between backoff/2 and backoff before the next attempt*/
+    reconnectDelay = (reconnectBackoff / 2) + (rand() % ((reconnectBackoff / 2) + 1));
+    reconnectStart = millis();
+    reconnectBackoff = reconnectBackoff * 2;
+    if (reconnectBackoff > RECONNECT_BACKOFF_MAX)
+    {
+        reconnectBackoff = RECONNECT_BACKOFF_MAX;
+    }
+    return false;
+}
+
 /**
  * @brief Check if the device is connected to the Wi-Fi network.
  * @retval true if connected, false otherwise.
@@ -340,17 +648,11 @@ bool Device_isConfigured()
  */
 bool Device_provision()
 {
-    switch (configVersion)
+    if ((cloud == NULL) || (cloud->provision == NULL))
     {
-    case AZURE_IOT_PNP_CONFIG_VERSION:
-        return (Azure_deviceProvision(calypso));
-        break;
-    
-    default:
         return false;
-        break;
     }
-
+    return cloud->provision(calypso);
 }
 
 /**
@@ -411,18 +713,25 @@ void Device_configurationInProgress()
  */
 void Device_readSensors()
 {
-    if (PADS_2511020213301_readSensorData(&PADS_pressure, &PADS_temp))
-    {
-        SSerial_printf(SerialDebug,"WSEN_PADS: Atm. Pres: %f kPa Temp: %f °C\r\n",
-                       PADS_pressure, PADS_temp);
-    }
-    if (ITDS_2533020201601_readSensorData(&ITDS_accelX, &ITDS_accelY,
-                                          &ITDS_accelZ, &ITDS_temp))
+    char value[FIXEDFORMAT_BUFFER_SIZE];
+    uint32_t collected = Sensors_readNow(false);
+
+    for (uint8_t i = 0; i < Sensors_getCount(); i++)
     {
-        SSerial_printf(SerialDebug,
-            "WSEN_ITDS(Acceleration): X:%f g Y:%f g  Z:%f g Temp: "
-            "%f °C \r\n",
-            ITDS_accelX, ITDS_accelY, ITDS_accelZ, ITDS_temp);
+        const Sensors_descriptor_t *sensor = Sensors_get(i);
+        if ((collected & ((uint32_t)1 << i)) == 0)
+        {
+            continue;
+        }
+        for (uint8_t c = 0; c < sensor->channelCount; c++)
+        {
+            const Sensors_channel_t *channel = &sensor->channels[c];
+            float reading;
+            Sensors_getValue(channel->quantity, &reading);
+            FixedFormat_float(value, sizeof(value), reading, channel->decimals);
+            SSerial_printf(SerialDebug, "%s: %s %s %s\r\n", sensor->name, channel->name,
+                           value, channel->unit);
+        }
     }
     if (ITDS_2533020201601_readDoubleTapEvent(&ITDS_doubleTapEvent))
     {
@@ -434,30 +743,16 @@ void Device_readSensors()
         SSerial_printf(SerialDebug,"WSEN_ITDS(FreeFall): State %s \r\n",
                        ITDS_freeFallEvent ? "True" : "False");
     }
-    if (TIDS_2521020222501_readSensorData(&TIDS_temp))
-    {
-        SSerial_printf(SerialDebug,"WSEN_TIDS(Temperature): %f °C\r\n", TIDS_temp);
-    }
-
-    if(hids1_detected == true)
-    {
-        if (HIDS_2525020210001_readSensorData(&HIDS_humidity, &HIDS_temp))
-        {
-            SSerial_printf(SerialDebug,"WSEN_HIDS: RH: %f %% Temp: %f °C\r\n", HIDS_humidity,
-                        HIDS_temp);
-        }
-    }
-
-    if(hids2_detected == true)
-    {
-        if (HIDS_2525020210002_readSensorData(&HIDS_humidity, &HIDS_temp))
-        {
-            SSerial_printf(SerialDebug,"WSEN_HIDS: RH: %f %% Temp: %f °C\r\n", HIDS_humidity,
-                        HIDS_temp);
-        }
-    }
 }
 
+/**
+ * @brief Sample the sensors in the background of the telemetry interval.
+ * @retval Time in ms until the sampling has to run again.
+ */
+unsigned long Device_sampleSensors()
+{
+    return Sensors_sample();
+}
 
 /**
  * @brief Connect device to cloud MQTT server.
@@ -466,9 +761,10 @@ void Device_readSensors()
 void Device_ConnectToCloud()
 {
     strcpy(calypso->settings.mqttSettings.serverInfo.address, endPointAddress);
-    if (configVersion == AZURE_IOT_PNP_CONFIG_VERSION)
+    calypso->settings.mqttSettings.cleanSession = MQTT_CLEAN_SESSION;
+    if ((cloud != NULL) && (cloud->beforeConnect != NULL))
     {
-        Azure_setUserName(calypso);
+        cloud->beforeConnect(calypso);
     }
     if (Calypso_MQTTconnect(calypso) == true)
     {
@@ -482,9 +778,9 @@ void Device_ConnectToCloud()
         SSerial_printf(calypso->serialDebug, "MQTT connect fail\r\n");
     }
     Device_SubscribeToTopics();
-    if (configVersion == AZURE_IOT_PNP_CONFIG_VERSION)
+    if ((cloud != NULL) && (cloud->afterConnect != NULL))
     {
-        Azure_PublishProperties(calypso);
+        cloud->afterConnect(calypso);
     }
 }
 
@@ -494,30 +790,28 @@ void Device_ConnectToCloud()
  */
 bool Device_SubscribeToTopics()
 {
-    bool ret;
-    switch (configVersion)
+    if (cloud == NULL)
     {
-        case MOSQUITTO_CONFIG_VERSION:
-            ret = Mosquitto_SubscribeToTopics(calypso);
-            break;
-
-        case AZURE_IOT_PNP_CONFIG_VERSION:
-            ret = Azure_SubscribeToTopics(calypso);
-            break;
-
-        case AWS_IOT_CORE_CONFIG_VERSION:
-            ret = AWS_SubscribeToTopics(calypso);
-            break;
-        
-        case KAA_IOT_CONFIG_VERSION:
-            ret = Kaa_SubscribeToTopics(calypso);
-            break;
-
-        default:
-            ret = false;
-            break;
+        return false;
     }
-    return ret;
+    if (!cloud->subscribe(calypso))
+    {
+        return false;
+    }
+#if CONFIG_UPDATE
+    if (cloud->configTopic != NULL)
+    {
+        ATMQTT_subscribeTopic_t topic;
+
+        snprintf(configTopic, sizeof(configTopic), cloud->configTopic,
+                 calypso->settings.mqttSettings.clientID);
+        topic.QoS = ATMQTT_QOS_QOS1;
+        strcpy(topic.topicString, configTopic);
+        Calypso_MQTTsetStreamSink(calypso, Device_configUpdateSink, &configUpdate);
+        return Calypso_subscribe(calypso, 0, 1, &topic);
+    }
+#endif
+    return true;
 }
 
 
@@ -529,124 +823,515 @@ bool Device_SubscribeToTopics()
 json_value *Device_GetCloudResponse()
 {
     json_value *response = NULL;
-    if ((Calypso_MQTTgetMessage(calypso, true)) && (calypso->rxData.length > 4))
+    uint16_t length = Device_receiveCloudMessage(true);
+    if (length > 0)
     {
-        response = json_parse(calypso->rxData.data, calypso->rxData.length);
-        memset(calypso->rxData.data, 0, CALYPSO_LINE_MAX_SIZE);
-        calypso->rxData.length = 0;
-    }
-    else
-    {
-        //SSerial_printf(SerialDebug, "No message\r\n");
+        response = Device_parseJson(calypso->rxData.data, length);
+        Device_clearCloudMessage();
     }
     return response;
 }
 
+/**
+ * @brief Release a message returned by Device_GetCloudResponse. This also
+ * invalidates all messages received before.
+ * @param response JSON message or NULL.
+ * @retval None.
+ */
+void Device_FreeCloudResponse(json_value *response)
+{
+    (void)response;
+    Arena_reset(&jsonArena);
+}
+
 /**
  * @brief Publish the values of sensors connected to the device.
  * @retval None.
  */
 void Device_PublishSensorData()
 {
-    Device_readSensors();
-    char *dataSerialized = Device_SerializeData();
+    LATENCY_BEGIN();
+    LATENCY_MARK(LATENCY_POINT_READ_START);
+    /*Sensors without a sample in this interval, e.g. when the interval is
+    shorter than their sample period*/
+    Sensors_readNow(true);
+    LATENCY_MARK(LATENCY_POINT_READ_END);
+    LATENCY_MARK(LATENCY_POINT_SERIALIZE_START);
+    bool fullReport = !fullReportSent ||
+                      ((reportHeartbeat != 0) && ((millis() - lastFullReport) >= reportHeartbeat));
+    uint32_t reportedSensors = Sensors_selectReport(fullReport);
+    if (reportedSensors == 0)
+    {
+        /*No channel moved beyond its thresholds*/
+        Sensors_resetAggregates();
+        LATENCY_END(false);
+        return;
+    }
+    uint16_t serializedLength;
+    char *dataSerialized = Device_SerializeData(&serializedLength, reportedSensors);
+    /*The next interval starts, also if the publish fails*/
+    Sensors_resetAggregates();
+    LATENCY_MARK(LATENCY_POINT_SERIALIZE_END);
+    if (dataSerialized == NULL)
+    {
+        LATENCY_END(false);
+        return;
+    }
+    int dataLength = serializedLength;
 #if SERIAL_DEBUG
     // SSerial_writeB(SerialDebug, dataSerialized, strlen(dataSerialized));
     // SSerial_printf(SerialDebug, "\r\n");
 #endif
-    if (!Calypso_MQTTPublishData(calypso, calypso->telemetryPubTopic, 1, dataSerialized, strlen(dataSerialized), true))
+#if TELEMETRY_COMPRESSION
+    if (cloud->telemetryCompression && !Device_telemetryCbor())
+    {
+        uint16_t compressedLength;
+        if (Compress_encode((uint8_t *)dataSerialized, dataLength, compressedPayload,
+                            sizeof(compressedPayload), &compressedLength))
+        {
+            dataSerialized = (char *)compressedPayload;
+            dataLength = compressedLength;
+        }
+    }
+#endif
+    if (!Device_publish(Device_MessageClass_Telemetry, dataSerialized, dataLength))
     {
+        LATENCY_END(false);
         packetLost++;
         SSerial_printf(SerialDebug, "Publish failed %u\r\n", packetLost);
         if (packetLost == MAX_PACKET_LOSS)
         {
-            calypso->status = calypso_error;
+            /*Broker is unreachable without a disconnect event, reconnect*/
+            calypso->status = calypso_MQTT_disconnected;
         }
+        return;
+    }
+    LATENCY_END(true);
+    Sensors_commitReport(reportedSensors);
+    if (fullReport)
+    {
+        lastFullReport = millis();
+        fullReportSent = true;
     }
+#if LATENCY_INSTRUMENTATION
+    publishCount++;
+    if (publishCount >= LATENCY_REPORT_INTERVAL)
+    {
+        publishCount = 0;
+        Device_PublishDiagnostics();
+    }
+#endif
 }
 
-
 /**
- * @brief Display sensor data on OLED display.
+ * @brief Publish the last acceleration sample as one message of the
+ * acceleration stream.
  * @retval None.
  */
-void Device_displaySensorData()
+void Device_PublishAccelerationStream()
 {
-    sprintf(displayText, "Status: Connected\r\nP:%0.2f kPa\r\nT:%0.2f C\r\nRH:%0.2f %%\r\nAcc: x:%0.2f g\r\n     y:%0.2f g\r\n     z:%0.2f g",
-            PADS_pressure,
-            TIDS_temp,
-            HIDS_humidity,
-            ITDS_accelX,
-            ITDS_accelY,
-            ITDS_accelZ);
-    SH1107_Display(1, 0, 0, displayText);
+    static const Sensors_Quantity_t axes[] = {Sensors_Quantity_AccelerationX,
+                                              Sensors_Quantity_AccelerationY,
+                                              Sensors_Quantity_AccelerationZ};
+    static const char *const axisNames[] = {"x", "y", "z"};
+    char payload[ACCELERATION_STREAM_PAYLOAD_LENGTH];
+    JsonWriter_t writer;
+    size_t length;
+    float value;
+
+    JsonWriter_init(&writer, payload, sizeof(payload));
+    JsonWriter_beginObject(&writer, NULL);
+    JsonWriter_beginObject(&writer, "acceleration");
+    for (uint8_t axis = 0; axis < 3; axis++)
+    {
+        if (!Sensors_getValue(axes[axis], &value))
+        {
+            /*No accelerometer found*/
+            return;
+        }
+        JsonWriter_float(&writer, axisNames[axis], value, ACCELERATION_DECIMALS);
+    }
+    JsonWriter_endObject(&writer);
+    Device_addSequence(&writer, Device_MessageClass_Acceleration);
+    JsonWriter_endObject(&writer);
+
+    length = JsonWriter_finish(&writer);
+    if ((length == 0) ||
+        !Device_publish(Device_MessageClass_Acceleration, payload, length))
+    {
+        SSerial_printf(SerialDebug, "Acceleration publish failed\r\n");
+    }
 }
 
 /**
- * @brief Process messages from the cloud.
+ * @brief Print the publish latency statistics and publish them to the
+ * diagnostics topic of the cloud, if it has one.
  * @retval None.
  */
-void Device_processCloudMessage()
+void Device_PublishDiagnostics()
 {
-    json_value *cloudResponse = NULL;
+    JsonWriter_t writer;
+    size_t length;
 
-    cloudResponse = Device_GetCloudResponse();
-
-    switch (configVersion)
+    JsonWriter_init(&writer, sensorPayload, MAX_PAYLOAD_LENGTH);
+    JsonWriter_beginObject(&writer, NULL);
+    JsonWriter_beginObject(&writer, "latency_us");
+    for (uint8_t stage = 0; stage < LATENCY_STAGE_COUNT; stage++)
+    {
+        const Latency_histogram_t *histogram = Latency_getHistogram((Latency_stage_t)stage);
+        uint32_t p50 = Latency_getPercentile((Latency_stage_t)stage, 50);
+        uint32_t p90 = Latency_getPercentile((Latency_stage_t)stage, 90);
+        uint32_t p99 = Latency_getPercentile((Latency_stage_t)stage, 99);
+
+        SSerial_printf(SerialDebug, "Latency %s: n=%lu p50=%lu p90=%lu p99=%lu max=%lu us\r\n",
+                       Latency_getStageName((Latency_stage_t)stage), histogram->count,
+                       p50, p90, p99, histogram->max);
+
+        JsonWriter_beginObject(&writer, Latency_getStageName((Latency_stage_t)stage));
+        JsonWriter_integer(&writer, "n", histogram->count);
+        JsonWriter_integer(&writer, "p50", p50);
+        JsonWriter_integer(&writer, "p90", p90);
+        JsonWriter_integer(&writer, "p99", p99);
+        JsonWriter_integer(&writer, "max", histogram->max);
+        JsonWriter_endObject(&writer);
+    }
+    JsonWriter_endObject(&writer);
+
+    SSerial_printf(SerialDebug, "JSON arena: peak %u of %u bytes, %lu failed allocations\r\n",
+                   (unsigned int)jsonArena.highWaterMark, (unsigned int)jsonArena.size,
+                   (unsigned long)jsonArena.failures);
+    JsonWriter_beginObject(&writer, "json_arena");
+    JsonWriter_integer(&writer, "size", jsonArena.size);
+    JsonWriter_integer(&writer, "peak", jsonArena.highWaterMark);
+    JsonWriter_integer(&writer, "failures", jsonArena.failures);
+    JsonWriter_endObject(&writer);
+
+    if ((cloud == NULL) || (cloud->diagnosticsTopic == NULL))
     {
-        case MOSQUITTO_CONFIG_VERSION:
-            Mosquitto_ProcessCloudMessage(cloudResponse, calypso);
-            break;
+        return;
+    }
+    Device_addSequence(&writer, Device_MessageClass_Diagnostics);
+    JsonWriter_endObject(&writer);
 
-        case AZURE_IOT_PNP_CONFIG_VERSION:
-            Azure_ProcessCloudMessage(cloudResponse, calypso);
-            break;
+    length = JsonWriter_finish(&writer);
+    if (length == 0)
+    {
+        SSerial_printf(SerialDebug, "Diagnostics too long \r\n");
+        return;
+    }
+    if (!Device_publish(Device_MessageClass_Diagnostics, sensorPayload, length))
+    {
+        SSerial_printf(SerialDebug, "Diagnostics publish failed\r\n");
+    }
+}
 
-        case AWS_IOT_CORE_CONFIG_VERSION:
-            AWS_ProcessCloudMessage(cloudResponse, calypso);
-            break;
 
-        case KAA_IOT_CONFIG_VERSION:
-            Kaa_ProcessCloudMessage(cloudResponse, calypso);
-            break;
+/**
+ * @brief Synchronize the clock with the SNTP time of Calypso.
+ * @retval true if Calypso knows the time, false otherwise.
+ */
+bool Device_syncClock()
+{
+    Timestamp now;
 
-        default:
-            break;
-    }
-    if (cloudResponse != NULL)
+    Timer_initTime(&now);
+    unsigned long requested = millis();
+    if (!Calypso_getTimestamp(calypso, &now) || (now.year < 2022))
     {
-        json_value_free(cloudResponse);
+        return false;
     }
+    /*The module reports whole seconds, take the middle of the second and of
+    the request*/
+    Clock_sync(Time_ConvertToUnix(&now) * 1000ULL + 500,
+               requested + (millis() - requested) / 2);
+    SSerial_printf(SerialDebug, "Clock synchronized, drift %ld ppm\r\n",
+                   (long)Clock_getDrift());
+    return true;
 }
 
 /**
- * @brief Connect to WiFi.
+ * @brief Store a sample in the local history once per HISTORY_SAMPLE_INTERVAL.
+ * Samples are only recorded once the clock is synchronized.
  * @retval None.
  */
-void Device_connect_WiFi()
+void Device_recordHistory()
 {
-    if (!Calypso_WLANconnect(calypso))
+    History_record_t record;
+
+    if ((Sensors_getCount() == 0) ||
+        (historySampled && ((millis() - lastHistorySample) < (HISTORY_SAMPLE_INTERVAL * 1000UL))))
     {
-        SSerial_printf(calypso->serialDebug, "WiFi connect fail\r\n");
-        sprintf(displayText, "Error: Wi-Fi connect \r\nfailed");
-        SH1107_Display(1, 0, 24, displayText);
         return;
     }
-    delay(WI_FI_CONNECT_DELAY);
-    if (calypso->status == calypso_WLAN_connected)
+    lastHistorySample = millis();
+    historySampled = true;
+
+    if (!Clock_isSynced())
     {
-        sprintf(displayText, "Connected to Wi-Fi");
-        SH1107_Display(1, 0, 24, displayText);
+        return;
     }
-    if (!Calypso_setUpSNTP(calypso))
+    Device_readSensors();
+    record.timestamp = (uint32_t)(Clock_now() / 1000);
+    record.temperature = (int16_t)Sensors_getScaledValue(Sensors_Quantity_Temperature);
+    record.humidity = (uint16_t)Sensors_getScaledValue(Sensors_Quantity_Humidity);
+    record.pressure = (uint16_t)Sensors_getScaledValue(Sensors_Quantity_Pressure);
+    record.accelX = (int16_t)Sensors_getScaledValue(Sensors_Quantity_AccelerationX);
+    record.accelY = (int16_t)Sensors_getScaledValue(Sensors_Quantity_AccelerationY);
+    record.accelZ = (int16_t)Sensors_getScaledValue(Sensors_Quantity_AccelerationZ);
+    if (!History_append(&record))
     {
-        SSerial_printf(calypso->serialDebug, "SNTP config fail\r\n");
+        SSerial_printf(SerialDebug, "History write failed\r\n");
     }
 }
 
 /**
- * @brief Disconnect from WiFi.
- * @retval None.
+ * @brief Publish the stored samples of a time range. Samples are sent in
+ * batches of {"history":[[time,temperature,humidity,pressure,x,y,z],...]}
+ * using the scaled integer values of the history records.
+ * @param from Start of the range, Unix time in seconds.
+ * @param to End of the range, Unix time in seconds.
+ * @retval true if successful, false otherwise.
+ */
+bool Device_PublishHistory(uint32_t from, uint32_t to)
+{
+    Device_HistoryBatch_t batch = {0, 0, false};
+
+    if (!History_query(from, to, Device_historySink, &batch))
+    {
+        return false;
+    }
+    /* The last batch is also sent when empty to terminate the answer */
+    return Device_publishHistoryBatch(&batch) && !batch.failed;
+}
+
+/**
+ * @brief Display sensor data on OLED display.
+ * @retval None.
+ */
+void Device_displaySensorData()
+{
+    char pressure[DISPLAY_VALUE_SIZE];
+    char temperature[DISPLAY_VALUE_SIZE];
+    char humidity[DISPLAY_VALUE_SIZE];
+    char accelX[DISPLAY_VALUE_SIZE];
+    char accelY[DISPLAY_VALUE_SIZE];
+    char accelZ[DISPLAY_VALUE_SIZE];
+
+    Device_formatQuantity(pressure, sizeof(pressure), Sensors_Quantity_Pressure);
+    Device_formatQuantity(temperature, sizeof(temperature), Sensors_Quantity_Temperature);
+    Device_formatQuantity(humidity, sizeof(humidity), Sensors_Quantity_Humidity);
+    Device_formatQuantity(accelX, sizeof(accelX), Sensors_Quantity_AccelerationX);
+    Device_formatQuantity(accelY, sizeof(accelY), Sensors_Quantity_AccelerationY);
+    Device_formatQuantity(accelZ, sizeof(accelZ), Sensors_Quantity_AccelerationZ);
+    sprintf(displayText, "Status: Connected\r\nP:%s kPa\r\nT:%s C\r\nRH:%s %%\r\nAcc: x:%s g\r\n     y:%s g\r\n     z:%s g",
+            pressure,
+            temperature,
+            humidity,
+            accelX,
+            accelY,
+            accelZ);
+    SH1107_Display(1, 0, 0, displayText);
+}
+
+/**
+ * @brief Format the last value of a quantity for the display.
+ * @param buffer Output buffer.
+ * @param size Size of the output buffer.
+ * @param quantity Quantity.
+ * @retval None.
+ */
+static void Device_formatQuantity(char *buffer, size_t size, Sensors_Quantity_t quantity)
+{
+    float value;
+
+    Sensors_getValue(quantity, &value);
+    FixedFormat_float(buffer, size, value, 2);
+}
+
+/**
+ * @brief Wait for a message from the cloud and process it.
+ * @retval None.
+ */
+void Device_processCloudMessage()
+{
+    Device_handleCloudMessage(Device_receiveCloudMessage(true));
+}
+
+/**
+ * @brief Process a message from the cloud if one has arrived, returns at once
+ * otherwise.
+ * @retval None.
+ */
+void Device_pollCloudMessage()
+{
+    uint16_t length = Device_receiveCloudMessage(false);
+
+#if CONFIG_UPDATE
+    if ((length == 0) && !configUpdate.complete)
+#else
+    if (length == 0)
+#endif
+    {
+        return;
+    }
+    Device_handleCloudMessage(length);
+}
+
+/**
+ * @brief Process the message received from the cloud.
+ * @param length Length of the message in calypso->rxData, 0 without one.
+ * @retval None.
+ */
+static void Device_handleCloudMessage(uint16_t length)
+{
+    json_value *cloudResponse = NULL;
+    char *message = calypso->rxData.data;
+
+#if CONFIG_UPDATE
+    if (configUpdate.complete)
+    {
+        if (configUpdate.overflow)
+        {
+            SSerial_printf(SerialDebug, "Config update exceeds %u bytes\r\n",
+                           (unsigned int)(sizeof(configUpdate.data) - 1));
+        }
+        else
+        {
+            Device_storeConfigUpdate(configUpdate.data, configUpdate.length);
+        }
+        configUpdate.complete = false;
+    }
+    if ((length > 0) && (strcmp(calypso->subTopicName.data, configTopic) == 0))
+    {
+        Device_storeConfigUpdate((const uint8_t *)message, length);
+        Device_clearCloudMessage();
+        return;
+    }
+#endif
+    if ((length > 0) && Device_handleHistoryRequest(message, length))
+    {
+        Device_clearCloudMessage();
+        return;
+    }
+
+    /*The LED commands are read with the SAX parser, the other adapters
+    navigate a parsed document*/
+    if ((cloud != NULL) && (cloud->processDocument != NULL))
+    {
+        cloudResponse = (length > 0) ? Device_parseJson(message, length) : NULL;
+        cloud->processDocument(cloudResponse, calypso);
+    }
+    else if ((cloud != NULL) && (length > 0))
+    {
+        cloud->processMessage(message, length, calypso);
+    }
+    Device_FreeCloudResponse(cloudResponse);
+    if (length > 0)
+    {
+        Device_clearCloudMessage();
+    }
+}
+
+/**
+ * @brief Read the RGB values of a LED command {"red":r,"green":g,"blue":b},
+ *        sent either as JSON or as a CBOR map with the same keys.
+ * @param message Message received from the cloud.
+ * @param length Length of the message.
+ * @param command Pointer to the command.
+ * @retval true if all three values were found, false otherwise.
+ */
+bool Device_parseLedCommand(const char *message, uint16_t length,
+                            Device_LedCommand_t *command)
+{
+    static const json_sax_handler handler = {Device_saxObjectStart, Device_saxObjectEnd,
+                                             Device_saxObjectStart, Device_saxObjectEnd,
+                                             Device_saxKey, Device_ledValue};
+    Device_LedRequest_t request = {{0, {0}, {0}}, command, 0};
+
+    if (CborReader_isMap((const uint8_t *)message, length))
+    {
+        return Device_parseLedCommandCbor((const uint8_t *)message, length, command);
+    }
+    return (json_parse_sax(&handler, &request, message, length, NULL) &&
+            (request.fields == 0x07));
+}
+
+static bool Device_parseLedCommandCbor(const uint8_t *message, uint16_t length,
+                                       Device_LedCommand_t *command)
+{
+    static const char *const keys[] = {"red", "green", "blue"};
+    int32_t *values[] = {&command->red, &command->green, &command->blue};
+    CborReader_t reader;
+    uint32_t pairs;
+    uint8_t fields = 0;
+
+    CborReader_init(&reader, message, length);
+    if (!CborReader_map(&reader, &pairs))
+    {
+        return false;
+    }
+    while (pairs-- > 0)
+    {
+        const char *key;
+        size_t keyLength;
+        int64_t value;
+        uint8_t i = 3;
+
+        if (CborReader_text(&reader, &key, &keyLength))
+        {
+            for (i = 0; i < 3; i++)
+            {
+                if ((strlen(keys[i]) == keyLength) && (memcmp(keys[i], key, keyLength) == 0))
+                {
+                    break;
+                }
+            }
+        }
+        else if (!CborReader_skip(&reader))
+        {
+            return false;
+        }
+        if ((i < 3) && CborReader_integer(&reader, &value))
+        {
+            *values[i] = (int32_t)value;
+            fields |= 1 << i;
+        }
+        else if (!CborReader_skip(&reader))
+        {
+            return false;
+        }
+    }
+    return (fields == 0x07);
+}
+
+/**
+ * @brief Connect to WiFi.
+ * @retval None.
+ */
+void Device_connect_WiFi()
+{
+    if (!Calypso_WLANconnect(calypso))
+    {
+        SSerial_printf(calypso->serialDebug, "WiFi connect fail\r\n");
+        sprintf(displayText, "Error: Wi-Fi connect \r\nfailed");
+        SH1107_Display(1, 0, 24, displayText);
+        return;
+    }
+    delay(WI_FI_CONNECT_DELAY);
+    if (calypso->status == calypso_WLAN_connected)
+    {
+        sprintf(displayText, "Connected to Wi-Fi");
+        SH1107_Display(1, 0, 24, displayText);
+    }
+    if (!Calypso_setUpSNTP(calypso))
+    {
+        SSerial_printf(calypso->serialDebug, "SNTP config fail\r\n");
+    }
+}
+
+/**
+ * @brief Disconnect from WiFi.
+ * @retval None.
  */
 void Device_disconnect_WiFi()
 {
@@ -673,6 +1358,7 @@ void Device_reset()
     {
         Calypso_deleteFile(calypso, CONFIG_FILE_PATH);
     }
+    ConfigSnapshot_delete(calypso);
     soft_reset();
 }
 
@@ -697,50 +1383,717 @@ void Device_WiFi_provisioning()
 }
 
 /**
- * @brief Serialize data to send.
- * @retval Pointer to serialized data.
+ * @brief Apply report-by-exception settings of the form
+ * {"heartbeat":s,"<sensor key>":{"deadband":d,"rate":r},...}. Sensor keys are
+ * the telemetry keys, e.g. "temperature" or "acceleration". Missing
+ * thresholds are set to 0, i.e. disabled, missing sensors keep theirs.
+ * @param settings JSON settings object.
+ * @retval true if all settings were valid, false otherwise. Settings that do
+ * not bind to reportSchema are rejected, out of range values are skipped.
  */
-static char *Device_SerializeData()
+bool Device_applyReportSettings(const json_value *settings)
 {
-    json_value *payload = json_object_new(4);
-    if (payload == NULL)
+    Device_ReportSettings_t report;
+    void *bases[] = {&report};
+
+    Device_getReportSettings(&report);
+    if (!Device_bindConfiguration(reportSchema, sizeof(reportSchema) / sizeof(reportSchema[0]),
+                                  settings, bases))
     {
-        SSerial_printf(SerialDebug, "Payload memory full \r\n");
-        return NULL;
+        return false;
+    }
+    return Device_setReportSettings(&report);
+}
+
+/**
+ * @brief Get the report-by-exception settings in use.
+ * @param report Settings, sensors that were not found at boot are disabled.
+ * @retval None.
+ */
+static void Device_getReportSettings(Device_ReportSettings_t *report)
+{
+    report->heartbeat = (uint32_t)(reportHeartbeat / 1000);
+    for (uint8_t k = 0; k < DEVICE_REPORT_SENSORS; k++)
+    {
+        report->sensors[k].deadband = 0;
+        report->sensors[k].rate = 0;
+        for (uint8_t i = 0; i < Sensors_getCount(); i++)
+        {
+            if (strcmp(Sensors_getKey(i), reportSensorKeys[k]) == 0)
+            {
+                Sensors_getReportThresholds(i, &report->sensors[k].deadband,
+                                            &report->sensors[k].rate);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Use report-by-exception settings, invalid values are skipped.
+ * @param report Settings.
+ * @retval true if all values are valid, false otherwise.
+ */
+static bool Device_setReportSettings(const Device_ReportSettings_t *report)
+{
+    bool valid = true;
+
+    if (report->heartbeat > MAX_REPORT_HEARTBEAT_INTERVAL)
+    {
+        SSerial_printf(SerialDebug, "Config heartbeat: out of range\r\n");
+        valid = false;
+    }
+    else
+    {
+        reportHeartbeat = (unsigned long)report->heartbeat * 1000UL;
+    }
+    for (uint8_t k = 0; k < DEVICE_REPORT_SENSORS; k++)
+    {
+        const Device_ReportThresholds_t *thresholds = &report->sensors[k];
+
+        if (!(thresholds->deadband >= 0) || !(thresholds->rate >= 0))
+        {
+            SSerial_printf(SerialDebug, "Config %s: out of range\r\n", reportSensorKeys[k]);
+            valid = false;
+            continue;
+        }
+        /*Sensors that were not found at boot are skipped*/
+        Sensors_setReportThresholds(reportSensorKeys[k], thresholds->deadband, thresholds->rate);
+    }
+    return valid;
+}
+
+/**
+ * @brief Write the report-by-exception settings in the format taken by
+ * Device_applyReportSettings().
+ * @param writer Writer positioned inside an object.
+ * @param name Key of the settings object.
+ * @retval None.
+ */
+void Device_writeReportSettings(JsonWriter_t *writer, const char *name)
+{
+    JsonWriter_beginObject(writer, name);
+    JsonWriter_integer(writer, "heartbeat", reportHeartbeat / 1000);
+    for (uint8_t i = 0; i < Sensors_getCount(); i++)
+    {
+        float deadband;
+        float rate;
+
+        Sensors_getReportThresholds(i, &deadband, &rate);
+        JsonWriter_beginObject(writer, Sensors_getKey(i));
+        JsonWriter_float(writer, "deadband", deadband, REPORT_THRESHOLD_DECIMALS);
+        JsonWriter_float(writer, "rate", rate, REPORT_THRESHOLD_DECIMALS);
+        JsonWriter_endObject(writer);
+    }
+    JsonWriter_endObject(writer);
+}
+
+/**
+ * @brief Count the sensors of a bit mask.
+ * @param sensors Bit mask of sensors.
+ * @retval Number of sensors.
+ */
+static uint8_t Device_countSensors(uint32_t sensors)
+{
+    uint8_t count = 0;
+
+    for (; sensors != 0; sensors &= sensors - 1)
+    {
+        count++;
     }
+    return count;
+}
 
-    json_object_push(payload, "pressure",
-                     json_double_new(PADS_pressure));
+/**
+ * @brief Serialize data to send, as CBOR or JSON depending on the cloud.
+ * @param length Length of the serialized data.
+ * @param sensors Bit mask of the sensors to serialize.
+ * @retval Pointer to serialized data, NULL if it did not fit.
+ */
+static char *Device_SerializeData(uint16_t *length, uint32_t sensors)
+{
+    JsonWriter_t writer;
 
-    json_object_push(payload, "humidity",
-                     json_double_new(HIDS_humidity));
+    if (Device_telemetryCbor())
+    {
+        *length = Device_SerializeDataCbor(sensors);
+        if (*length == 0)
+        {
+            SSerial_printf(SerialDebug, "Payload too long \r\n");
+            return NULL;
+        }
+        return sensorPayload;
+    }
 
-    json_object_push(payload, "temperature",
-                     json_double_new(TIDS_temp));
+    JsonWriter_init(&writer, sensorPayload, MAX_PAYLOAD_LENGTH);
+    JsonWriter_beginObject(&writer, NULL);
+    Device_writeChannels(&writer, Sensors_Statistic_Mean, sensors);
+#if TELEMETRY_STATISTICS
+    JsonWriter_beginObject(&writer, "min");
+    Device_writeChannels(&writer, Sensors_Statistic_Min, sensors);
+    JsonWriter_endObject(&writer);
+    JsonWriter_beginObject(&writer, "max");
+    Device_writeChannels(&writer, Sensors_Statistic_Max, sensors);
+    JsonWriter_endObject(&writer);
+    JsonWriter_beginObject(&writer, "count");
+    for (uint8_t i = 0; i < Sensors_getCount(); i++)
+    {
+        if (sensors & ((uint32_t)1 << i))
+        {
+            JsonWriter_integer(&writer, Sensors_getKey(i), Sensors_getAggregate(i, 0)->count);
+        }
+    }
+    JsonWriter_endObject(&writer);
+#endif
+    if (Clock_isSynced())
+    {
+        JsonWriter_integer(&writer, "ts", (int64_t)Clock_now());
+    }
+    Device_addSequence(&writer, Device_MessageClass_Telemetry);
+    JsonWriter_endObject(&writer);
 
-    json_value *acceleration = json_object_new(3);
-    if (acceleration == NULL)
+    *length = JsonWriter_finish(&writer);
+    if (*length == 0)
     {
-        json_builder_free(payload);
-        SSerial_printf(SerialDebug, "acceleration memory full \r\n");
+        SSerial_printf(SerialDebug, "Payload too long \r\n");
         return NULL;
     }
+    return sensorPayload;
+}
 
-    json_object_push(acceleration, "x",
-                     json_double_new(ITDS_accelX));
-    json_object_push(acceleration, "y",
-                     json_double_new(ITDS_accelY));
-    json_object_push(acceleration, "z",
-                     json_double_new(ITDS_accelZ));
+/**
+ * @brief Write one statistic of the channels in the telemetry layout, e.g.
+ * {"pressure":p,"humidity":h,"temperature":t,"acceleration":{"x":x,"y":y,"z":z}}.
+ * @param writer Writer positioned inside an object.
+ * @param statistic Statistic to write.
+ * @param sensors Bit mask of the sensors to write.
+ * @retval None.
+ */
+static void Device_writeChannels(JsonWriter_t *writer, Sensors_Statistic_t statistic,
+                                 uint32_t sensors)
+{
+    for (uint8_t i = 0; i < Sensors_getCount(); i++)
+    {
+        const Sensors_descriptor_t *sensor = Sensors_get(i);
 
-    json_object_push(payload, "acceleration", acceleration);
+        if ((sensors & ((uint32_t)1 << i)) == 0)
+        {
+            continue;
+        }
 
-    memset(sensorPayload, 0, MAX_PAYLOAD_LENGTH);
-    json_serialize(sensorPayload, payload);
+        if (sensor->group != NULL)
+        {
+            JsonWriter_beginObject(writer, sensor->group);
+        }
+        for (uint8_t c = 0; c < sensor->channelCount; c++)
+        {
+            JsonWriter_float(writer, sensor->channels[c].name,
+                             Sensors_getStatistic(i, c, statistic), sensor->channels[c].decimals);
+        }
+        if (sensor->group != NULL)
+        {
+            JsonWriter_endObject(writer);
+        }
+    }
+}
 
-    json_builder_free(payload);
-    json_builder_free(acceleration);
-    return sensorPayload;
+/**
+ * @brief Write one statistic of the channels as one CBOR map pair per
+ * sensor, an array for sensors with several channels.
+ * @param writer Writer positioned inside a map.
+ * @param statistic Statistic to write.
+ * @param sensors Bit mask of the sensors to write.
+ * @retval None.
+ */
+static void Device_writeChannelsCbor(CborWriter_t *writer, Sensors_Statistic_t statistic,
+                                     uint32_t sensors)
+{
+    for (uint8_t i = 0; i < Sensors_getCount(); i++)
+    {
+        const Sensors_descriptor_t *sensor = Sensors_get(i);
+
+        if ((sensors & ((uint32_t)1 << i)) == 0)
+        {
+            continue;
+        }
+
+        CborWriter_integer(writer, sensor->cborKey);
+        if (sensor->channelCount > 1)
+        {
+            CborWriter_array(writer, sensor->channelCount);
+        }
+        for (uint8_t c = 0; c < sensor->channelCount; c++)
+        {
+            CborWriter_float(writer, Sensors_getStatistic(i, c, statistic),
+                             sensor->channels[c].decimals);
+        }
+    }
+}
+
+/**
+ * @brief Check if the connected cloud takes CBOR telemetry.
+ * @retval true for CBOR, false for JSON.
+ */
+static bool Device_telemetryCbor()
+{
+    return (cloud != NULL) && cloud->telemetryCbor;
+}
+
+/**
+ * @brief Serialize data to send as a CBOR map with integer keys.
+ * @param sensors Bit mask of the sensors to serialize.
+ * @retval Length of the serialized data, 0 if it did not fit.
+ */
+static uint16_t Device_SerializeDataCbor(uint32_t sensors)
+{
+    CborWriter_t writer;
+    bool sequence = (messageClassQoS[Device_MessageClass_Telemetry] == ATMQTT_QOS_QOS0);
+    bool timestamp = Clock_isSynced();
+    uint8_t sensorCount = Device_countSensors(sensors);
+
+    CborWriter_init(&writer, (uint8_t *)sensorPayload, MAX_PAYLOAD_LENGTH);
+    CborWriter_map(&writer, sensorCount + (sequence ? 1 : 0) + (timestamp ? 1 : 0) +
+                                (TELEMETRY_STATISTICS ? 3 : 0));
+    Device_writeChannelsCbor(&writer, Sensors_Statistic_Mean, sensors);
+#if TELEMETRY_STATISTICS
+    CborWriter_integer(&writer, CBOR_KEY_MIN);
+    CborWriter_map(&writer, sensorCount);
+    Device_writeChannelsCbor(&writer, Sensors_Statistic_Min, sensors);
+    CborWriter_integer(&writer, CBOR_KEY_MAX);
+    CborWriter_map(&writer, sensorCount);
+    Device_writeChannelsCbor(&writer, Sensors_Statistic_Max, sensors);
+    CborWriter_integer(&writer, CBOR_KEY_COUNT);
+    CborWriter_map(&writer, sensorCount);
+    for (uint8_t i = 0; i < Sensors_getCount(); i++)
+    {
+        if (sensors & ((uint32_t)1 << i))
+        {
+            CborWriter_integer(&writer, Sensors_get(i)->cborKey);
+            CborWriter_integer(&writer, Sensors_getAggregate(i, 0)->count);
+        }
+    }
+#endif
+    if (timestamp)
+    {
+        CborWriter_integer(&writer, CBOR_KEY_TIMESTAMP);
+        CborWriter_integer(&writer, (int64_t)Clock_now());
+    }
+    if (sequence)
+    {
+        CborWriter_integer(&writer, CBOR_KEY_SEQUENCE);
+        CborWriter_integer(&writer,
+                           messageClassSequence[Device_MessageClass_Telemetry]++);
+    }
+    return (uint16_t)CborWriter_finish(&writer);
+}
+
+/**
+ * @brief Publish a message with the QoS of its class, diagnostics go to the
+ * diagnostics topic of the cloud and everything else to the telemetry topic.
+ * @param messageClass Class of the message.
+ * @param data Data to publish.
+ * @param length Data length.
+ * @retval true if successful, false otherwise.
+ */
+static bool Device_publish(Device_MessageClass_t messageClass, char *data, int length)
+{
+    if (messageClass == Device_MessageClass_Diagnostics)
+    {
+        char topic[DEVICE_TOPIC_LENGTH];
+        snprintf(topic, sizeof(topic), cloud->diagnosticsTopic,
+                 calypso->settings.mqttSettings.clientID);
+        return Calypso_MQTTPublish(calypso, topic, messageClassQoS[messageClass], 1,
+                                   data, length, true);
+    }
+    return Calypso_MQTTPublish(calypso, calypso->telemetryPubTopic,
+                               messageClassQoS[messageClass], 1, data, length, true);
+}
+
+/**
+ * @brief Add the sequence counter to messages of a class published with QoS 0.
+ * @param writer Writer of the message, inside its top level object.
+ * @param messageClass Class of the message.
+ * @retval None.
+ */
+static void Device_addSequence(JsonWriter_t *writer, Device_MessageClass_t messageClass)
+{
+    if (messageClassQoS[messageClass] == ATMQTT_QOS_QOS0)
+    {
+        JsonWriter_integer(writer, "seq", messageClassSequence[messageClass]++);
+    }
+}
+
+/**
+ * @brief Answer a {"history":{"from":<unix time>,"to":<unix time>}} request.
+ * @param message Message received from the cloud.
+ * @param length Length of the message.
+ * @retval true if the message was a history request, false otherwise.
+ */
+static bool Device_handleHistoryRequest(const char *message, uint16_t length)
+{
+    static const json_sax_handler handler = {Device_historyObjectStart, Device_saxObjectEnd,
+                                             Device_saxObjectStart, Device_saxObjectEnd,
+                                             Device_saxKey, Device_historyValue};
+    Device_HistoryRequest_t request = {{0, {0}, {0}}, 0, UINT32_MAX, false};
+
+    /*Cheap check before parsing, every other message passes through here*/
+    if ((strstr(message, "\"history\"") == NULL) ||
+        !json_parse_sax(&handler, &request, message, length, NULL) ||
+        !request.found)
+    {
+        return false;
+    }
+    if (!Device_PublishHistory(request.from, request.to))
+    {
+        SSerial_printf(SerialDebug, "History publish failed\r\n");
+    }
+    return true;
+}
+
+/**
+ * @brief Get the next message from the cloud, it is left in calypso->rxData.
+ * @param wait Wait up to EVENT_WAIT_TIME for a message.
+ * @retval Length of the message, 0 if there is none.
+ */
+static uint16_t Device_receiveCloudMessage(bool wait)
+{
+    bool received = wait ? Calypso_MQTTgetMessage(calypso, true)
+                         : Calypso_MQTTpollMessage(calypso, true);
+
+    if (received && (calypso->rxData.length > 4))
+    {
+        return calypso->rxData.length;
+    }
+    return 0;
+}
+
+/**
+ * @brief Discard the message received from the cloud.
+ * @retval None.
+ */
+static void Device_clearCloudMessage()
+{
+    memset(calypso->rxData.data, 0, CALYPSO_LINE_MAX_SIZE);
+    calypso->rxData.length = 0;
+}
+
+static int Device_saxObjectStart(void *user_data)
+{
+    Device_SaxState_t *state = (Device_SaxState_t *)user_data;
+    state->depth++;
+    strcpy(state->parent, state->key);
+    state->key[0] = '\0';
+    return 1;
+}
+
+static int Device_saxObjectEnd(void *user_data)
+{
+    Device_SaxState_t *state = (Device_SaxState_t *)user_data;
+    state->depth--;
+    state->parent[0] = '\0';
+    state->key[0] = '\0';
+    return 1;
+}
+
+static int Device_saxKey(void *user_data, const json_char *name, unsigned int length)
+{
+    Device_SaxState_t *state = (Device_SaxState_t *)user_data;
+    /*Longer keys are not used by any command*/
+    if (length >= DEVICE_SAX_KEY_LEN)
+    {
+        length = 0;
+    }
+    memcpy(state->key, name, length);
+    state->key[length] = '\0';
+    return 1;
+}
+
+static int Device_historyObjectStart(void *user_data)
+{
+    Device_HistoryRequest_t *request = (Device_HistoryRequest_t *)user_data;
+    Device_saxObjectStart(user_data);
+    if ((request->sax.depth == 2) && (0 == strcmp(request->sax.parent, "history")))
+    {
+        request->found = true;
+    }
+    return 1;
+}
+
+static int Device_historyValue(void *user_data, const json_value *value)
+{
+    Device_HistoryRequest_t *request = (Device_HistoryRequest_t *)user_data;
+    if ((request->sax.depth != 2) || (0 != strcmp(request->sax.parent, "history")) ||
+        (value->type != json_integer))
+    {
+        return 1;
+    }
+    if (0 == strcmp(request->sax.key, "from"))
+    {
+        request->from = (uint32_t)value->u.integer;
+    }
+    else if (0 == strcmp(request->sax.key, "to"))
+    {
+        request->to = (uint32_t)value->u.integer;
+    }
+    return 1;
+}
+
+static int Device_ledValue(void *user_data, const json_value *value)
+{
+    Device_LedRequest_t *request = (Device_LedRequest_t *)user_data;
+    if ((request->sax.depth != 1) || (value->type != json_integer))
+    {
+        return 1;
+    }
+    if (0 == strcmp(request->sax.key, "red"))
+    {
+        request->command->red = (int32_t)value->u.integer;
+        request->fields |= 0x01;
+    }
+    else if (0 == strcmp(request->sax.key, "green"))
+    {
+        request->command->green = (int32_t)value->u.integer;
+        request->fields |= 0x02;
+    }
+    else if (0 == strcmp(request->sax.key, "blue"))
+    {
+        request->command->blue = (int32_t)value->u.integer;
+        request->fields |= 0x04;
+    }
+    return 1;
+}
+
+/**
+ * @brief Add a history record to the current batch, publishing the batch
+ * when it is full.
+ * @retval true to continue the query, false otherwise.
+ */
+static bool Device_historySink(void *context, const History_record_t *record)
+{
+    Device_HistoryBatch_t *batch = (Device_HistoryBatch_t *)context;
+    char entry[64];
+    int length = sprintf(entry, "%s[%lu,%d,%u,%u,%d,%d,%d]",
+                         (batch->records > 0) ? "," : "",
+                         (unsigned long)record->timestamp, record->temperature,
+                         record->humidity, record->pressure,
+                         record->accelX, record->accelY, record->accelZ);
+
+    /* Keep room for the closing brackets */
+    if ((batch->length + length + 3) >= MAX_PAYLOAD_LENGTH)
+    {
+        if (!Device_publishHistoryBatch(batch))
+        {
+            batch->failed = true;
+            return false;
+        }
+        length = sprintf(entry, "[%lu,%d,%u,%u,%d,%d,%d]",
+                         (unsigned long)record->timestamp, record->temperature,
+                         record->humidity, record->pressure,
+                         record->accelX, record->accelY, record->accelZ);
+    }
+    if (batch->length == 0)
+    {
+        batch->length = sprintf(sensorPayload, "{\"history\":[");
+    }
+    memcpy(&sensorPayload[batch->length], entry, length);
+    batch->length += length;
+    batch->records++;
+    return true;
+}
+
+/**
+ * @brief Publish the current batch of history records and start a new one.
+ * @retval true if successful, false otherwise.
+ */
+static bool Device_publishHistoryBatch(Device_HistoryBatch_t *batch)
+{
+    if (batch->length == 0)
+    {
+        batch->length = sprintf(sensorPayload, "{\"history\":[");
+    }
+    batch->length += sprintf(&sensorPayload[batch->length], "]}");
+    bool ret = Device_publish(Device_MessageClass_History, sensorPayload, batch->length);
+    batch->length = 0;
+    batch->records = 0;
+    return ret;
+}
+
+#if CONFIG_UPDATE
+/**
+ * @brief Collect a configuration file streamed on the configuration topic.
+ * Called from the Calypso receive path, so it only copies the data.
+ * @param context Configuration update being received.
+ * @param topic Topic of the message.
+ * @param data Decoded chunk of the message.
+ * @param length Length of the chunk.
+ * @param offset Offset of the chunk in the message.
+ * @param last true for the last chunk.
+ * @retval None.
+ */
+static void Device_configUpdateSink(void *context, const char *topic, const uint8_t *data,
+                                    uint16_t length, uint32_t offset, bool last)
+{
+    Device_ConfigUpdate_t *update = (Device_ConfigUpdate_t *)context;
+
+    /*A received file is kept until it is stored*/
+    if ((strcmp(topic, configTopic) != 0) || update->complete)
+    {
+        return;
+    }
+    if (offset == 0)
+    {
+        update->length = 0;
+        update->overflow = false;
+    }
+    /*Device_loadConfiguration rejects files that fill its buffer*/
+    if ((update->length + length) >= sizeof(update->data))
+    {
+        update->overflow = true;
+    }
+    else
+    {
+        memcpy(&update->data[update->length], data, length);
+        update->length += length;
+    }
+    update->complete = last;
+}
+
+/**
+ * @brief Check a received configuration file and replace the configuration
+ * file with it. The new configuration is applied at the next start.
+ * @param data Configuration file.
+ * @param length Length of the configuration file.
+ * @retval None.
+ */
+static void Device_storeConfigUpdate(const uint8_t *data, uint16_t length)
+{
+    json_value *configuration = Device_parseJson((const char *)data, length);
+    bool valid = (configuration != NULL) && Device_validateConfiguration(configuration);
+
+    Arena_reset(&jsonArena);
+    if (!valid)
+    {
+        SSerial_printf(SerialDebug, "Config update rejected\r\n");
+        return;
+    }
+    /*The configuration file is only overwritten once the update is stored
+    completely*/
+    if (!Calypso_writeFileBulk(calypso, CONFIG_UPDATE_PATH, data, length, false, NULL))
+    {
+        Calypso_deleteFile(calypso, CONFIG_UPDATE_PATH);
+        SSerial_printf(SerialDebug, "Config update not stored\r\n");
+        return;
+    }
+    if (!Device_replaceConfiguration(data, length))
+    {
+        return;
+    }
+    SSerial_printf(SerialDebug, "Config updated, %u bytes, applied at the next start\r\n",
+                   (unsigned int)length);
+}
+
+/**
+ * @brief Bind a configuration to the schemas of the device and of its cloud
+ * adapter without applying it.
+ * @param configuration JSON configuration object.
+ * @retval true if the configuration would be loaded, false otherwise.
+ */
+static bool Device_validateConfiguration(const json_value *configuration)
+{
+    const CloudAdapter_t *adapter;
+    Device_config_t config;
+    void *bases[] = {&config};
+
+    Device_getReportSettings(&config.report);
+    if (!Device_bindConfiguration(deviceSchema, sizeof(deviceSchema) / sizeof(deviceSchema[0]),
+                                  configuration, bases))
+    {
+        return false;
+    }
+    adapter = CloudAdapter_find(config.version);
+    if (adapter == NULL)
+    {
+        SSerial_printf(SerialDebug, "Cloud %u not built in\r\n", (unsigned int)config.version);
+        return false;
+    }
+    return Device_bindConfiguration(adapter->configSchema, adapter->configSchemaLength,
+                                    configuration, NULL);
+}
+
+/**
+ * @brief Copy a stored configuration update over the configuration file and
+ * remove the update.
+ * @param data Configuration file, the content of CONFIG_UPDATE_PATH.
+ * @param length Length of the configuration file.
+ * @retval true if successful, false otherwise.
+ */
+static bool Device_replaceConfiguration(const uint8_t *data, uint16_t length)
+{
+    if (!Calypso_writeFileBulk(calypso, CONFIG_FILE_PATH, data, length, false, NULL))
+    {
+        /*Recovered from CONFIG_UPDATE_PATH at the next start*/
+        SSerial_printf(SerialDebug, "Config file not replaced\r\n");
+        return false;
+    }
+    Calypso_deleteFile(calypso, CONFIG_UPDATE_PATH);
+    return true;
+}
+
+/**
+ * @brief Finish an update that was interrupted while the configuration file
+ * was replaced. An update that was not stored completely is dropped.
+ * @param buffer Buffer for the update.
+ * @param size Size of the buffer.
+ * @retval None.
+ */
+static void Device_recoverConfigUpdate(char *buffer, uint16_t size)
+{
+    json_value *configuration;
+    uint16_t length;
+    bool valid;
+
+    if (!Calypso_fileExists(calypso, CONFIG_UPDATE_PATH))
+    {
+        return;
+    }
+    valid = Calypso_readFileOfSize(calypso, CONFIG_UPDATE_PATH, 0, buffer, size, &length) &&
+            (length < size);
+    if (valid)
+    {
+        configuration = Device_parseJson(buffer, length);
+        valid = (configuration != NULL) && Device_validateConfiguration(configuration);
+        Arena_reset(&jsonArena);
+    }
+    if (!valid)
+    {
+        Calypso_deleteFile(calypso, CONFIG_UPDATE_PATH);
+        SSerial_printf(SerialDebug, "Incomplete config update dropped\r\n");
+        return;
+    }
+    if (Device_replaceConfiguration((const uint8_t *)buffer, length))
+    {
+        SSerial_printf(SerialDebug, "Config update recovered\r\n");
+    }
+}
+#endif
+
+/**
+ * @brief Parse JSON into the arena, releasing the previous message.
+ * @param json JSON text.
+ * @param length Length of the text.
+ * @retval JSON value or NULL.
+ */
+static json_value *Device_parseJson(const char *json, size_t length)
+{
+    uint32_t failures = jsonArena.failures;
+    json_value *value;
+
+    Arena_reset(&jsonArena);
+    value = json_parse_ex(&jsonSettings, json, length, NULL);
+    if (jsonArena.failures != failures)
+    {
+        SSerial_printf(SerialDebug, "JSON arena too small for %u bytes\r\n", (unsigned int)length);
+    }
+    return value;
 }
 
 /**
@@ -31,7 +31,10 @@
 #include "calypsoBoard.h"
 #include "ConfigPlatform.h"
 #include "sensorBoard.h"
-#include "json-builder.h"
+#include "sensors.h"
+#include "json.h"
+#include "jsonWriter.h"
+#include "configSchema.h"
 
 /**         Functions definition         */
 
@@ -42,6 +45,23 @@ extern "C"
 
 #define CONFIG_FILE_PATH "user/devconf"
 
+/*Store configuration files received on the configuration topic of the cloud
+adapter. Files that do not fit into the line buffer of Calypso are streamed.
+A received file has to bind to the schema of its cloud adapter, it is written
+to CONFIG_UPDATE_PATH first and copied over the configuration file from there,
+so an interrupted update leaves a complete file to recover at the next start*/
+#ifndef CONFIG_UPDATE
+#define CONFIG_UPDATE 0
+#endif
+#define CONFIG_UPDATE_PATH "user/devconf.new"
+
+/*Received configuration files may exceed the line buffer of Calypso*/
+#if CONFIG_UPDATE
+#define CONFIG_FILE_MAX_SIZE 2048
+#else
+#define CONFIG_FILE_MAX_SIZE 1024
+#endif
+
 
 #define HOST_FIRMWARE_VERSION "2.1.0"
 
@@ -50,6 +70,25 @@ extern "C"
 #define AWS_IOT_CORE_CONFIG_VERSION 2
 #define KAA_IOT_CONFIG_VERSION 3
 
+/*Destinations of the configuration schemas of the cloud adapters, further
+destinations of an adapter follow DEVICE_CONFIG_ADAPTER*/
+#define DEVICE_CONFIG_SETTINGS 0 /* CalypsoSettings */
+#define DEVICE_CONFIG_ADAPTER 1
+
+/*Members of every cloud configuration, from the given position on in files
+without keys*/
+#define DEVICE_CONFIG_NETWORK(position)                                                  \
+  CONFIG_STRING("sntpServer", (position), true, DEVICE_CONFIG_SETTINGS, CalypsoSettings, \
+                sntpSettings.server, NULL),                                              \
+      CONFIG_STRING("timezone", (position) + 1, true, DEVICE_CONFIG_SETTINGS,            \
+                    CalypsoSettings, sntpSettings.timezone, NULL),                       \
+      CONFIG_STRING("ssid", (position) + 2, true, DEVICE_CONFIG_SETTINGS,                \
+                    CalypsoSettings, wifiSettings.SSID, NULL),                           \
+      CONFIG_STRING("password", (position) + 3, true, DEVICE_CONFIG_SETTINGS,            \
+                    CalypsoSettings, wifiSettings.securityParams.securityKey, NULL),     \
+      CONFIG_UNSIGNED("securityType", (position) + 4, true, DEVICE_CONFIG_SETTINGS,      \
+                      CalypsoSettings, wifiSettings.securityParams.securityType, 0)
+
 // Button labelled C on the OLED display
 #define BUTTON_C (byte)5
 #define BUTTON_B (byte)6
@@ -58,8 +97,99 @@ extern "C"
 /*Wi-Fi settings*/
 #define WI_FI_CONNECT_DELAY 5000UL
 
+/*MQTT reconnect settings*/
+#define MQTT_CLEAN_SESSION 0                // 0 = resume persistent session on reconnect
+#define RECONNECT_BACKOFF_MIN 1000UL        // ms
+#define RECONNECT_BACKOFF_MAX 64000UL       // ms
+#define RECONNECT_RECREATE_ATTEMPTS 3       // plain reconnects before re-creating the client
+#define MAX_RECONNECT_ATTEMPTS 10           // restart the device after this many attempts
+
 #define MAX_PAYLOAD_LENGTH 1024
 
+#define DISPLAY_VALUE_SIZE 10 /* e.g. "-12345.67", longer values are not shown */
+
+/*Report-by-exception: sensors are only published when a channel moves
+beyond its thresholds (sensors.h), all of them at least once per heartbeat*/
+#ifndef REPORT_HEARTBEAT_INTERVAL
+#define REPORT_HEARTBEAT_INTERVAL 600 // seconds, 0 disables the heartbeat
+#endif
+#define MAX_REPORT_HEARTBEAT_INTERVAL 86400 // seconds
+#define REPORT_THRESHOLD_DECIMALS 4
+
+/*Add min, max and sample count of the interval to the telemetry*/
+#ifndef TELEMETRY_STATISTICS
+#define TELEMETRY_STATISTICS 0
+#endif
+
+/*Memory for parsed JSON messages and the configuration, reused for every message*/
+#ifndef JSON_ARENA_SIZE
+#if CONFIG_UPDATE
+#define JSON_ARENA_SIZE 4096
+#else
+#define JSON_ARENA_SIZE 3072
+#endif
+#endif
+
+/*MQTT QoS per message class. Classes published with QoS 0 do not wait for the
+broker acknowledgment and carry a "seq" counter so that losses can be measured.
+Telemetry stays at QoS 1: with report by exception a value that is published is
+not sent again until it changes, and the missing acknowledgment is what detects
+a broker that went away without a disconnect event (MAX_PACKET_LOSS). With
+TELEMETRY_QOS 0 a lost message is only visible as a gap in "seq" at the
+backend and the device no longer notices a silent broker, use it only with
+report by exception off. High-rate data goes to the acceleration stream*/
+#ifndef TELEMETRY_QOS
+#define TELEMETRY_QOS ATMQTT_QOS_QOS1
+#endif
+#ifndef DIAGNOSTICS_QOS
+#define DIAGNOSTICS_QOS ATMQTT_QOS_QOS0
+#endif
+#ifndef HISTORY_QOS
+#define HISTORY_QOS ATMQTT_QOS_QOS1
+#endif
+#ifndef ACCELERATION_STREAM_QOS
+#define ACCELERATION_STREAM_QOS ATMQTT_QOS_QOS0
+#endif
+
+/*Publish the last acceleration sample on the telemetry topic every
+ACCELERATION_STREAM_PERIOD, {"acceleration":{"x":x,"y":y,"z":z},"seq":n},
+next to the aggregated telemetry. The samples are disposable, so the stream
+is paced by the UART instead of the broker round trip*/
+#ifndef ACCELERATION_STREAM
+#define ACCELERATION_STREAM 0
+#endif
+#ifndef ACCELERATION_STREAM_PERIOD
+#define ACCELERATION_STREAM_PERIOD ACCELERATION_SAMPLE_PERIOD // ms
+#endif
+#define ACCELERATION_STREAM_PAYLOAD_LENGTH 96
+
+/*Number of telemetry publishes between two latency diagnostics reports*/
+#define LATENCY_REPORT_INTERVAL 20
+
+/*Room for the diagnostics and configuration topics of the cloud adapter and
+the client ID*/
+#define DEVICE_TOPIC_LENGTH 64
+
+/*Compress telemetry published to the Mosquitto broker, see compress.h for the format*/
+#ifndef TELEMETRY_COMPRESSION
+#define TELEMETRY_COMPRESSION 0
+#endif
+
+/*Publish telemetry as CBOR instead of JSON, per cloud adapter*/
+#ifndef MOSQUITTO_TELEMETRY_CBOR
+#define MOSQUITTO_TELEMETRY_CBOR 0
+#endif
+#ifndef AWS_TELEMETRY_CBOR
+#define AWS_TELEMETRY_CBOR 0
+#endif
+
+/*Integer keys of the CBOR telemetry map, the sensor keys are in sensors.h*/
+#define CBOR_KEY_SEQUENCE 5
+#define CBOR_KEY_MIN 6   /* map with the sensor keys, TELEMETRY_STATISTICS only */
+#define CBOR_KEY_MAX 7   /* map with the sensor keys, TELEMETRY_STATISTICS only */
+#define CBOR_KEY_COUNT 8 /* map with the sensor keys, TELEMETRY_STATISTICS only */
+#define CBOR_KEY_TIMESTAMP 9 /* Unix time in ms, once the clock is synchronized */
+
 #define DEVICE_CREDENTIALS_MAX_LEN 64
 #define MAX_URL_LEN 128
 
@@ -81,7 +211,22 @@ extern "C"
 #define CALYPSO_FIRMWARE_MIN_MAJOR_VERSION 2
 #define CALYPSO_FIRMWARE_MIN_MINOR_VERSION 2
 
-  extern bool sensorsPresent;
+  typedef struct
+  {
+    int32_t red;
+    int32_t green;
+    int32_t blue;
+  } Device_LedCommand_t;
+
+  typedef enum
+  {
+    Device_MessageClass_Telemetry,
+    Device_MessageClass_Diagnostics,
+    Device_MessageClass_History,
+    Device_MessageClass_Acceleration,
+    Device_MessageClass_NumberOfValues
+  } Device_MessageClass_t;
+
   extern volatile unsigned long telemetrySendInterval;
   TypeSerial *Device_init(void *Debug, void *CalypsoSerial);
   void Device_writeConfigFiles();
@@ -90,7 +235,17 @@ extern "C"
   bool Device_isProvisioned();
   void Device_ConnectToCloud();
   void Device_readSensors();
+  unsigned long Device_sampleSensors();
   void Device_PublishSensorData();
+  void Device_PublishAccelerationStream();
+  bool Device_applyReportSettings(const json_value *settings);
+  bool Device_bindConfiguration(const ConfigSchema_entry_t *schema, uint8_t count,
+                                const json_value *configuration, void *const *bases);
+  void Device_writeReportSettings(JsonWriter_t *writer, const char *name);
+  void Device_PublishDiagnostics();
+  bool Device_syncClock();
+  void Device_recordHistory();
+  bool Device_PublishHistory(uint32_t from, uint32_t to);
   void Device_listOfFiles();
   void Device_connect_WiFi();
   void Device_disconnect_WiFi();
@@ -101,10 +256,15 @@ extern "C"
   void Device_reset();
   void Device_restart();
   bool Device_isStatusOK();
+  bool Device_maintainConnection();
   void Device_processCloudMessage();
+  void Device_pollCloudMessage();
   void Device_displaySensorData();
   bool Device_isUpToDate();
   json_value *Device_GetCloudResponse();
+  void Device_FreeCloudResponse(json_value *response);
+  bool Device_parseLedCommand(const char *message, uint16_t length,
+                              Device_LedCommand_t *command);
 #ifdef __cplusplus
 }
 #endif
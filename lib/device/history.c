@@ -0,0 +1,320 @@
+/**
+ * \file
+ * \brief Circular history of sensor samples stored on the Calypso file system.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "history.h"
+
+#define HISTORY_INDEX_VERSION 1
+#define HISTORY_PATH_MAX_LEN 16
+
+typedef struct
+{
+    uint32_t first; /* timestamp of the oldest record */
+    uint32_t last;  /* timestamp of the newest record */
+    uint16_t count; /* number of records */
+} History_segment_t;
+
+typedef struct
+{
+    uint8_t version;
+    uint8_t head; /* segment currently being filled */
+    uint16_t recordsPerSegment;
+    History_segment_t segments[HISTORY_SEGMENT_COUNT];
+} History_index_t;
+
+typedef struct
+{
+    uint32_t from;
+    uint32_t to;
+    History_sink_t sink;
+    void *context;
+    bool stopped;
+} History_query_t;
+
+static CALYPSO *historyCalypso = NULL;
+static History_index_t historyIndex;
+static History_record_t currentSegment[HISTORY_RECORDS_PER_SEGMENT];
+static uint16_t unflushedRecords = 0;
+
+static void History_segmentPath(uint8_t segment, char *path);
+static bool History_writeIndex();
+static bool History_queryRecord(History_query_t *query, const History_record_t *record);
+static bool History_querySink(void *context, const uint8_t *data,
+                              uint16_t length, uint32_t offset);
+
+/**
+ * @brief  Load the history index and the segment being filled
+ * @param  calypso Pointer to the calypso object.
+ * @retval true if an existing history was found, false if a new one is started
+ */
+bool History_init(CALYPSO *calypso)
+{
+    uint16_t length = 0;
+    char path[HISTORY_PATH_MAX_LEN];
+    History_segment_t *segment;
+    const History_segment_t *previous;
+
+    historyCalypso = calypso;
+    unflushedRecords = 0;
+
+    if (!Calypso_fileExists(calypso, HISTORY_INDEX_PATH) ||
+        !Calypso_readFile(calypso, HISTORY_INDEX_PATH, (char *)&historyIndex,
+                          sizeof(historyIndex), &length) ||
+        (length != sizeof(historyIndex)) ||
+        (historyIndex.version != HISTORY_INDEX_VERSION) ||
+        (historyIndex.recordsPerSegment != HISTORY_RECORDS_PER_SEGMENT) ||
+        (historyIndex.head >= HISTORY_SEGMENT_COUNT))
+    {
+        memset(&historyIndex, 0, sizeof(historyIndex));
+        historyIndex.version = HISTORY_INDEX_VERSION;
+        historyIndex.recordsPerSegment = HISTORY_RECORDS_PER_SEGMENT;
+        return false;
+    }
+
+    /* The index only knows the completed segments, the current one is read back */
+    segment = &historyIndex.segments[historyIndex.head];
+    previous = &historyIndex.segments[(historyIndex.head + HISTORY_SEGMENT_COUNT - 1) %
+                                      HISTORY_SEGMENT_COUNT];
+    segment->count = 0;
+    History_segmentPath(historyIndex.head, path);
+    if (Calypso_fileExists(calypso, path) &&
+        Calypso_readFile(calypso, path, (char *)currentSegment,
+                         sizeof(currentSegment), &length))
+    {
+        segment->count = length / sizeof(History_record_t);
+    }
+    /* Records older than the previous segment were left by an earlier lap */
+    if ((segment->count > 0) && (previous->count > 0) &&
+        (currentSegment[0].timestamp < previous->last))
+    {
+        segment->count = 0;
+    }
+    if (segment->count > 0)
+    {
+        segment->first = currentSegment[0].timestamp;
+        segment->last = currentSegment[segment->count - 1].timestamp;
+    }
+    return true;
+}
+
+/**
+ * @brief  Append a record to the history
+ * @param  record Pointer to the record, timestamps must not decrease
+ * @retval true if successful false in case of failure
+ */
+bool History_append(const History_record_t *record)
+{
+    bool ret = true;
+    History_segment_t *segment = &historyIndex.segments[historyIndex.head];
+
+    if (historyCalypso == NULL)
+    {
+        return false;
+    }
+
+    if (segment->count >= HISTORY_RECORDS_PER_SEGMENT)
+    {
+        /* Start the next segment, dropping the oldest one when the ring is full.
+        Its file goes first, a reboot before the next flush would otherwise
+        read the old records back as the current segment */
+        char path[HISTORY_PATH_MAX_LEN];
+        historyIndex.head = (historyIndex.head + 1) % HISTORY_SEGMENT_COUNT;
+        segment = &historyIndex.segments[historyIndex.head];
+        memset(segment, 0, sizeof(History_segment_t));
+        History_segmentPath(historyIndex.head, path);
+        if (Calypso_fileExists(historyCalypso, path))
+        {
+            Calypso_deleteFile(historyCalypso, path);
+        }
+        History_writeIndex();
+    }
+
+    if (segment->count == 0)
+    {
+        segment->first = record->timestamp;
+    }
+    segment->last = record->timestamp;
+    currentSegment[segment->count++] = *record;
+    unflushedRecords++;
+
+    if ((unflushedRecords >= HISTORY_FLUSH_RECORDS) ||
+        (segment->count >= HISTORY_RECORDS_PER_SEGMENT))
+    {
+        ret = History_flush();
+    }
+    return ret;
+}
+
+/**
+ * @brief  Write the records of the current segment to the file system
+ * @retval true if successful false in case of failure
+ */
+bool History_flush()
+{
+    char path[HISTORY_PATH_MAX_LEN];
+    History_segment_t *segment = &historyIndex.segments[historyIndex.head];
+
+    if ((historyCalypso == NULL) || (unflushedRecords == 0))
+    {
+        return true;
+    }
+    History_segmentPath(historyIndex.head, path);
+    if (!Calypso_writeFileBulk(historyCalypso, path, (const uint8_t *)currentSegment,
+                               segment->count * sizeof(History_record_t), false, NULL))
+    {
+        return false;
+    }
+    unflushedRecords = 0;
+    return true;
+}
+
+/**
+ * @brief  Pass all records of a time range to a sink, oldest first. Only the
+ *         segments that overlap the range are read.
+ * @param  from Start of the range, Unix time in seconds
+ * @param  to End of the range, Unix time in seconds
+ * @param  sink Callback receiving the records
+ * @param  context User pointer passed to the callback
+ * @retval true if successful false in case of failure
+ */
+bool History_query(uint32_t from, uint32_t to, History_sink_t sink,
+                   void *context)
+{
+    char path[HISTORY_PATH_MAX_LEN];
+    History_query_t query = {from, to, sink, context, false};
+
+    if (historyCalypso == NULL)
+    {
+        return false;
+    }
+
+    for (uint8_t i = 1; (i <= HISTORY_SEGMENT_COUNT) && !query.stopped; i++)
+    {
+        uint8_t index = (historyIndex.head + i) % HISTORY_SEGMENT_COUNT;
+        const History_segment_t *segment = &historyIndex.segments[index];
+
+        if ((segment->count == 0) || (segment->last < from) || (segment->first > to))
+        {
+            continue;
+        }
+        if (index == historyIndex.head)
+        {
+            for (uint16_t record = 0; (record < segment->count) && !query.stopped; record++)
+            {
+                History_queryRecord(&query, &currentSegment[record]);
+            }
+        }
+        else
+        {
+            History_segmentPath(index, path);
+            if (!Calypso_readFileStream(historyCalypso, path, 0, History_querySink,
+                                        &query, NULL))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief  Get the number of records in the history
+ * @retval Number of records
+ */
+uint16_t History_getRecordCount()
+{
+    uint16_t count = 0;
+    for (uint8_t i = 0; i < HISTORY_SEGMENT_COUNT; i++)
+    {
+        count += historyIndex.segments[i].count;
+    }
+    return count;
+}
+
+/**
+ * @brief  Get the file path of a segment
+ * @param  segment Segment number
+ * @param  path Buffer of HISTORY_PATH_MAX_LEN characters
+ * @retval None
+ */
+static void History_segmentPath(uint8_t segment, char *path)
+{
+    snprintf(path, HISTORY_PATH_MAX_LEN, HISTORY_SEGMENT_PATH, segment);
+}
+
+/**
+ * @brief  Persist the index of the segments
+ * @retval true if successful false in case of failure
+ */
+static bool History_writeIndex()
+{
+    return Calypso_writeFileBulk(historyCalypso, HISTORY_INDEX_PATH,
+                                 (const uint8_t *)&historyIndex,
+                                 sizeof(historyIndex), false, NULL);
+}
+
+/**
+ * @brief  Pass a record to the sink of a query if it is in the range
+ * @param  query Pointer to the query
+ * @param  record Pointer to the record
+ * @retval false once the end of the range is reached
+ */
+static bool History_queryRecord(History_query_t *query, const History_record_t *record)
+{
+    if (record->timestamp > query->to)
+    {
+        query->stopped = true;
+    }
+    else if ((record->timestamp >= query->from) &&
+             !query->sink(query->context, record))
+    {
+        query->stopped = true;
+    }
+    return !query->stopped;
+}
+
+/**
+ * @brief  Split a chunk of a segment file into records
+ * @retval true to continue reading the segment
+ */
+static bool History_querySink(void *context, const uint8_t *data,
+                              uint16_t length, uint32_t offset)
+{
+    History_query_t *query = (History_query_t *)context;
+    History_record_t record;
+
+    (void)offset;
+    /* Chunks are a multiple of the record size */
+    for (uint16_t i = 0; (i + sizeof(record)) <= length; i += sizeof(record))
+    {
+        memcpy(&record, data + i, sizeof(record));
+        if (!History_queryRecord(query, &record))
+        {
+            return false;
+        }
+    }
+    return true;
+}
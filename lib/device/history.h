@@ -0,0 +1,87 @@
+/**
+ * \file
+ * \brief Circular history of sensor samples stored on the Calypso file system.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "calypsoBoard.h"
+
+/*
+ * Samples are stored as fixed size binary records in a ring of segment
+ * files. The segment being filled is kept in RAM and written as a whole
+ * every HISTORY_FLUSH_RECORDS records, completed segments are never touched
+ * again until the ring wraps around. The time range covered by every
+ * segment is kept in a small index that is persisted when a segment is
+ * completed, so that queries only read the segments they need.
+ */
+#define HISTORY_SEGMENT_PATH "user/hist%u"
+#define HISTORY_INDEX_PATH "user/histidx"
+#ifndef HISTORY_RECORDS_PER_SEGMENT
+#define HISTORY_RECORDS_PER_SEGMENT 60 /* one hour at one minute resolution */
+#endif
+#ifndef HISTORY_SEGMENT_COUNT
+#define HISTORY_SEGMENT_COUNT 25 /* 24 h of completed segments plus the current one */
+#endif
+#define HISTORY_FLUSH_RECORDS 15
+#define HISTORY_SAMPLE_INTERVAL 60 /* seconds */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief One sample, values are scaled to integers to keep records small
+     */
+    typedef struct
+    {
+        uint32_t timestamp;  /* Unix time in seconds */
+        int16_t temperature; /* 0.01 °C */
+        uint16_t humidity;   /* 0.01 %RH */
+        uint16_t pressure;   /* 0.01 kPa */
+        int16_t accelX;      /* mg */
+        int16_t accelY;      /* mg */
+        int16_t accelZ;      /* mg */
+    } History_record_t;
+
+    /**
+     * @brief Consumer of the records returned by History_query.
+     * Return false to stop the query.
+     */
+    typedef bool (*History_sink_t)(void *context, const History_record_t *record);
+
+    bool History_init(CALYPSO *calypso);
+    bool History_append(const History_record_t *record);
+    bool History_flush();
+    bool History_query(uint32_t from, uint32_t to, History_sink_t sink,
+                       void *context);
+    uint16_t History_getRecordCount();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HISTORY_H */
@@ -0,0 +1,515 @@
+/**
+ * \file
+ * \brief Registry of the sensors of the design kit and their sampling.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "sensors.h"
+#include "reportFilter.h"
+#include "sensorBoard.h"
+#include "debug.h"
+
+#define SENSORS_BIT(sensor) ((uint32_t)1 << (sensor))
+
+/*State of a sensor found at boot*/
+typedef struct
+{
+    const Sensors_descriptor_t *descriptor;
+    unsigned long lastSample; /* time of the last trigger */
+    bool pending;             /* triggered, not read yet */
+    float values[SENSORS_MAX_CHANNELS];
+    Aggregate_t aggregates[SENSORS_MAX_CHANNELS];
+    ReportFilter_t filters[SENSORS_MAX_CHANNELS];
+} Sensors_state_t;
+
+static bool Sensors_readPressure(float *values);
+static bool Sensors_readAcceleration(float *values);
+static bool Sensors_readTemperature(float *values);
+static bool Sensors_readHumidity1(float *values);
+static bool Sensors_readHumidity2(float *values);
+static bool Sensors_provides(Sensors_Quantity_t quantity);
+static bool Sensors_collect(Sensors_state_t *sensor, bool aggregate);
+
+/*At most 32 entries, sensors are published in this order*/
+static const Sensors_descriptor_t sensorTable[] = {
+    {"WSEN-PADS", NULL, CBOR_KEY_PRESSURE,
+     PADS_2511020213301_probe, PADS_2511020213301_configure,
+     PADS_2511020213301_trigger, Sensors_readPressure,
+     PADS_2511020213301_CONVERSION_TIME, PRESSURE_SAMPLE_PERIOD, 1,
+     {{"pressure", "kPa", Sensors_Quantity_Pressure, PRESSURE_DECIMALS, 100,
+       PRESSURE_DEADBAND, PRESSURE_RATE}}},
+    {"WSEN-HIDS-2525020210002", NULL, CBOR_KEY_HUMIDITY,
+     HIDS_2525020210002_probe, NULL,
+     HIDS_2525020210002_trigger, Sensors_readHumidity2,
+     HIDS_2525020210002_CONVERSION_TIME, HUMIDITY_SAMPLE_PERIOD, 1,
+     {{"humidity", "%", Sensors_Quantity_Humidity, HUMIDITY_DECIMALS, 100,
+       HUMIDITY_DEADBAND, HUMIDITY_RATE}}},
+    {"WSEN-HIDS-2525020210001", NULL, CBOR_KEY_HUMIDITY,
+     HIDS_2525020210001_probe, HIDS_2525020210001_configure,
+     HIDS_2525020210001_trigger, Sensors_readHumidity1,
+     HIDS_2525020210001_CONVERSION_TIME, HUMIDITY_SAMPLE_PERIOD, 1,
+     {{"humidity", "%", Sensors_Quantity_Humidity, HUMIDITY_DECIMALS, 100,
+       HUMIDITY_DEADBAND, HUMIDITY_RATE}}},
+    {"WSEN-TIDS", NULL, CBOR_KEY_TEMPERATURE,
+     TIDS_2521020222501_probe, NULL,
+     TIDS_2521020222501_trigger, Sensors_readTemperature,
+     TIDS_2521020222501_CONVERSION_TIME, TEMPERATURE_SAMPLE_PERIOD, 1,
+     {{"temperature", "°C", Sensors_Quantity_Temperature, TEMPERATURE_DECIMALS, 100,
+       TEMPERATURE_DEADBAND, TEMPERATURE_RATE}}},
+    {"WSEN-ITDS", "acceleration", CBOR_KEY_ACCELERATION,
+     ITDS_2533020201601_probe, ITDS_2533020201601_configure,
+     ITDS_2533020201601_trigger, Sensors_readAcceleration,
+     ITDS_2533020201601_CONVERSION_TIME, ACCELERATION_SAMPLE_PERIOD, 3,
+     {{"x", "g", Sensors_Quantity_AccelerationX, ACCELERATION_DECIMALS, 1000,
+       ACCELERATION_DEADBAND, ACCELERATION_RATE},
+      {"y", "g", Sensors_Quantity_AccelerationY, ACCELERATION_DECIMALS, 1000,
+       ACCELERATION_DEADBAND, ACCELERATION_RATE},
+      {"z", "g", Sensors_Quantity_AccelerationZ, ACCELERATION_DECIMALS, 1000,
+       ACCELERATION_DEADBAND, ACCELERATION_RATE}}}};
+
+#define SENSORS_TABLE_SIZE (sizeof(sensorTable) / sizeof(sensorTable[0]))
+
+static Sensors_state_t sensors[SENSORS_TABLE_SIZE];
+static uint8_t sensorCount = 0;
+
+/**
+ * @brief Probe the sensors of the table and configure the ones found.
+ * The I2C bus must have been initialized.
+ * @retval Number of sensors found.
+ */
+uint8_t Sensors_init()
+{
+    sensorCount = 0;
+    for (uint8_t i = 0; i < SENSORS_TABLE_SIZE; i++)
+    {
+        const Sensors_descriptor_t *descriptor = &sensorTable[i];
+
+        /*Another variant of the part was found already*/
+        if (Sensors_provides(descriptor->channels[0].quantity))
+        {
+            continue;
+        }
+        if (!descriptor->probe())
+        {
+            WE_DEBUG_PRINT("%s not found\r\n", descriptor->name);
+            continue;
+        }
+        if ((descriptor->init != NULL) && !descriptor->init())
+        {
+            WE_DEBUG_PRINT("%s init failed\r\n", descriptor->name);
+            continue;
+        }
+        Sensors_state_t *sensor = &sensors[sensorCount++];
+        memset(sensor, 0, sizeof(*sensor));
+        sensor->descriptor = descriptor;
+        for (uint8_t c = 0; c < descriptor->channelCount; c++)
+        {
+            ReportFilter_setThresholds(&sensor->filters[c], descriptor->channels[c].deadband,
+                                       descriptor->channels[c].rate);
+        }
+    }
+    return sensorCount;
+}
+
+/**
+ * @brief Get the number of sensors found at boot.
+ * @retval Number of sensors.
+ */
+uint8_t Sensors_getCount()
+{
+    return sensorCount;
+}
+
+/**
+ * @brief Get the descriptor of a sensor found at boot.
+ * @param sensor Index of the sensor, below Sensors_getCount().
+ * @retval Descriptor.
+ */
+const Sensors_descriptor_t *Sensors_get(uint8_t sensor)
+{
+    return sensors[sensor].descriptor;
+}
+
+/**
+ * @brief Get the key of a sensor in the telemetry, the name of its group or
+ * of its only channel.
+ * @param sensor Index of the sensor, below Sensors_getCount().
+ * @retval Key.
+ */
+const char *Sensors_getKey(uint8_t sensor)
+{
+    const Sensors_descriptor_t *descriptor = sensors[sensor].descriptor;
+
+    return (descriptor->group != NULL) ? descriptor->group : descriptor->channels[0].name;
+}
+
+/**
+ * @brief Sample the sensors without blocking: read the conversions that are
+ * done and add them to the aggregates, then trigger the sensors whose sample
+ * period has elapsed.
+ * @retval Time in ms until the next triggered conversion is done,
+ * SENSOR_SAMPLE_TICK if none is pending.
+ */
+unsigned long Sensors_sample()
+{
+    unsigned long now = millis();
+    unsigned long next = SENSOR_SAMPLE_TICK;
+
+    for (uint8_t i = 0; i < sensorCount; i++)
+    {
+        Sensors_state_t *sensor = &sensors[i];
+        if (sensor->pending &&
+            ((now - sensor->lastSample) >= sensor->descriptor->conversionTime))
+        {
+            Sensors_collect(sensor, true);
+        }
+    }
+
+    for (uint8_t i = 0; i < sensorCount; i++)
+    {
+        Sensors_state_t *sensor = &sensors[i];
+        unsigned long conversionTime = sensor->descriptor->conversionTime;
+
+        if (!sensor->pending && ((now - sensor->lastSample) >= sensor->descriptor->period))
+        {
+            sensor->lastSample = now;
+            sensor->pending = sensor->descriptor->trigger();
+        }
+        if (sensor->pending)
+        {
+            unsigned long elapsed = now - sensor->lastSample;
+            unsigned long remaining = (elapsed < conversionTime) ? (conversionTime - elapsed) : 0;
+            if (remaining < next)
+            {
+                next = remaining;
+            }
+        }
+    }
+    return next;
+}
+
+/**
+ * @brief Read the sensors right away: trigger all conversions back to back,
+ * wait once for the longest one and read the results. The read takes the
+ * longest conversion time instead of the sum of them.
+ * @param missingOnly true to read only the sensors without a sample in the
+ * current interval and add the values to the aggregates.
+ * @retval Bit mask of the sensors read, bit n for the sensor with index n.
+ */
+uint32_t Sensors_readNow(bool missingOnly)
+{
+    uint32_t triggered = 0;
+    uint32_t collected = 0;
+    unsigned long wait = 0;
+    unsigned long now = millis();
+
+    for (uint8_t i = 0; i < sensorCount; i++)
+    {
+        Sensors_state_t *sensor = &sensors[i];
+        unsigned long conversionTime = sensor->descriptor->conversionTime;
+
+        if (missingOnly && (sensor->aggregates[0].count != 0))
+        {
+            continue;
+        }
+        /*A conversion started by Sensors_sample is reused*/
+        if (!sensor->pending)
+        {
+            sensor->lastSample = now;
+            sensor->pending = sensor->descriptor->trigger();
+        }
+        if (sensor->pending)
+        {
+            unsigned long elapsed = now - sensor->lastSample;
+            if ((elapsed < conversionTime) && ((conversionTime - elapsed) > wait))
+            {
+                wait = conversionTime - elapsed;
+            }
+            triggered |= SENSORS_BIT(i);
+        }
+    }
+    if (triggered == 0)
+    {
+        return 0;
+    }
+    delay(wait);
+
+    for (uint8_t i = 0; i < sensorCount; i++)
+    {
+        if ((triggered & SENSORS_BIT(i)) == 0)
+        {
+            continue;
+        }
+        if (Sensors_collect(&sensors[i], missingOnly))
+        {
+            collected |= SENSORS_BIT(i);
+        }
+    }
+    return collected;
+}
+
+/**
+ * @brief Start a new interval, the last values are kept.
+ * @retval None.
+ */
+void Sensors_resetAggregates()
+{
+    for (uint8_t i = 0; i < sensorCount; i++)
+    {
+        for (uint8_t c = 0; c < SENSORS_MAX_CHANNELS; c++)
+        {
+            Aggregate_reset(&sensors[i].aggregates[c]);
+        }
+    }
+}
+
+/**
+ * @brief Get the aggregate of a channel over the current interval.
+ * @param sensor Index of the sensor, below Sensors_getCount().
+ * @param channel Index of the channel of the sensor.
+ * @retval Aggregate.
+ */
+const Aggregate_t *Sensors_getAggregate(uint8_t sensor, uint8_t channel)
+{
+    return &sensors[sensor].aggregates[channel];
+}
+
+/**
+ * @brief Get a statistic of a channel over the current interval.
+ * @param sensor Index of the sensor, below Sensors_getCount().
+ * @param channel Index of the channel of the sensor.
+ * @param statistic Statistic.
+ * @retval Value, the last sample if the interval has no samples.
+ */
+float Sensors_getStatistic(uint8_t sensor, uint8_t channel, Sensors_Statistic_t statistic)
+{
+    const Aggregate_t *aggregate = &sensors[sensor].aggregates[channel];
+
+    if (aggregate->count == 0)
+    {
+        return aggregate->last;
+    }
+    switch (statistic)
+    {
+    case Sensors_Statistic_Min:
+        return aggregate->min;
+    case Sensors_Statistic_Max:
+        return aggregate->max;
+    default:
+        return Aggregate_mean(aggregate);
+    }
+}
+
+/**
+ * @brief Get the last value read of a quantity.
+ * @param quantity Quantity.
+ * @param value Value, 0 if no sensor measures the quantity.
+ * @retval true if a sensor measures the quantity, false otherwise.
+ */
+bool Sensors_getValue(Sensors_Quantity_t quantity, float *value)
+{
+    for (uint8_t i = 0; i < sensorCount; i++)
+    {
+        const Sensors_descriptor_t *descriptor = sensors[i].descriptor;
+        for (uint8_t c = 0; c < descriptor->channelCount; c++)
+        {
+            if (descriptor->channels[c].quantity == quantity)
+            {
+                *value = sensors[i].values[c];
+                return true;
+            }
+        }
+    }
+    *value = 0;
+    return false;
+}
+
+/**
+ * @brief Get the last value read of a quantity as integer, multiplied with
+ * the scale of its channel.
+ * @param quantity Quantity.
+ * @retval Scaled value, 0 if no sensor measures the quantity.
+ */
+int32_t Sensors_getScaledValue(Sensors_Quantity_t quantity)
+{
+    for (uint8_t i = 0; i < sensorCount; i++)
+    {
+        const Sensors_descriptor_t *descriptor = sensors[i].descriptor;
+        for (uint8_t c = 0; c < descriptor->channelCount; c++)
+        {
+            if (descriptor->channels[c].quantity == quantity)
+            {
+                return (int32_t)(sensors[i].values[c] * descriptor->channels[c].scale);
+            }
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Set the report-by-exception thresholds of all channels of a sensor.
+ * @param key Key of the sensor in the telemetry, see Sensors_getKey().
+ * @param deadband Change since the last report, 0 disables the check.
+ * @param rate Change per second between two intervals, 0 disables the check.
+ * @retval true if successful, false if no sensor has the key.
+ */
+bool Sensors_setReportThresholds(const char *key, float deadband, float rate)
+{
+    for (uint8_t i = 0; i < sensorCount; i++)
+    {
+        if (strcmp(Sensors_getKey(i), key) != 0)
+        {
+            continue;
+        }
+        for (uint8_t c = 0; c < sensors[i].descriptor->channelCount; c++)
+        {
+            ReportFilter_setThresholds(&sensors[i].filters[c], deadband, rate);
+        }
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Get the report-by-exception thresholds of a sensor.
+ * @param sensor Index of the sensor, below Sensors_getCount().
+ * @param deadband Change since the last report.
+ * @param rate Change per second between two intervals.
+ * @retval None.
+ */
+void Sensors_getReportThresholds(uint8_t sensor, float *deadband, float *rate)
+{
+    *deadband = sensors[sensor].filters[0].deadband;
+    *rate = sensors[sensor].filters[0].rate;
+}
+
+/**
+ * @brief Check the means of the current interval against the
+ * report-by-exception thresholds.
+ * @param all true to select all sensors, e.g. for a heartbeat.
+ * @retval Bit mask of the sensors with a channel to report, bit n for the
+ * sensor with index n.
+ */
+uint32_t Sensors_selectReport(bool all)
+{
+    uint32_t selected = 0;
+    unsigned long now = millis();
+
+    for (uint8_t i = 0; i < sensorCount; i++)
+    {
+        bool report = all;
+        for (uint8_t c = 0; c < sensors[i].descriptor->channelCount; c++)
+        {
+            float value = Sensors_getStatistic(i, c, Sensors_Statistic_Mean);
+            /*Every channel is checked to track its rate of change*/
+            if (ReportFilter_check(&sensors[i].filters[c], value, now))
+            {
+                report = true;
+            }
+        }
+        if (report)
+        {
+            selected |= SENSORS_BIT(i);
+        }
+    }
+    return selected;
+}
+
+/**
+ * @brief Take the values checked by the last Sensors_selectReport() as
+ * reported.
+ * @param published Bit mask of the sensors published.
+ * @retval None.
+ */
+void Sensors_commitReport(uint32_t published)
+{
+    for (uint8_t i = 0; i < sensorCount; i++)
+    {
+        if ((published & SENSORS_BIT(i)) == 0)
+        {
+            continue;
+        }
+        for (uint8_t c = 0; c < sensors[i].descriptor->channelCount; c++)
+        {
+            ReportFilter_commit(&sensors[i].filters[c]);
+        }
+    }
+}
+
+static bool Sensors_provides(Sensors_Quantity_t quantity)
+{
+    float value;
+    return Sensors_getValue(quantity, &value);
+}
+
+/**
+ * @brief Read the finished conversion of a sensor.
+ * @param sensor Sensor.
+ * @param aggregate true to add the values to the aggregates.
+ * @retval true if successful, false otherwise.
+ */
+static bool Sensors_collect(Sensors_state_t *sensor, bool aggregate)
+{
+    float values[SENSORS_MAX_CHANNELS];
+
+    sensor->pending = false;
+    if (!sensor->descriptor->read(values))
+    {
+        return false;
+    }
+    for (uint8_t c = 0; c < sensor->descriptor->channelCount; c++)
+    {
+        sensor->values[c] = values[c];
+        if (aggregate)
+        {
+            Aggregate_add(&sensor->aggregates[c], values[c]);
+        }
+    }
+    return true;
+}
+
+static bool Sensors_readPressure(float *values)
+{
+    return PADS_2511020213301_collect(&values[0], NULL);
+}
+
+static bool Sensors_readAcceleration(float *values)
+{
+    return ITDS_2533020201601_readSensorData(&values[0], &values[1], &values[2], NULL);
+}
+
+static bool Sensors_readTemperature(float *values)
+{
+    return TIDS_2521020222501_collect(&values[0]);
+}
+
+static bool Sensors_readHumidity1(float *values)
+{
+    return HIDS_2525020210001_collect(&values[0], NULL);
+}
+
+static bool Sensors_readHumidity2(float *values)
+{
+    return HIDS_2525020210002_collect(&values[0], NULL);
+}
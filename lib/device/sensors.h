@@ -0,0 +1,168 @@
+/**
+ * \file
+ * \brief Registry of the sensors of the design kit and their sampling.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+#ifndef SENSORS_H
+#define SENSORS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "aggregate.h"
+
+/*
+ * Every sensor the firmware knows is described by an entry of a constant
+ * table: how to probe and configure it, how to read it in two phases and
+ * the channels it reports. The table is probed once at boot, only the
+ * sensors found are sampled and published. Variants of a part that report
+ * the same quantity are listed one after the other, the first one found is
+ * used. Supporting another sensor only means adding an entry to the table.
+ */
+
+#define SENSORS_MAX_CHANNELS 3
+
+/*Decimals of the telemetry values, matching the rounding done in sensorBoard.c*/
+#define PRESSURE_DECIMALS 3
+#define TEMPERATURE_DECIMALS 2
+#define HUMIDITY_DECIMALS 2
+#define ACCELERATION_DECIMALS 3
+
+/*Background sampling, telemetry reports the aggregates of each interval*/
+#define SENSOR_SAMPLE_TICK 100 // ms, period of the sampling task
+#ifndef PRESSURE_SAMPLE_PERIOD
+#define PRESSURE_SAMPLE_PERIOD 1000 // ms
+#endif
+#ifndef ACCELERATION_SAMPLE_PERIOD
+#define ACCELERATION_SAMPLE_PERIOD 100 // ms
+#endif
+#ifndef TEMPERATURE_SAMPLE_PERIOD
+#define TEMPERATURE_SAMPLE_PERIOD 1000 // ms
+#endif
+#ifndef HUMIDITY_SAMPLE_PERIOD
+#define HUMIDITY_SAMPLE_PERIOD 1000 // ms
+#endif
+
+/*Report-by-exception thresholds, 0 disables the check, see reportFilter.h*/
+#ifndef PRESSURE_DEADBAND
+#define PRESSURE_DEADBAND 0 // kPa
+#endif
+#ifndef PRESSURE_RATE
+#define PRESSURE_RATE 0 // kPa/s
+#endif
+#ifndef HUMIDITY_DEADBAND
+#define HUMIDITY_DEADBAND 0 // %RH
+#endif
+#ifndef HUMIDITY_RATE
+#define HUMIDITY_RATE 0 // %RH/s
+#endif
+#ifndef TEMPERATURE_DEADBAND
+#define TEMPERATURE_DEADBAND 0 // °C
+#endif
+#ifndef TEMPERATURE_RATE
+#define TEMPERATURE_RATE 0 // °C/s
+#endif
+#ifndef ACCELERATION_DEADBAND
+#define ACCELERATION_DEADBAND 0 // g
+#endif
+#ifndef ACCELERATION_RATE
+#define ACCELERATION_RATE 0 // g/s
+#endif
+
+/*Integer keys of the sensors in the CBOR telemetry map*/
+#define CBOR_KEY_PRESSURE 1
+#define CBOR_KEY_HUMIDITY 2
+#define CBOR_KEY_TEMPERATURE 3
+#define CBOR_KEY_ACCELERATION 4 /* array [x, y, z] */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief Physical quantity of a channel, used to find a value
+     * independently of the sensor that measures it
+     */
+    typedef enum
+    {
+        Sensors_Quantity_Pressure,
+        Sensors_Quantity_Humidity,
+        Sensors_Quantity_Temperature,
+        Sensors_Quantity_AccelerationX,
+        Sensors_Quantity_AccelerationY,
+        Sensors_Quantity_AccelerationZ,
+        Sensors_Quantity_NumberOfValues
+    } Sensors_Quantity_t;
+
+    typedef enum
+    {
+        Sensors_Statistic_Mean,
+        Sensors_Statistic_Min,
+        Sensors_Statistic_Max
+    } Sensors_Statistic_t;
+
+    typedef struct
+    {
+        const char *name;            /* key in the JSON telemetry */
+        const char *unit;
+        Sensors_Quantity_t quantity;
+        uint8_t decimals;            /* decimals published */
+        float scale;                 /* factor to the integer history value */
+        float deadband;              /* default report-by-exception thresholds */
+        float rate;
+    } Sensors_channel_t;
+
+    typedef struct
+    {
+        const char *name;                /* part name for the debug output */
+        const char *group;               /* JSON object of the channels, NULL for top level */
+        uint8_t cborKey;                 /* CBOR key, an array if several channels */
+        bool (*probe)();                 /* true if the part answers */
+        bool (*init)();                  /* configure the part, NULL if not needed */
+        bool (*trigger)();               /* start a conversion */
+        bool (*read)(float *values);     /* read the finished conversion */
+        unsigned long conversionTime;    /* ms between trigger and read */
+        unsigned long period;            /* ms between two samples */
+        uint8_t channelCount;
+        Sensors_channel_t channels[SENSORS_MAX_CHANNELS];
+    } Sensors_descriptor_t;
+
+    uint8_t Sensors_init();
+    uint8_t Sensors_getCount();
+    const Sensors_descriptor_t *Sensors_get(uint8_t sensor);
+    const char *Sensors_getKey(uint8_t sensor);
+    unsigned long Sensors_sample();
+    uint32_t Sensors_readNow(bool missingOnly);
+    void Sensors_resetAggregates();
+    const Aggregate_t *Sensors_getAggregate(uint8_t sensor, uint8_t channel);
+    float Sensors_getStatistic(uint8_t sensor, uint8_t channel, Sensors_Statistic_t statistic);
+    bool Sensors_getValue(Sensors_Quantity_t quantity, float *value);
+    int32_t Sensors_getScaledValue(Sensors_Quantity_t quantity);
+    bool Sensors_setReportThresholds(const char *key, float deadband, float rate);
+    void Sensors_getReportThresholds(uint8_t sensor, float *deadband, float *rate);
+    uint32_t Sensors_selectReport(bool all);
+    void Sensors_commitReport(uint32_t published);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SENSORS_H */
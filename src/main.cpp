@@ -25,6 +25,22 @@
  */
 
 #include "device.h"
+#include "scheduler.h"
+
+/*Task periods in ms*/
+#define BUTTON_SCAN_PERIOD 10
+#define STATE_PERIOD 100
+#define CLOUD_PERIOD 20
+#define HEALTH_PERIOD 1000
+#define CLOCK_SYNC_PERIOD 3600000
+/*Retry while Calypso has no SNTP time yet*/
+#define CLOCK_RETRY_PERIOD 10000
+/*Delay between the steps of the states that wait for the user*/
+#define FIRMWARE_MESSAGE_PERIOD 5000
+#define CONFIGURATION_BLINK_PERIOD 3500
+#define ERROR_MESSAGE_PERIOD 1000
+/*Number of health checks between two scheduler statistics reports*/
+#define SCHEDULER_REPORT_INTERVAL 60
 
 // Serial Ports
 //------User Debug Interface
@@ -38,19 +54,42 @@ enum
     provisioning,
     connectingToCloud,
     idle,
-    sendSensorData,
     errorState,
     factoryReset,
     numOfStatus
 } statusFlag;
 
-/*Timer to periodically send sensor data*/
-unsigned long startTime = 0;
-unsigned long interval = 0;
 volatile uint8_t buttonPressCount = 0;
+bool cloudConnected = true;
 
 char displayText[100];
 
+static void stateTask(void *context);
+static void buttonTask(void *context);
+static void healthTask(void *context);
+static void cloudTask(void *context);
+static void samplingTask(void *context);
+static void publishTask(void *context);
+#if ACCELERATION_STREAM
+static void accelerationTask(void *context);
+#endif
+static void displayTask(void *context);
+static void clockTask(void *context);
+
+/*Lower numbers run first when several tasks are due*/
+static Scheduler_task_t buttonScan = SCHEDULER_TASK("button", buttonTask, NULL, 0);
+static Scheduler_task_t stateMachine = SCHEDULER_TASK("state", stateTask, NULL, 1);
+static Scheduler_task_t healthCheck = SCHEDULER_TASK("health", healthTask, NULL, 1);
+static Scheduler_task_t sampling = SCHEDULER_TASK("sampling", samplingTask, NULL, 1);
+static Scheduler_task_t publish = SCHEDULER_TASK("publish", publishTask, NULL, 2);
+#if ACCELERATION_STREAM
+static Scheduler_task_t accelerationStream =
+    SCHEDULER_TASK("acceleration", accelerationTask, NULL, 2);
+#endif
+static Scheduler_task_t cloud = SCHEDULER_TASK("cloud", cloudTask, NULL, 3);
+static Scheduler_task_t displayRefresh = SCHEDULER_TASK("display", displayTask, NULL, 4);
+static Scheduler_task_t clockSync = SCHEDULER_TASK("clock", clockTask, NULL, 4);
+
 // Switch the device to configuration mode
 void OnBtnPress_C()
 {
@@ -61,6 +100,7 @@ void OnBtnPress_C()
         if (statusFlag == waitingForConfig)
         {
             statusFlag = configuringDevice;
+            Scheduler_delay(&stateMachine, 0);
         }
         buttonPressCount = 0;
     }
@@ -73,6 +113,7 @@ void OnBtnPress_B()
     if (buttonPressCount >= 1)
     {
         statusFlag = factoryReset;
+        Scheduler_delay(&stateMachine, 0);
         buttonPressCount = 0;
     }
 }
@@ -136,10 +177,38 @@ void setup()
     {
         statusFlag = invalidFirmwareVersion;
     }
+
+    Scheduler_add(&buttonScan);
+    Scheduler_add(&stateMachine);
+    Scheduler_add(&healthCheck);
+    Scheduler_add(&sampling);
+    Scheduler_add(&publish);
+#if ACCELERATION_STREAM
+    Scheduler_add(&accelerationStream);
+#endif
+    Scheduler_add(&cloud);
+    Scheduler_add(&displayRefresh);
+    Scheduler_add(&clockSync);
+    Scheduler_start(&buttonScan, 0, BUTTON_SCAN_PERIOD);
+    Scheduler_start(&stateMachine, 0, STATE_PERIOD);
 }
 
 void loop()
 {
+    Scheduler_run();
+}
+
+/**
+ * @brief Step through configuration, provisioning and connection. Waiting
+ *        states reschedule the task instead of blocking the other tasks.
+ * @param context Unused.
+ * @retval None.
+ */
+static void stateTask(void *context)
+{
+    static bool blinkOn = false;
+    (void)context;
+
     switch (statusFlag)
     {
     case invalidFirmwareVersion:
@@ -149,21 +218,26 @@ void loop()
         SSerial_printf(Debug, "Older firmware detected\r\n");
         sprintf(displayText, "Calypso Firmware old \r\n\r\nUpdate Calypso");
         SH1107_Display(1, 0, 16, displayText);
-        delay(5000);
+        Scheduler_delay(&stateMachine, FIRMWARE_MESSAGE_PERIOD);
         break;
     }
-    break;
     case waitingForConfig:
         /*Waiting on button press from the user*/
         break;
     case configuringDevice:
     {
-        Device_WiFi_provisioning();
-        Device_configurationInProgress();
-        neopixelSet(NEO_PIXEL_RED);
-        delay(3500);
-        neopixelSet(NEO_PIXEL_OFF);
-        delay(3500);
+        blinkOn = !blinkOn;
+        if (blinkOn)
+        {
+            Device_WiFi_provisioning();
+            Device_configurationInProgress();
+            neopixelSet(NEO_PIXEL_RED);
+        }
+        else
+        {
+            neopixelSet(NEO_PIXEL_OFF);
+        }
+        Scheduler_delay(&stateMachine, CONFIGURATION_BLINK_PERIOD);
     }
     break;
     case provisioning:
@@ -194,37 +268,24 @@ void loop()
             Device_ConnectToCloud();
             neopixelSet(NEO_PIXEL_GREEN);
             statusFlag = idle;
-        }
-        break;
-    }
-    case idle:
-    {
-        if (!Device_isStatusOK())
-        {
-            Device_restart();
-        }
-        Device_processCloudMessage();
-        if (sensorsPresent == true)
-        {
-            interval = micros() - startTime;
-            if (interval >= (telemetrySendInterval * 1000))
+            Scheduler_start(&healthCheck, 0, HEALTH_PERIOD);
+            Scheduler_start(&cloud, 0, CLOUD_PERIOD);
+            Scheduler_start(&clockSync, 0, CLOCK_SYNC_PERIOD);
+            if (Sensors_getCount() > 0)
             {
-                /*Time to send sensor data*/
-                statusFlag = sendSensorData;
-                startTime = micros();
-                interval = 0;
+                Scheduler_start(&sampling, 0, SENSOR_SAMPLE_TICK);
+                Scheduler_start(&publish, telemetrySendInterval, telemetrySendInterval);
+#if ACCELERATION_STREAM
+                Scheduler_start(&accelerationStream, ACCELERATION_STREAM_PERIOD,
+                                ACCELERATION_STREAM_PERIOD);
+#endif
             }
         }
-    }
-    break;
-    case sendSensorData:
-    {
-        SSerial_printf(Debug, "Publishing sensor data...\r\n");
-        Device_PublishSensorData();
-        Device_displaySensorData();
-        statusFlag = idle;
         break;
     }
+    case idle:
+        /*The cloud tasks run on their own*/
+        break;
     case errorState:
     {
         neopixelSet(NEO_PIXEL_RED);
@@ -232,7 +293,7 @@ void loop()
         SSerial_printf(Debug, "Error, unknown state...\r\n");
         sprintf(displayText, "Error state: \r\nReset/reconfigure device");
         SH1107_Display(1, 0, 24, displayText);
-        delay(1000);
+        Scheduler_delay(&stateMachine, ERROR_MESSAGE_PERIOD);
         break;
     }
     case factoryReset:
@@ -246,5 +307,153 @@ void loop()
     default:
         break;
     }
+}
+
+/**
+ * @brief Scan the buttons.
+ * @param context Unused.
+ * @retval None.
+ */
+static void buttonTask(void *context)
+{
+    (void)context;
     buttonUpdate();
 }
+
+/**
+ * @brief Restart on a module failure and report the task statistics.
+ * @param context Unused.
+ * @retval None.
+ */
+static void healthTask(void *context)
+{
+    static uint8_t reportCount = 0;
+    (void)context;
+
+    if (!Device_isStatusOK())
+    {
+        Device_restart();
+    }
+    if (++reportCount < SCHEDULER_REPORT_INTERVAL)
+    {
+        return;
+    }
+    reportCount = 0;
+    for (uint8_t i = 0; i < Scheduler_getTaskCount(); i++)
+    {
+        const Scheduler_task_t *task = Scheduler_getTask(i);
+        SSerial_printf(Debug, "%s: runs %lu max %lu us total %lu us late %lu ms\r\n",
+                       task->name, (unsigned long)task->statistics.runs,
+                       (unsigned long)task->statistics.maxRuntime,
+                       (unsigned long)task->statistics.totalRuntime,
+                       (unsigned long)task->statistics.maxLateness);
+    }
+}
+
+/**
+ * @brief Keep the cloud connection up, record history and handle cloud
+ *        messages.
+ * @param context Unused.
+ * @retval None.
+ */
+static void cloudTask(void *context)
+{
+    (void)context;
+
+    /*Samples are kept locally also while the cloud is unreachable*/
+    Device_recordHistory();
+    if (!Device_maintainConnection())
+    {
+        if (cloudConnected)
+        {
+            neopixelSet(NEO_PIXEL_ORANGE);
+            cloudConnected = false;
+        }
+        return;
+    }
+    if (!cloudConnected)
+    {
+        neopixelSet(NEO_PIXEL_GREEN);
+        cloudConnected = true;
+    }
+    /*Runs every CLOUD_PERIOD, so it does not wait for messages*/
+    Device_pollCloudMessage();
+}
+
+/**
+ * @brief Sample the sensors in the background of the telemetry interval.
+ * @param context Unused.
+ * @retval None.
+ */
+static void samplingTask(void *context)
+{
+    (void)context;
+    unsigned long next = Device_sampleSensors();
+    if (next < SENSOR_SAMPLE_TICK)
+    {
+        /*Come back when the triggered conversions are done*/
+        Scheduler_delay(&sampling, next);
+    }
+}
+
+/**
+ * @brief Publish the aggregated sensor data and follow changes of the send
+ *        interval.
+ * @param context Unused.
+ * @retval None.
+ */
+static void publishTask(void *context)
+{
+    (void)context;
+
+    Scheduler_setPeriod(&publish, telemetrySendInterval);
+    if (!cloudConnected)
+    {
+        return;
+    }
+    SSerial_printf(Debug, "Publishing sensor data...\r\n");
+    Device_PublishSensorData();
+    Scheduler_start(&displayRefresh, 0, 0);
+}
+
+#if ACCELERATION_STREAM
+/**
+ * @brief Publish the last acceleration sample on the acceleration stream.
+ * @param context Unused.
+ * @retval None.
+ */
+static void accelerationTask(void *context)
+{
+    (void)context;
+    if (!cloudConnected)
+    {
+        return;
+    }
+    Device_PublishAccelerationStream();
+}
+#endif
+
+/**
+ * @brief Show the last published sensor data.
+ * @param context Unused.
+ * @retval None.
+ */
+static void displayTask(void *context)
+{
+    (void)context;
+    Device_displaySensorData();
+}
+
+/**
+ * @brief Synchronize the clock with the SNTP time of Calypso.
+ * @param context Unused.
+ * @retval None.
+ */
+static void clockTask(void *context)
+{
+    (void)context;
+    if (!Device_syncClock())
+    {
+        Scheduler_delay(&clockSync, CLOCK_RETRY_PERIOD);
+    }
+}
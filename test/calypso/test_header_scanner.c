@@ -0,0 +1,102 @@
+/**
+ * \file
+ * \brief Regression tests of the header scanner of streamed MQTT messages.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+#include <string.h>
+
+#include "headerScanner.h"
+#include "check.h"
+
+/* Arguments of +eventmqtt:recv up to the payload, as in calypsoBoard.c */
+#define MQTT_RECV_HEADER_DELIMITERS 7
+
+/**
+ * @brief  Push a text and count the bytes that end the header
+ * @param  scanner Pointer to the scanner
+ * @param  text Text to push
+ * @param  end Receives the offset of the last byte that ended the header
+ * @retval Number of bytes that ended the header
+ */
+static int Test_push(HeaderScanner_t *scanner, const char *text, size_t *end)
+{
+    int ends = 0;
+
+    for (size_t i = 0; text[i] != '\0'; i++)
+    {
+        if (HeaderScanner_push(scanner, text[i]))
+        {
+            ends++;
+            *end = i;
+        }
+    }
+    return ends;
+}
+
+/* The header ends at its last delimiter and only there */
+static void Test_headerEnd(void)
+{
+    const char *line = "+eventmqtt:recv,calypso/kit/config,0,0,0,0,12,{\"a\":1,\"b\":2}";
+    HeaderScanner_t scanner;
+    size_t end = 0;
+
+    HeaderScanner_init(&scanner, ',', MQTT_RECV_HEADER_DELIMITERS);
+    CHECK(Test_push(&scanner, line, &end) == 1);
+    CHECK(end == (size_t)(strstr(line, ",12,") + 3 - line));
+}
+
+/* A payload with more delimiters than a uint8_t counts must not end the
+ * header a second time (it did at comma 263) */
+static void Test_manyPayloadDelimiters(void)
+{
+    char line[1024];
+    HeaderScanner_t scanner;
+    size_t end = 0;
+    size_t length = strlen(strcpy(line, "+eventmqtt:recv,t,0,0,0,0,600,"));
+
+    memset(&line[length], ',', 600);
+    line[length + 600] = '\0';
+    HeaderScanner_init(&scanner, ',', MQTT_RECV_HEADER_DELIMITERS);
+    CHECK(Test_push(&scanner, line, &end) == 1);
+    CHECK(end == length - 1);
+}
+
+/* Every line starts over */
+static void Test_nextLine(void)
+{
+    HeaderScanner_t scanner;
+    size_t end = 0;
+
+    HeaderScanner_init(&scanner, ',', 2);
+    CHECK(Test_push(&scanner, "a,b,c,d", &end) == 1);
+    HeaderScanner_init(&scanner, ',', 2);
+    CHECK(Test_push(&scanner, "a,b", &end) == 0);
+    CHECK(Test_push(&scanner, ",c", &end) == 1);
+}
+
+int main(void)
+{
+    Test_headerEnd();
+    Test_manyPayloadDelimiters();
+    Test_nextLine();
+    printf("test_header_scanner: %s\n", CHECK_RESULT() == 0 ? "passed" : "FAILED");
+    return CHECK_RESULT();
+}
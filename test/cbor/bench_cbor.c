@@ -0,0 +1,443 @@
+/**
+ * \file
+ * \brief Benchmark of CBOR telemetry against JSON telemetry.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "cbor.h"
+#include "compress.h"
+#include "json.h"
+#include "jsonWriter.h"
+#include "bench.h"
+
+/*
+ * Usage: bench_cbor file.jsonl...
+ *
+ * Every line of a file is a JSON telemetry payload as published by the
+ * firmware. The samples are read back from it, then encoded again as JSON
+ * with JsonWriter and as CBOR with CborWriter, in the layouts of
+ * Device_SerializeData() and Device_SerializeDataCbor(). The CBOR values are
+ * decoded and compared with the samples at the decimals of each channel.
+ * Prints the sizes of JSON, compressed JSON and CBOR, and the encode times.
+ */
+
+/* Mirrors sensorTable in lib/device/sensors.c and the keys in device.h */
+#define BENCH_SENSORS 4
+#define BENCH_CHANNELS 3
+#define BENCH_STATISTICS 3
+
+#define BENCH_CBOR_KEY_SEQUENCE 5
+#define BENCH_CBOR_KEY_MIN 6
+#define BENCH_CBOR_KEY_MAX 7
+#define BENCH_CBOR_KEY_COUNT 8
+#define BENCH_CBOR_KEY_TIMESTAMP 9
+
+typedef struct
+{
+    const char *key;
+    const char *group; /* NULL for single channel sensors */
+    int64_t cborKey;
+    uint8_t channelCount;
+    const char *channels[BENCH_CHANNELS];
+    uint8_t decimals;
+} BenchSensor_t;
+
+static const BenchSensor_t benchSensors[BENCH_SENSORS] = {
+    {"pressure", NULL, 1, 1, {"pressure"}, 3},
+    {"humidity", NULL, 2, 1, {"humidity"}, 2},
+    {"temperature", NULL, 3, 1, {"temperature"}, 2},
+    {"acceleration", "acceleration", 4, 3, {"x", "y", "z"}, 3},
+};
+
+static const char *benchStatisticKeys[BENCH_STATISTICS] = {NULL, "min", "max"};
+static const int64_t benchStatisticCborKeys[BENCH_STATISTICS] = {0, BENCH_CBOR_KEY_MIN,
+                                                                 BENCH_CBOR_KEY_MAX};
+
+typedef struct
+{
+    uint32_t sensors; /* bit per entry of benchSensors */
+    bool statistics;
+    float values[BENCH_STATISTICS][BENCH_SENSORS][BENCH_CHANNELS];
+    int64_t counts[BENCH_SENSORS];
+    bool hasTimestamp, hasSequence;
+    int64_t timestamp, sequence;
+} BenchSample_t;
+
+static const json_value *Bench_member(const json_value *object, const char *key)
+{
+    if (object == NULL || object->type != json_object)
+    {
+        return NULL;
+    }
+    for (unsigned int i = 0; i < object->u.object.length; i++)
+    {
+        if (strcmp(object->u.object.values[i].name, key) == 0)
+        {
+            return object->u.object.values[i].value;
+        }
+    }
+    return NULL;
+}
+
+static float Bench_number(const json_value *value)
+{
+    if (value == NULL)
+    {
+        return NAN;
+    }
+    return (value->type == json_integer) ? (float)value->u.integer : (float)value->u.dbl;
+}
+
+static bool Bench_readSample(const char *line, BenchSample_t *sample)
+{
+    json_value *root = json_parse(line, strlen(line));
+    const json_value *member;
+
+    memset(sample, 0, sizeof(*sample));
+    if (root == NULL)
+    {
+        return false;
+    }
+    for (int s = 0; s < BENCH_STATISTICS; s++)
+    {
+        const json_value *object = (s == 0) ? root : Bench_member(root, benchStatisticKeys[s]);
+
+        sample->statistics = sample->statistics || ((s > 0) && (object != NULL));
+        for (int i = 0; (object != NULL) && (i < BENCH_SENSORS); i++)
+        {
+            const BenchSensor_t *sensor = &benchSensors[i];
+            const json_value *group = sensor->group ? Bench_member(object, sensor->group) : object;
+
+            if (Bench_member(object, sensor->key) == NULL)
+            {
+                continue;
+            }
+            sample->sensors |= (uint32_t)1 << i;
+            for (int c = 0; c < sensor->channelCount; c++)
+            {
+                sample->values[s][i][c] = Bench_number(Bench_member(group, sensor->channels[c]));
+            }
+        }
+    }
+    for (int i = 0; i < BENCH_SENSORS; i++)
+    {
+        member = Bench_member(Bench_member(root, "count"), benchSensors[i].key);
+        sample->counts[i] = (member != NULL) ? member->u.integer : 0;
+    }
+    if ((member = Bench_member(root, "ts")) != NULL)
+    {
+        sample->hasTimestamp = true;
+        sample->timestamp = member->u.integer;
+    }
+    if ((member = Bench_member(root, "seq")) != NULL)
+    {
+        sample->hasSequence = true;
+        sample->sequence = member->u.integer;
+    }
+    json_value_free(root);
+    return true;
+}
+
+static size_t Bench_encodeJson(const BenchSample_t *sample, char *buffer, size_t size)
+{
+    JsonWriter_t writer;
+
+    JsonWriter_init(&writer, buffer, size);
+    JsonWriter_beginObject(&writer, NULL);
+    for (int s = 0; s < (sample->statistics ? BENCH_STATISTICS : 1); s++)
+    {
+        if (s > 0)
+        {
+            JsonWriter_beginObject(&writer, benchStatisticKeys[s]);
+        }
+        for (int i = 0; i < BENCH_SENSORS; i++)
+        {
+            const BenchSensor_t *sensor = &benchSensors[i];
+
+            if ((sample->sensors & ((uint32_t)1 << i)) == 0)
+            {
+                continue;
+            }
+            if (sensor->group != NULL)
+            {
+                JsonWriter_beginObject(&writer, sensor->group);
+            }
+            for (int c = 0; c < sensor->channelCount; c++)
+            {
+                JsonWriter_float(&writer, sensor->channels[c], sample->values[s][i][c],
+                                 sensor->decimals);
+            }
+            if (sensor->group != NULL)
+            {
+                JsonWriter_endObject(&writer);
+            }
+        }
+        if (s > 0)
+        {
+            JsonWriter_endObject(&writer);
+        }
+    }
+    if (sample->statistics)
+    {
+        JsonWriter_beginObject(&writer, "count");
+        for (int i = 0; i < BENCH_SENSORS; i++)
+        {
+            if (sample->sensors & ((uint32_t)1 << i))
+            {
+                JsonWriter_integer(&writer, benchSensors[i].key, sample->counts[i]);
+            }
+        }
+        JsonWriter_endObject(&writer);
+    }
+    if (sample->hasTimestamp)
+    {
+        JsonWriter_integer(&writer, "ts", sample->timestamp);
+    }
+    if (sample->hasSequence)
+    {
+        JsonWriter_integer(&writer, "seq", sample->sequence);
+    }
+    JsonWriter_endObject(&writer);
+    return JsonWriter_finish(&writer);
+}
+
+static uint32_t Bench_sensorCount(uint32_t sensors)
+{
+    uint32_t count = 0;
+
+    for (; sensors != 0; sensors &= sensors - 1)
+    {
+        count++;
+    }
+    return count;
+}
+
+static size_t Bench_encodeCbor(const BenchSample_t *sample, uint8_t *buffer, size_t size)
+{
+    CborWriter_t writer;
+    uint32_t sensorCount = Bench_sensorCount(sample->sensors);
+
+    CborWriter_init(&writer, buffer, size);
+    CborWriter_map(&writer, sensorCount + (sample->hasSequence ? 1 : 0) +
+                                (sample->hasTimestamp ? 1 : 0) + (sample->statistics ? 3 : 0));
+    for (int s = 0; s < (sample->statistics ? BENCH_STATISTICS : 1); s++)
+    {
+        if (s > 0)
+        {
+            CborWriter_integer(&writer, benchStatisticCborKeys[s]);
+            CborWriter_map(&writer, sensorCount);
+        }
+        for (int i = 0; i < BENCH_SENSORS; i++)
+        {
+            const BenchSensor_t *sensor = &benchSensors[i];
+
+            if ((sample->sensors & ((uint32_t)1 << i)) == 0)
+            {
+                continue;
+            }
+            CborWriter_integer(&writer, sensor->cborKey);
+            if (sensor->channelCount > 1)
+            {
+                CborWriter_array(&writer, sensor->channelCount);
+            }
+            for (int c = 0; c < sensor->channelCount; c++)
+            {
+                CborWriter_float(&writer, sample->values[s][i][c], sensor->decimals);
+            }
+        }
+    }
+    if (sample->statistics)
+    {
+        CborWriter_integer(&writer, BENCH_CBOR_KEY_COUNT);
+        CborWriter_map(&writer, sensorCount);
+        for (int i = 0; i < BENCH_SENSORS; i++)
+        {
+            if (sample->sensors & ((uint32_t)1 << i))
+            {
+                CborWriter_integer(&writer, benchSensors[i].cborKey);
+                CborWriter_integer(&writer, sample->counts[i]);
+            }
+        }
+    }
+    if (sample->hasTimestamp)
+    {
+        CborWriter_integer(&writer, BENCH_CBOR_KEY_TIMESTAMP);
+        CborWriter_integer(&writer, sample->timestamp);
+    }
+    if (sample->hasSequence)
+    {
+        CborWriter_integer(&writer, BENCH_CBOR_KEY_SEQUENCE);
+        CborWriter_integer(&writer, sample->sequence);
+    }
+    return CborWriter_finish(&writer);
+}
+
+/* Reads the channel values of one statistic back, the map header is consumed */
+static bool Bench_checkCborChannels(CborReader_t *reader, const BenchSample_t *sample, int s,
+                                    uint32_t pairs)
+{
+    for (uint32_t p = 0; p < pairs; p++)
+    {
+        int64_t key;
+        uint32_t items;
+        const BenchSensor_t *sensor = NULL;
+        int i;
+
+        if (!CborReader_integer(reader, &key))
+        {
+            return false;
+        }
+        for (i = 0; i < BENCH_SENSORS; i++)
+        {
+            if (benchSensors[i].cborKey == key)
+            {
+                sensor = &benchSensors[i];
+                break;
+            }
+        }
+        if (sensor == NULL ||
+            (sensor->channelCount > 1 &&
+             (!CborReader_array(reader, &items) || items != sensor->channelCount)))
+        {
+            return false;
+        }
+        for (int c = 0; c < sensor->channelCount; c++)
+        {
+            float value;
+
+            if (!CborReader_float(reader, &value) ||
+                fabsf(value - sample->values[s][i][c]) >
+                    0.5f * powf(10.0f, -(float)sensor->decimals) + 1e-6f * fabsf(value))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static bool Bench_checkCbor(const uint8_t *data, size_t length, const BenchSample_t *sample)
+{
+    CborReader_t reader;
+    uint32_t pairs, sensorPairs = Bench_sensorCount(sample->sensors);
+
+    CborReader_init(&reader, data, length);
+    if (!CborReader_map(&reader, &pairs) || !Bench_checkCborChannels(&reader, sample, 0, sensorPairs))
+    {
+        return false;
+    }
+    for (int s = 1; sample->statistics && (s < BENCH_STATISTICS); s++)
+    {
+        int64_t key;
+        uint32_t statisticPairs;
+
+        if (!CborReader_integer(&reader, &key) || key != benchStatisticCborKeys[s] ||
+            !CborReader_map(&reader, &statisticPairs) ||
+            !Bench_checkCborChannels(&reader, sample, s, statisticPairs))
+        {
+            return false;
+        }
+    }
+    while (reader.position < reader.length)
+    {
+        if (!CborReader_skip(&reader))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    static char json[2048];
+    static uint8_t cbor[2048];
+    static uint8_t compressed[COMPRESS_BOUND(sizeof(json))];
+    int failures = 0;
+
+    printf("Payloads of compress/corpus are generated, sizes of captured telemetry may differ\n");
+    printf("%-28s %8s %8s %10s %6s %7s %10s %10s\n", "file", "payloads", "json", "compressed",
+           "cbor", "ratio", "json ns", "cbor ns");
+
+    for (int f = 1; f < argc; f++)
+    {
+        size_t length;
+        char *data = Bench_readFile(argv[f], &length);
+        const char *name = strrchr(argv[f], '/') ? strrchr(argv[f], '/') + 1 : argv[f];
+        unsigned long payloads = 0, jsonBytes = 0, compressedBytes = 0, cborBytes = 0;
+        uint64_t jsonTime = 0, cborTime = 0;
+
+        for (char *line = strtok(data, "\n"); line != NULL; line = strtok(NULL, "\n"))
+        {
+            BenchSample_t sample;
+            size_t jsonLength = 0, cborLength = 0;
+            uint16_t compressedLength = 0;
+            uint64_t start;
+
+            if (!Bench_readSample(line, &sample))
+            {
+                fprintf(stderr, "%s: payload %lu is not JSON\n", name, payloads + 1);
+                failures++;
+                continue;
+            }
+
+            start = Bench_now();
+            for (int r = 0; r < BENCH_REPETITIONS; r++)
+            {
+                jsonLength = Bench_encodeJson(&sample, json, sizeof(json));
+            }
+            jsonTime += Bench_now() - start;
+
+            start = Bench_now();
+            for (int r = 0; r < BENCH_REPETITIONS; r++)
+            {
+                cborLength = Bench_encodeCbor(&sample, cbor, sizeof(cbor));
+            }
+            cborTime += Bench_now() - start;
+
+            if (jsonLength == 0 || cborLength == 0 || !Bench_checkCbor(cbor, cborLength, &sample))
+            {
+                fprintf(stderr, "%s: payload %lu does not encode\n", name, payloads + 1);
+                failures++;
+            }
+            Compress_encode((const uint8_t *)json, (uint16_t)jsonLength, compressed,
+                            sizeof(compressed), &compressedLength);
+
+            payloads++;
+            jsonBytes += jsonLength;
+            compressedBytes += compressedLength;
+            cborBytes += cborLength;
+        }
+
+        if (payloads != 0)
+        {
+            printf("%-28s %8lu %8lu %10lu %6lu %6.1f%% %10.0f %10.0f\n", name, payloads, jsonBytes,
+                   compressedBytes, cborBytes, 100.0 * cborBytes / jsonBytes,
+                   (double)jsonTime / payloads / BENCH_REPETITIONS,
+                   (double)cborTime / payloads / BENCH_REPETITIONS);
+        }
+        free(data);
+    }
+    return failures == 0 ? 0 : 1;
+}
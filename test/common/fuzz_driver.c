@@ -0,0 +1,138 @@
+/**
+ * \file
+ * \brief Runs a libFuzzer harness without libFuzzer.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+/*
+ * Toolchains without libFuzzer (e.g. gcc) link the harnesses with this
+ * driver. It passes every file given on the command line to the harness,
+ * then FUZZ_MUTATIONS randomly mutated copies of each file. The environment
+ * variable of the same name overrides the default. Crashes are reported by
+ * the sanitizers the harness is built with.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FUZZ_MAX_INPUT 4096
+
+#ifndef FUZZ_MUTATIONS
+#define FUZZ_MUTATIONS 2000
+#endif
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+static uint32_t fuzzRandomState = 0x2545F491UL;
+
+static uint32_t FuzzDriver_random(void)
+{
+    /*xorshift32, the runs are reproducible*/
+    fuzzRandomState ^= fuzzRandomState << 13;
+    fuzzRandomState ^= fuzzRandomState >> 17;
+    fuzzRandomState ^= fuzzRandomState << 5;
+    return fuzzRandomState;
+}
+
+static size_t FuzzDriver_mutate(uint8_t *data, size_t size)
+{
+    static const char tokens[] = "{}[]\",:0123456789.eE+-tfnrul\\ ";
+    uint32_t edits = 1 + FuzzDriver_random() % 4;
+
+    for (uint32_t i = 0; i < edits; i++)
+    {
+        size_t position = (size > 0) ? FuzzDriver_random() % size : 0;
+        switch (FuzzDriver_random() % 4)
+        {
+        case 0: /* overwrite with a token character */
+            if (size > 0)
+            {
+                data[position] = (uint8_t)tokens[FuzzDriver_random() % (sizeof(tokens) - 1)];
+            }
+            break;
+        case 1: /* overwrite with a random byte */
+            if (size > 0)
+            {
+                data[position] = (uint8_t)FuzzDriver_random();
+            }
+            break;
+        case 2: /* truncate */
+            size = position;
+            break;
+        default: /* duplicate a byte */
+            if ((size > 0) && (size < FUZZ_MAX_INPUT))
+            {
+                memmove(&data[position + 1], &data[position], size - position);
+                size++;
+            }
+            break;
+        }
+    }
+    return size;
+}
+
+int main(int argc, char **argv)
+{
+    static uint8_t original[FUZZ_MAX_INPUT];
+    const char *mutationsVariable = getenv("FUZZ_MUTATIONS");
+    uint32_t mutations = FUZZ_MUTATIONS;
+
+    if (mutationsVariable != NULL)
+    {
+        mutations = (uint32_t)strtoul(mutationsVariable, NULL, 10);
+    }
+
+    for (int i = 1; i < argc; i++)
+    {
+        FILE *file = fopen(argv[i], "rb");
+        size_t size;
+
+        if (file == NULL)
+        {
+            printf("Cannot open %s\n", argv[i]);
+            return 1;
+        }
+        size = fread(original, 1, sizeof(original), file);
+        fclose(file);
+
+        for (uint32_t run = 0; run <= mutations; run++)
+        {
+            /*Exactly sized copies let ASan catch reads past the input*/
+            uint8_t *input = (uint8_t *)malloc(FUZZ_MAX_INPUT);
+            size_t inputSize = size;
+            uint8_t *exact;
+
+            memcpy(input, original, size);
+            if (run > 0)
+            {
+                inputSize = FuzzDriver_mutate(input, size);
+            }
+            exact = (uint8_t *)malloc(inputSize > 0 ? inputSize : 1);
+            memcpy(exact, input, inputSize);
+            LLVMFuzzerTestOneInput(exact, inputSize);
+            free(exact);
+            free(input);
+        }
+        printf("%s: %u inputs\n", argv[i], (unsigned int)mutations + 1);
+    }
+    return 0;
+}
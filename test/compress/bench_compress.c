@@ -0,0 +1,107 @@
+/**
+ * \file
+ * \brief Benchmark of the telemetry compression over recorded payloads.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#include <string.h>
+
+#include "compress.h"
+#include "bench.h"
+
+/*
+ * Usage: bench_compress file.jsonl...
+ *
+ * Every line of a file is one payload in the layout published by the
+ * firmware. Each is compressed, decompressed and compared with the original,
+ * then the sizes and the time per payload are printed per file. The payloads
+ * of compress/corpus are generated, not captured from a device.
+ */
+
+#define BENCH_MAX_PAYLOAD 2048
+
+int main(int argc, char **argv)
+{
+    static uint8_t compressed[COMPRESS_BOUND(BENCH_MAX_PAYLOAD)];
+    static uint8_t restored[BENCH_MAX_PAYLOAD];
+    int failures = 0;
+
+    printf("Payloads of compress/corpus are generated, ratios on captured telemetry may differ\n");
+    printf("%-28s %8s %10s %10s %7s %10s %10s\n", "file", "payloads", "bytes", "compressed",
+           "ratio", "encode ns", "decode ns");
+
+    for (int i = 1; i < argc; i++)
+    {
+        size_t length;
+        char *data = Bench_readFile(argv[i], &length);
+        const char *name = strrchr(argv[i], '/') ? strrchr(argv[i], '/') + 1 : argv[i];
+        unsigned long payloads = 0, bytes = 0, compressedBytes = 0;
+        uint64_t encodeTime = 0, decodeTime = 0;
+
+        for (char *line = strtok(data, "\n"); line != NULL; line = strtok(NULL, "\n"))
+        {
+            uint16_t lineLength = (uint16_t)strlen(line);
+            uint16_t compressedLength = 0, restoredLength = 0;
+            uint64_t start;
+
+            if (lineLength > BENCH_MAX_PAYLOAD)
+            {
+                fprintf(stderr, "%s: payload longer than %u bytes\n", name, BENCH_MAX_PAYLOAD);
+                return 1;
+            }
+
+            start = Bench_now();
+            for (int r = 0; r < BENCH_REPETITIONS; r++)
+            {
+                Compress_encode((const uint8_t *)line, lineLength, compressed, sizeof(compressed),
+                                &compressedLength);
+            }
+            encodeTime += Bench_now() - start;
+
+            start = Bench_now();
+            for (int r = 0; r < BENCH_REPETITIONS; r++)
+            {
+                Compress_decode(compressed, compressedLength, restored, sizeof(restored),
+                                &restoredLength);
+            }
+            decodeTime += Bench_now() - start;
+
+            if (restoredLength != lineLength || memcmp(restored, line, lineLength) != 0)
+            {
+                fprintf(stderr, "%s: payload %lu does not round trip\n", name, payloads + 1);
+                failures++;
+            }
+            payloads++;
+            bytes += lineLength;
+            compressedBytes += compressedLength;
+        }
+
+        if (payloads != 0)
+        {
+            printf("%-28s %8lu %10lu %10lu %6.1f%% %10.0f %10.0f\n", name, payloads, bytes,
+                   compressedBytes, 100.0 * compressedBytes / bytes,
+                   (double)encodeTime / payloads / BENCH_REPETITIONS,
+                   (double)decodeTime / payloads / BENCH_REPETITIONS);
+        }
+        free(data);
+    }
+    return failures == 0 ? 0 : 1;
+}
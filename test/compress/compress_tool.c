@@ -0,0 +1,80 @@
+/**
+ * \file
+ * \brief Host side compressor and decompressor of telemetry payloads.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "compress.h"
+
+/*
+ * Usage: compress_tool -d|-c < input > output
+ *
+ * -d restores the JSON of a compressed message as received from the broker,
+ *    e.g. mosquitto_sub -C 1 -t 'calypso/+/telemetry' | compress_tool -d
+ *    Messages that are not compressed are copied as they are.
+ * -c compresses a message the way the firmware does.
+ */
+
+/* Far above the firmware's payloads, compressed or not it fits the output */
+#define TOOL_MAX_MESSAGE 0x8000
+
+static uint8_t input[TOOL_MAX_MESSAGE + 1];
+static uint8_t output[0xFFFF];
+
+int main(int argc, char **argv)
+{
+    size_t inputLength;
+    uint16_t outputLength;
+    bool decompress;
+
+    if (argc != 2 || (strcmp(argv[1], "-d") != 0 && strcmp(argv[1], "-c") != 0))
+    {
+        fprintf(stderr, "usage: %s -d|-c < input > output\n", argv[0]);
+        return 2;
+    }
+    decompress = (argv[1][1] == 'd');
+
+    inputLength = fread(input, 1, sizeof(input), stdin);
+    if (inputLength > TOOL_MAX_MESSAGE)
+    {
+        fprintf(stderr, "Message longer than %u bytes\n", TOOL_MAX_MESSAGE);
+        return 1;
+    }
+
+    if (decompress && !Compress_isCompressed(input, (uint16_t)inputLength))
+    {
+        fwrite(input, 1, inputLength, stdout);
+        return 0;
+    }
+
+    if (decompress ? !Compress_decode(input, (uint16_t)inputLength, output, sizeof(output), &outputLength)
+                   : !Compress_encode(input, (uint16_t)inputLength, output, sizeof(output), &outputLength))
+    {
+        fprintf(stderr, "%s failed\n", decompress ? "Decompression" : "Compression");
+        return 1;
+    }
+    fwrite(output, 1, outputLength, stdout);
+    return 0;
+}
@@ -0,0 +1,142 @@
+/**
+ * \file
+ * \brief Benchmark of FixedFormat_float against printf.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "fixedFormat.h"
+#include "bench.h"
+
+/*
+ * Usage: bench_fixed_format
+ *
+ * Formats random values in the range of each quantity with
+ * FixedFormat_float(), snprintf("%.*f") and snprintf("%g"), and prints the
+ * time per value. Every FixedFormat_float() result is compared with
+ * "%.*f": the texts may only differ for values printf rounds the other
+ * way, i.e. by one unit of the last decimal.
+ */
+
+#define BENCH_VALUES 4096
+
+typedef struct
+{
+    const char *name;
+    float minimum, maximum;
+    uint8_t decimals;
+} BenchQuantity_t;
+
+/* Ranges of the sensors and decimals as in lib/device/sensors.h */
+static const BenchQuantity_t benchQuantities[] = {
+    {"pressure", 26.0f, 126.0f, 3},
+    {"temperature", -40.0f, 85.0f, 2},
+    {"humidity", 0.0f, 100.0f, 2},
+    {"acceleration", -16.0f, 16.0f, 3},
+    {"voltage", 3.0f, 4.2f, 2},
+};
+
+static uint32_t benchRandomState = 0x2545F491UL;
+
+static float Bench_random(float minimum, float maximum)
+{
+    benchRandomState ^= benchRandomState << 13;
+    benchRandomState ^= benchRandomState >> 17;
+    benchRandomState ^= benchRandomState << 5;
+    return minimum + (maximum - minimum) * (float)(benchRandomState >> 8) / (float)(1UL << 24);
+}
+
+int main(void)
+{
+    static float values[BENCH_VALUES];
+    char buffer[FIXEDFORMAT_BUFFER_SIZE], reference[64];
+    int failures = 0;
+
+    printf("%-14s %9s %9s %9s %9s\n", "quantity", "fixed ns", "%.*f ns", "%g ns", "differ");
+
+    for (size_t q = 0; q < sizeof(benchQuantities) / sizeof(benchQuantities[0]); q++)
+    {
+        const BenchQuantity_t *quantity = &benchQuantities[q];
+        uint64_t fixedTime, fixedPrintfTime, generalPrintfTime, start;
+        unsigned int differ = 0;
+
+        for (int i = 0; i < BENCH_VALUES; i++)
+        {
+            values[i] = Bench_random(quantity->minimum, quantity->maximum);
+        }
+
+        start = Bench_now();
+        for (int r = 0; r < BENCH_REPETITIONS; r++)
+        {
+            for (int i = 0; i < BENCH_VALUES; i++)
+            {
+                benchSink += FixedFormat_float(buffer, sizeof(buffer), values[i], quantity->decimals);
+            }
+        }
+        fixedTime = Bench_now() - start;
+
+        start = Bench_now();
+        for (int r = 0; r < BENCH_REPETITIONS; r++)
+        {
+            for (int i = 0; i < BENCH_VALUES; i++)
+            {
+                benchSink += snprintf(buffer, sizeof(buffer), "%.*f", quantity->decimals, values[i]);
+            }
+        }
+        fixedPrintfTime = Bench_now() - start;
+
+        start = Bench_now();
+        for (int r = 0; r < BENCH_REPETITIONS; r++)
+        {
+            for (int i = 0; i < BENCH_VALUES; i++)
+            {
+                benchSink += snprintf(buffer, sizeof(buffer), "%g", values[i]);
+            }
+        }
+        generalPrintfTime = Bench_now() - start;
+
+        for (int i = 0; i < BENCH_VALUES; i++)
+        {
+            FixedFormat_float(buffer, sizeof(buffer), values[i], quantity->decimals);
+            snprintf(reference, sizeof(reference), "%.*f", quantity->decimals, values[i]);
+            if (strcmp(buffer, reference) == 0)
+            {
+                continue;
+            }
+            differ++;
+            if (fabs(strtod(buffer, NULL) - strtod(reference, NULL)) >
+                1.0001 * pow(10.0, -quantity->decimals))
+            {
+                fprintf(stderr, "%s: %.9g gives %s, printf %s\n", quantity->name, values[i],
+                        buffer, reference);
+                failures++;
+            }
+        }
+
+        printf("%-14s %9.1f %9.1f %9.1f %9u\n", quantity->name,
+               (double)fixedTime / BENCH_VALUES / BENCH_REPETITIONS,
+               (double)fixedPrintfTime / BENCH_VALUES / BENCH_REPETITIONS,
+               (double)generalPrintfTime / BENCH_VALUES / BENCH_REPETITIONS, differ);
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,49 @@
+/**
+ * \file
+ * \brief Minimal program to compare the flash size of FixedFormat_float and float printf.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#include <stdio.h>
+
+#include "fixedFormat.h"
+
+/*
+ * Built twice for the Cortex-M0+ by "make size": once formatting with
+ * FixedFormat_float(), once with "%.*f" and newlib's float printf support
+ * (-u _printf_float), as the firmware did before. Both variants use
+ * snprintf for integers like the firmware's debug output, so the
+ * difference of the two sizes is what dropping the float printf saves.
+ */
+
+volatile float sizeValue = 23.456f;
+char sizeBuffer[FIXEDFORMAT_BUFFER_SIZE + 16];
+
+int main(void)
+{
+    snprintf(sizeBuffer, sizeof(sizeBuffer), "%d", (int)sizeValue);
+#if SIZE_FLOAT_PRINTF
+    snprintf(sizeBuffer, sizeof(sizeBuffer), "%.*f", 3, sizeValue);
+#else
+    FixedFormat_float(sizeBuffer, sizeof(sizeBuffer), sizeValue, 3);
+#endif
+    return 0;
+}
@@ -0,0 +1,110 @@
+/**
+ * \file
+ * \brief Benchmark of the SAX parser against the tree parser.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#include <string.h>
+
+#include "json.h"
+#include "arena.h"
+#include "bench.h"
+
+/*
+ * Usage: bench_json file.json...
+ *
+ * Parses every file with json_parse_ex into an arena, as the firmware does,
+ * and with json_parse_sax. Prints the time per parse and the memory each
+ * needs: the arena's high water mark for the tree, the parser state on the
+ * stack for SAX.
+ */
+
+static int Bench_saxEvent(void *user_data)
+{
+    (*(uint32_t *)user_data)++;
+    return 1;
+}
+
+static int Bench_saxKey(void *user_data, const json_char *name, unsigned int length)
+{
+    (void)name;
+    (void)length;
+    return Bench_saxEvent(user_data);
+}
+
+static int Bench_saxValue(void *user_data, const json_value *value)
+{
+    (void)value;
+    return Bench_saxEvent(user_data);
+}
+
+int main(int argc, char **argv)
+{
+    static const json_sax_handler handler = {Bench_saxEvent, Bench_saxEvent, Bench_saxEvent,
+                                             Bench_saxEvent, Bench_saxKey, Bench_saxValue};
+    static uint64_t memory[65536 / sizeof(uint64_t)];
+    int failures = 0;
+
+    printf("%-24s %6s %10s %10s %10s %8s\n", "file", "bytes", "tree ns", "arena", "sax ns",
+           "events");
+
+    for (int i = 1; i < argc; i++)
+    {
+        size_t length;
+        char *data = Bench_readFile(argv[i], &length);
+        const char *name = strrchr(argv[i], '/') ? strrchr(argv[i], '/') + 1 : argv[i];
+        Arena_t arena;
+        json_settings settings = {0, 0, Arena_jsonAlloc, Arena_jsonFree, &arena, 0};
+        uint64_t treeTime, saxTime, start;
+        uint32_t events = 0;
+        bool parsed = true;
+
+        Arena_init(&arena, memory, sizeof(memory));
+        start = Bench_now();
+        for (int r = 0; r < BENCH_REPETITIONS; r++)
+        {
+            Arena_reset(&arena);
+            parsed = parsed && (json_parse_ex(&settings, data, length, NULL) != NULL);
+        }
+        treeTime = Bench_now() - start;
+
+        start = Bench_now();
+        for (int r = 0; r < BENCH_REPETITIONS; r++)
+        {
+            events = 0;
+            parsed = parsed && json_parse_sax(&handler, &events, data, length, NULL);
+        }
+        saxTime = Bench_now() - start;
+
+        if (!parsed)
+        {
+            fprintf(stderr, "%s: not parsed\n", name);
+            failures++;
+        }
+        printf("%-24s %6zu %10.0f %10zu %10.0f %8u\n", name, length,
+               (double)treeTime / BENCH_REPETITIONS, arena.highWaterMark,
+               (double)saxTime / BENCH_REPETITIONS, events);
+        free(data);
+    }
+    printf("SAX parser state: %u bytes of string buffer on the stack (JSON_SAX_STRING_MAX)\n",
+           JSON_SAX_STRING_MAX);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,147 @@
+/**
+ * \file
+ * \brief Fuzz harness of the JSON parsers.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "json.h"
+#include "arena.h"
+
+/*
+ * Runs every input through the tree parser with malloc, with an arena of the
+ * firmware's size and with an allocator that fails part way, and through the
+ * SAX parser. Leaked blocks and mismatched SAX events abort, so does a
+ * document the SAX parser accepts and the tree parser rejects: both use the
+ * same scanners, SAX only has tighter limits.
+ */
+
+typedef struct
+{
+    int remaining;
+    int outstanding;
+} FuzzAllocator_t;
+
+static void *FuzzAllocator_alloc(size_t size, int zero, void *user_data)
+{
+    FuzzAllocator_t *allocator = (FuzzAllocator_t *)user_data;
+    void *block;
+
+    if (allocator->remaining == 0)
+    {
+        return NULL;
+    }
+    allocator->remaining--;
+    block = zero ? calloc(1, size) : malloc(size);
+    if (block != NULL)
+    {
+        allocator->outstanding++;
+    }
+    return block;
+}
+
+static void FuzzAllocator_free(void *ptr, void *user_data)
+{
+    FuzzAllocator_t *allocator = (FuzzAllocator_t *)user_data;
+
+    if (ptr != NULL)
+    {
+        allocator->outstanding--;
+    }
+    free(ptr);
+}
+
+static int Fuzz_saxOpen(void *user_data)
+{
+    (*(int *)user_data)++;
+    return 1;
+}
+
+static int Fuzz_saxClose(void *user_data)
+{
+    (*(int *)user_data)--;
+    return *(int *)user_data >= 0;
+}
+
+static int Fuzz_saxKey(void *user_data, const json_char *name, unsigned int length)
+{
+    (void)user_data;
+    return name[length] == 0;
+}
+
+static int Fuzz_saxValue(void *user_data, const json_value *value)
+{
+    (void)user_data;
+    return (value->type != json_string) || (value->u.string.ptr[value->u.string.length] == 0);
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    static uint64_t memory[2048 / sizeof(uint64_t)];
+    const json_char *json = (const json_char *)data;
+    json_char error[json_error_max];
+    json_value *value;
+    bool treeParsed;
+
+    /* malloc */
+    value = json_parse(json, size);
+    treeParsed = (value != NULL);
+    json_value_free(value);
+
+    /* Arena as in the firmware */
+    {
+        Arena_t arena;
+        json_settings settings = {0, 0, Arena_jsonAlloc, Arena_jsonFree, &arena, 0};
+
+        Arena_init(&arena, memory, sizeof(memory));
+        value = json_parse_ex(&settings, json, size, error);
+        json_value_free_ex(&settings, value);
+    }
+
+    /* Allocation failure after a number of blocks picked by the input */
+    {
+        FuzzAllocator_t allocator = {(int)(size % 32), 0};
+        json_settings settings = {0, 0, FuzzAllocator_alloc, FuzzAllocator_free, &allocator, 0};
+
+        value = json_parse_ex(&settings, json, size, error);
+        json_value_free_ex(&settings, value);
+        if (allocator.outstanding != 0)
+        {
+            abort();
+        }
+    }
+
+    /* SAX, containers must balance when the document is accepted */
+    {
+        static const json_sax_handler handler = {Fuzz_saxOpen, Fuzz_saxClose, Fuzz_saxOpen,
+                                                 Fuzz_saxClose, Fuzz_saxKey, Fuzz_saxValue};
+        int depth = 0;
+
+        if (json_parse_sax(&handler, &depth, json, size, error) && ((depth != 0) || !treeParsed))
+        {
+            abort();
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,88 @@
+/**
+ * \file
+ * \brief Fuzz harness of the JSON serializer.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "json.h"
+#include "json-builder.h"
+
+/*
+ * Every accepted input is serialized into a buffer of the measured size. The
+ * output must fit, parse again and serialize to the same text.
+ */
+
+static char *Fuzz_serialize(json_value *value, json_serialize_opts opts)
+{
+    size_t size = json_measure_ex(value, opts);
+    char *text = (char *)malloc(size);
+
+    json_serialize_ex(text, value, opts);
+    if (strlen(text) >= size)
+    {
+        abort();
+    }
+    return text;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    static const json_serialize_opts modes[] = {
+        {json_serialize_mode_packed, 0, 0},
+        {json_serialize_mode_single_line, 0, 0},
+        {json_serialize_mode_multiline, json_serialize_opt_use_tabs, 1},
+    };
+    json_settings settings = {0};
+    json_value *value;
+
+    settings.value_extra = json_builder_extra;
+    value = json_parse_ex(&settings, (const json_char *)data, size, NULL);
+    if (value == NULL)
+    {
+        return 0;
+    }
+
+    for (size_t i = 0; i < sizeof(modes) / sizeof(modes[0]); i++)
+    {
+        char *text = Fuzz_serialize(value, modes[i]);
+        json_value *reparsed = json_parse_ex(&settings, text, strlen(text), NULL);
+        char *again;
+
+        if (reparsed == NULL)
+        {
+            abort();
+        }
+        again = Fuzz_serialize(reparsed, modes[i]);
+        if (strcmp(text, again) != 0)
+        {
+            abort();
+        }
+        free(again);
+        free(text);
+        json_value_free(reparsed);
+    }
+    json_value_free(value);
+    return 0;
+}
@@ -0,0 +1,191 @@
+/**
+ * \file
+ * \brief Regression tests of the JSON parser and serializer.
+ * 
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "json.h"
+#include "json-builder.h"
+#include "arena.h"
+#include "check.h"
+
+/* Allocator that fails after a number of allocations and counts the blocks
+ * still allocated */
+typedef struct
+{
+    int remaining;
+    int outstanding;
+} TestAllocator_t;
+
+static void *TestAllocator_alloc(size_t size, int zero, void *user_data)
+{
+    TestAllocator_t *allocator = (TestAllocator_t *)user_data;
+    void *block;
+
+    if (allocator->remaining == 0)
+    {
+        return NULL;
+    }
+    allocator->remaining--;
+    block = zero ? calloc(1, size) : malloc(size);
+    if (block != NULL)
+    {
+        allocator->outstanding++;
+    }
+    return block;
+}
+
+static void TestAllocator_free(void *ptr, void *user_data)
+{
+    TestAllocator_t *allocator = (TestAllocator_t *)user_data;
+
+    if (ptr != NULL)
+    {
+        allocator->outstanding--;
+    }
+    free(ptr);
+}
+
+/* Parse a copy without terminator, so that ASan sees reads past the end */
+static json_value *Test_parseExact(const char *text)
+{
+    size_t length = strlen(text);
+    char *copy = (char *)malloc(length);
+    json_value *value;
+
+    memcpy(copy, text, length);
+    value = json_parse(copy, length);
+    free(copy);
+    return value;
+}
+
+/* true, false and null at the very end of the input were read one byte past it */
+static void Test_literalAtEnd(void)
+{
+    static const struct
+    {
+        const char *text;
+        json_type type;
+    } literals[] = {{"true", json_boolean}, {"false", json_boolean}, {"null", json_null}};
+    static const char *truncated[] = {"tru", "fals", "nul", "[true", "{\"a\":nul"};
+
+    for (size_t i = 0; i < sizeof(literals) / sizeof(literals[0]); i++)
+    {
+        json_value *value = Test_parseExact(literals[i].text);
+        CHECK((value != NULL) && (value->type == literals[i].type));
+        json_value_free(value);
+    }
+    for (size_t i = 0; i < sizeof(truncated) / sizeof(truncated[0]); i++)
+    {
+        json_value *value = Test_parseExact(truncated[i]);
+        CHECK(value == NULL);
+        json_value_free(value);
+    }
+}
+
+/* An allocation failure in the second pass left a bogus array or object length
+ * that json_value_free_ex walked */
+static void Test_arenaExhausted(void)
+{
+    static const char document[] =
+        "{\"desired\":{\"telemetrySendFrequency\":10,\"leds\":[1,2,[3,4],{\"x\":\"y\"}],"
+        "\"$version\":7},\"reported\":{\"name\":\"calypso\",\"list\":[\"a\",\"b\",\"c\"]}}";
+    static uint64_t memory[512];
+    bool parsedOnce = false;
+
+    for (size_t size = 0; size <= sizeof(memory); size += 8)
+    {
+        Arena_t arena;
+        json_settings settings = {0, 0, Arena_jsonAlloc, Arena_jsonFree, &arena, 0};
+        json_value *value;
+
+        Arena_init(&arena, memory, size);
+        value = json_parse_ex(&settings, document, sizeof(document) - 1, NULL);
+        if (value != NULL)
+        {
+            parsedOnce = true;
+            CHECK(value->type == json_object);
+        }
+        json_value_free_ex(&settings, value);
+    }
+    CHECK(parsedOnce);
+}
+
+/* Values still being parsed when the second pass failed were leaked */
+static void Test_allocationFailureLeaks(void)
+{
+    static const char document[] =
+        "{\"a\":[1,{\"b\":\"text\",\"c\":[true,false,null]},2.5],\"d\":{\"e\":{\"f\":[]}}}";
+    bool parsedOnce = false;
+
+    for (int budget = 0; budget < 64; budget++)
+    {
+        TestAllocator_t allocator = {budget, 0};
+        json_settings settings = {0, 0, TestAllocator_alloc, TestAllocator_free, &allocator, 0};
+        json_value *value = json_parse_ex(&settings, document, sizeof(document) - 1, NULL);
+
+        parsedOnce = parsedOnce || (value != NULL);
+        json_value_free_ex(&settings, value);
+        CHECK(allocator.outstanding == 0);
+    }
+    CHECK(parsedOnce);
+}
+
+/* Infinite and NaN doubles were serialized as "inf.0" */
+static void Test_serializeInfinity(void)
+{
+    static const char document[] = "[1e999,-1e999,1.5]";
+    json_settings settings = {0};
+    json_serialize_opts opts = {json_serialize_mode_packed, 0, 0};
+    json_value *value;
+
+    settings.value_extra = json_builder_extra;
+    value = json_parse_ex(&settings, document, sizeof(document) - 1, NULL);
+    CHECK(value != NULL);
+    if (value != NULL)
+    {
+        size_t size = json_measure_ex(value, opts);
+        char *text = (char *)malloc(size);
+        json_value *reparsed;
+
+        json_serialize_ex(text, value, opts);
+        CHECK(strcmp(text, "[null,null,1.5]") == 0);
+        CHECK(strlen(text) < size);
+        reparsed = json_parse(text, strlen(text));
+        CHECK(reparsed != NULL);
+        json_value_free(reparsed);
+        free(text);
+        json_value_free(value);
+    }
+}
+
+int main(void)
+{
+    Test_literalAtEnd();
+    Test_arenaExhausted();
+    Test_allocationFailureLeaks();
+    Test_serializeInfinity();
+    printf("test_json: %s\n", CHECK_RESULT() == 0 ? "passed" : "FAILED");
+    return CHECK_RESULT();
+}